@@ -0,0 +1,365 @@
+// Микробенчмарки горячих путей обучения и предсказания.
+// Каждое измерение: прогрев, подбор числа итераций под минимальное время
+// серии, затем несколько серий; в результат идут среднее, отклонение
+// и минимум нс/операцию по сериям и строки в секунду.
+// Результаты — JSON lines (одна строка на измерение); те же измерения
+// дописываются в историю результатов для режима сравнения ревизий.
+// В сборке с COUNT_ALLOCATIONS добавляется число выделений на операцию,
+// а измерения с бюджетом выделений (пакетное предсказание — ноль)
+// при его превышении завершают программу с ошибкой.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <algorithm>
+#include <functional>
+
+#include "Dataset.h"
+#include "EncodedDataset.h"
+#include "CompiledTree.h"
+#include "ID3.h"
+#include "C45.h"
+#include "CART.h"
+#include "CHAID.h"
+#include "ExtraTree.h"
+#include "DataGenerator.h"
+#include "AllocationCounter.h"
+#include "ResultHistory.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+namespace {
+
+// Открывает защищенные шаги построения дерева для измерения по отдельности
+template <typename Tree>
+class Exposed : public Tree {
+public:
+    using Tree::findBestSplit;
+    using Tree::buildTreeRecursive;
+};
+
+// Результат, который оптимизатор не может выбросить
+volatile size_t sink = 0;
+
+// Сообщения библиотеки в stdout (например, о загрузке CSV) на время
+// вызова отбрасываются: cout без буфера ничего не пишет, прежний буфер
+// и состояние потока восстанавливаются в деструкторе
+class QuietStdout {
+public:
+    QuietStdout() : saved(cout.rdbuf(nullptr)) {}
+    ~QuietStdout() { cout.rdbuf(saved); }
+    QuietStdout(const QuietStdout&) = delete;
+    QuietStdout& operator=(const QuietStdout&) = delete;
+
+private:
+    streambuf* saved;
+};
+
+struct BenchmarkOptions {
+    vector<size_t> sizes = {1000, 10000, 100000};
+    int repetitions = 5;
+    double minSeriesTime = 0.05;      // секунд на серию
+    double warmupTime = 0.02;
+    string outputPath = "benchmark_results.jsonl";
+    string historyPath = "output/history.jsonl";  // пусто — без записи в историю
+    string filter;                    // подстрока имени измерения
+};
+
+struct BenchmarkResult {
+    string name;
+    size_t rows = 0;                  // размер набора
+    size_t rowsPerOp = 0;             // строк, обрабатываемых одной операцией
+    size_t iterations = 0;            // операций в серии
+    int repetitions = 0;
+    double meanNs = 0.0;              // нс/операцию
+    double stddevNs = 0.0;
+    double minNs = 0.0;
+    double rowsPerSecond = 0.0;
+    double allocationsPerOp = 0.0;    // только в сборке с подсчетом выделений
+};
+
+string jsonEscape(const string& text) {
+    string result;
+    for (char c : text) {
+        if (c == '"' || c == '\\') result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(const BenchmarkOptions& options, ostream& output)
+        : options(options), output(output) {}
+
+    // fn выполняет одну операцию и возвращает значение для sink;
+    // maxAllocationsPerOp >= 0 — бюджет выделений на операцию
+    void run(const string& name, size_t rows, size_t rowsPerOp, const function<size_t()>& fn,
+             double maxAllocationsPerOp = -1.0) {
+        if (!options.filter.empty() && name.find(options.filter) == string::npos) return;
+
+        // Прогрев и оценка времени одной операции
+        size_t warmupOps = 0;
+        auto warmupStart = Clock::now();
+        double elapsed = 0.0;
+        do {
+            sink = sink + fn();
+            warmupOps++;
+            elapsed = chrono::duration<double>(Clock::now() - warmupStart).count();
+        } while (elapsed < options.warmupTime);
+
+        double perOp = elapsed / warmupOps;
+        size_t iterations = max<size_t>(1, static_cast<size_t>(ceil(options.minSeriesTime / max(perOp, 1e-9))));
+
+        vector<double> samples;
+        samples.reserve(options.repetitions);  // вне подсчета выделений серии
+        AllocationStats allocationsBefore = AllocationCounter::total();
+        for (int rep = 0; rep < options.repetitions; ++rep) {
+            auto start = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) sink = sink + fn();
+            double seconds = chrono::duration<double>(Clock::now() - start).count();
+            samples.push_back(seconds * 1e9 / iterations);
+        }
+
+        AllocationStats allocationsAfter = AllocationCounter::total();
+        
+        BenchmarkResult result;
+        result.name = name;
+        result.rows = rows;
+        result.rowsPerOp = rowsPerOp;
+        result.iterations = iterations;
+        result.repetitions = options.repetitions;
+        for (double sample : samples) result.meanNs += sample;
+        result.meanNs /= samples.size();
+        for (double sample : samples) result.stddevNs += (sample - result.meanNs) * (sample - result.meanNs);
+        result.stddevNs = samples.size() > 1 ? sqrt(result.stddevNs / (samples.size() - 1)) : 0.0;
+        result.minNs = *min_element(samples.begin(), samples.end());
+        result.rowsPerSecond = result.meanNs > 0.0 ? rowsPerOp * 1e9 / result.meanNs : 0.0;
+        result.allocationsPerOp = static_cast<double>(allocationsAfter.count - allocationsBefore.count) /
+                                  (static_cast<double>(iterations) * options.repetitions);
+        report(result);
+        
+        HistoryRecord record;
+        record.source = "benchmark";
+        record.name = name;
+        record.dataset = dataset;
+        record.rows = rows;
+        record.timeMean = result.meanNs * 1e-9;
+        record.timeStd = result.stddevNs * 1e-9;
+        record.timeSamples = static_cast<size_t>(options.repetitions);
+        history.push_back(record);
+        
+        if (AllocationCounter::isAvailable() && maxAllocationsPerOp >= 0.0 &&
+            result.allocationsPerOp > maxAllocationsPerOp) {
+            cerr << "  Превышен бюджет выделений: " << name << " — " << result.allocationsPerOp
+                 << " на операцию при допустимых " << maxAllocationsPerOp << endl;
+            budgetExceeded = true;
+        }
+    }
+    
+    bool isBudgetExceeded() const { return budgetExceeded; }
+    
+    // Отпечаток набора, к которому относятся следующие измерения
+    void setDataset(const string& fingerprint) { dataset = fingerprint; }
+    const vector<HistoryRecord>& getHistory() const { return history; }
+
+private:
+    const BenchmarkOptions& options;
+    ostream& output;
+    bool budgetExceeded = false;
+    string dataset;
+    vector<HistoryRecord> history;
+
+    void report(const BenchmarkResult& result) {
+        output << "{\"benchmark\":\"" << jsonEscape(result.name) << "\""
+               << ",\"rows\":" << result.rows
+               << ",\"rows_per_op\":" << result.rowsPerOp
+               << ",\"iterations\":" << result.iterations
+               << ",\"repetitions\":" << result.repetitions
+               << ",\"ns_per_op\":" << result.meanNs
+               << ",\"ns_per_op_stddev\":" << result.stddevNs
+               << ",\"ns_per_op_min\":" << result.minNs
+               << ",\"rows_per_s\":" << result.rowsPerSecond;
+        if (AllocationCounter::isAvailable()) {
+            output << ",\"allocs_per_op\":" << result.allocationsPerOp;
+        }
+        output << "}\n";
+        output.flush();
+
+        cerr << "  " << result.name << " [" << result.rows << "]: "
+             << result.meanNs << " нс/оп ± " << result.stddevNs
+             << ", " << result.rowsPerSecond << " строк/с";
+        if (AllocationCounter::isAvailable()) cerr << ", " << result.allocationsPerOp << " выделений/оп";
+        cerr << endl;
+    }
+};
+
+template <typename Tree>
+void benchmarkTree(BenchmarkRunner& runner, const string& algorithm, const Dataset& data,
+                   const EncodedDataset& encoded) {
+    size_t rows = data.getExamples().size();
+    const auto& examples = data.getExamples();
+    const auto& features = data.getFeatureNames();
+
+    Exposed<Tree> tree;
+    runner.run("findBestSplit/" + algorithm, rows, rows, [&]() {
+        return tree.findBestSplit(examples, features).first.size();
+    });
+    runner.run("buildTreeRecursive/" + algorithm, rows, rows, [&]() {
+        return static_cast<size_t>(tree.buildTreeRecursive(examples, features, 0)->samples);
+    });
+    runner.run("trainEncoded/" + algorithm, rows, rows, [&]() {
+        tree.trainEncoded(encoded);
+        return static_cast<size_t>(tree.getRoot()->samples);
+    });
+
+    // Предсказания и экспорт — по дереву, обученному на всех строках
+    tree.trainEncoded(encoded);
+    size_t next = 0;
+    runner.run("predict/" + algorithm, rows, 1, [&]() {
+        const DataExample& example = examples[next];
+        next = next + 1 == rows ? 0 : next + 1;
+        return tree.predict(example).size();
+    });
+
+    CompiledTree compiled(tree, encoded);
+    vector<EncodedDataset::Code> predictions(rows);
+    runner.run("predictBatch/" + algorithm, rows, rows, [&]() {
+        compiled.predictBatch(encoded, 0, rows, predictions.data());
+        return static_cast<size_t>(predictions[rows / 2]);
+    }, 0.0);
+
+    string dotPath = "bench_" + algorithm + ".dot";
+    runner.run("saveToDot/" + algorithm, rows, 1, [&]() {
+        tree.saveToDot(dotPath);
+        return size_t{1};
+    });
+    remove(dotPath.c_str());
+
+    string jsonPath = "bench_" + algorithm + ".json";
+    runner.run("saveToJSON/" + algorithm, rows, 1, [&]() {
+        tree.saveToJSON(jsonPath);
+        return size_t{1};
+    });
+    remove(jsonPath.c_str());
+}
+
+vector<size_t> parseSizes(const string& text) {
+    vector<size_t> sizes;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) sizes.push_back(static_cast<size_t>(atoll(item.c_str())));
+    }
+    return sizes;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue) options.sizes = parseSizes(argv[++i]);
+        else if (arg == "--repetitions" && hasValue) options.repetitions = max(1, atoi(argv[++i]));
+        else if (arg == "--min-time" && hasValue) options.minSeriesTime = atof(argv[++i]);
+        else if (arg == "--output" && hasValue) options.outputPath = argv[++i];
+        else if (arg == "--filter" && hasValue) options.filter = argv[++i];
+        else if (arg == "--history" && hasValue) options.historyPath = argv[++i];
+        else {
+            cerr << "Использование: " << argv[0]
+                 << " [--sizes 1000,10000] [--repetitions N] [--min-time сек]"
+                 << " [--output файл.jsonl] [--filter подстрока] [--history файл.jsonl | \"\"]" << endl;
+            return 1;
+        }
+    }
+
+    ofstream output(options.outputPath);
+    if (!output.is_open()) {
+        cerr << "Ошибка открытия файла результатов: " << options.outputPath << endl;
+        return 1;
+    }
+
+    // Синтетические данные с заложенным деревом, записанные в CSV,
+    // чтобы измерять и загрузку
+    DataGenerator generator(GeneratorSchema::makeDefault(), 42);
+    const string& target = generator.getSchema().targetName;
+    vector<string> features;
+    for (const auto& feature : generator.getSchema().features) features.push_back(feature.name);
+
+    BenchmarkRunner runner(options, output);
+    for (size_t rows : options.sizes) {
+        cerr << "Набор из " << rows << " строк" << endl;
+        EncodedDataset generated = generator.generate(rows);
+        
+        // Генерация с тем же зерном дает тот же набор: отпечаток один для всех запусков
+        stringstream fingerprint;
+        fingerprint << hex << setw(16) << setfill('0') << generated.fingerprint();
+        runner.setDataset(fingerprint.str());
+        
+        runner.run("generate", rows, rows, [&]() {
+            return generator.generate(rows).getRowCount();
+        });
+
+        string csvPath = "bench_" + to_string(rows) + ".csv";
+        DataGenerator::writeCSV(generated, csvPath);
+
+        {
+            QuietStdout quiet;
+            runner.run("loadFromCSV", rows, rows, [&]() {
+                Dataset loaded;
+                loaded.loadFromCSV(csvPath, features, target);
+                return loaded.getExamples().size();
+            });
+        }
+
+        Dataset data;
+        {
+            QuietStdout quiet;
+            data.loadFromCSV(csvPath, features, target);
+        }
+        runner.run("split", rows, rows, [&]() {
+            return data.split(0.7, 42).first.getExamples().size();
+        });
+
+        runner.run("encode", rows, rows, [&]() {
+            return EncodedDataset(data).getRowCount();
+        });
+        EncodedDataset encoded(data);
+
+        benchmarkTree<ID3Tree>(runner, "ID3", data, encoded);
+        benchmarkTree<C45Tree>(runner, "C4.5", data, encoded);
+        benchmarkTree<CARTTree>(runner, "CART", data, encoded);
+        benchmarkTree<CHAIDTree>(runner, "CHAID", data, encoded);
+        benchmarkTree<ExtraTree>(runner, "ExtraTrees", data, encoded);
+
+        remove(csvPath.c_str());
+    }
+
+    cerr << "Результаты сохранены: " << options.outputPath << endl;
+    
+    if (!options.historyPath.empty()) {
+        // Одна ревизия и один запуск на все записи
+        vector<HistoryRecord> records = runner.getHistory();
+        string run = ResultHistory::newRunId();
+        string revision = ResultHistory::currentRevision();
+        for (auto& record : records) {
+            record.run = run;
+            record.revision = revision;
+        }
+        if (ResultHistory(options.historyPath).append(records)) {
+            cerr << "История результатов дополнена: " << options.historyPath << endl;
+        }
+    }
+    return runner.isBudgetExceeded() ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Фазы, по которым распределяются выделения памяти
+enum class AllocationPhase : size_t {
+    Other,        // вне размеченных фаз
+    Train,        // обучение модели
+    Predict,      // предсказание
+    Evaluate,     // расчет метрик
+    Export        // экспорт дерева (DOT)
+};
+
+constexpr size_t kAllocationPhaseCount = 5;
+
+struct AllocationStats {
+    std::uint64_t count = 0;     // вызовов operator new
+    std::uint64_t bytes = 0;     // запрошенных байтов
+};
+
+using AllocationSnapshot = std::array<AllocationStats, kAllocationPhaseCount>;
+
+// Подсчет выделений через замену глобальных operator new/delete.
+// Включается опцией сборки COUNT_ALLOCATIONS (макрос DT_COUNT_ALLOCATIONS);
+// без нее замены нет, а все счетчики остаются нулевыми.
+// Текущая фаза общая для процесса: выделения рабочих потоков
+// относятся к фазе, которую установил управляющий поток.
+class AllocationCounter {
+public:
+    static constexpr bool isAvailable() {
+#ifdef DT_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static AllocationSnapshot snapshot();
+    static AllocationStats total();               // сумма по фазам
+
+    // Разность снимков по фазам: after − before
+    static AllocationSnapshot difference(const AllocationSnapshot& after,
+                                         const AllocationSnapshot& before);
+
+    static AllocationPhase getPhase();
+    static void setPhase(AllocationPhase phase);
+
+    static const char* phaseName(AllocationPhase phase);
+};
+
+// Установка фазы на время жизни объекта (с восстановлением предыдущей)
+class AllocationScope {
+public:
+    explicit AllocationScope(AllocationPhase phase) : previous(AllocationCounter::getPhase()) {
+        AllocationCounter::setPhase(phase);
+    }
+    ~AllocationScope() { AllocationCounter::setPhase(previous); }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    AllocationPhase previous;
+};
+
+#endif // ALLOCATION_COUNTER_H
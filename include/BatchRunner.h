@@ -0,0 +1,51 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "ExperimentManifest.h"
+#include "ReportGenerator.h"
+#include <string>
+#include <vector>
+
+// Результат одного задания пакета
+struct BatchJobResult {
+    ExperimentJob job;
+    AlgorithmResult result;            // algorithmName — метка задания
+    size_t trainRows = 0;
+    size_t testRows = 0;
+    size_t trainDistinct = 0;          // строк обучающей выборки после сжатия повторов
+    bool succeeded = false;
+    std::string error;
+};
+
+// Пакетный запуск экспериментов манифеста. Задания выполняет
+// ограниченный пул рабочих потоков (каждое задание однопоточное).
+// Набор данных загружается один раз — первым заданием, которому он нужен, —
+// и разделяется остальными его заданиями; после последнего задания набора
+// по нему пишется HTML-отчет, и набор выгружается. Новый набор начинает
+// загружаться, только если оценка его памяти помещается в лимит вместе
+// с уже загруженными (или если загруженных нет), поэтому большие наборы
+// не оказываются в памяти одновременно. Результаты пишутся в JSON lines
+// по мере завершения заданий.
+class BatchRunner {
+public:
+    explicit BatchRunner(const ExperimentManifest& manifest);
+
+    // false — не удалось открыть вывод или хотя бы одно задание не выполнено
+    bool run();
+
+    // В порядке номеров заданий
+    const std::vector<BatchJobResult>& getResults() const { return results; }
+
+    size_t getDatasetLoads() const { return datasetLoads; }
+    size_t getPeakLoadedBytes() const { return peakLoadedBytes; }  // наибольший объем загруженных наборов
+
+    static std::string toJSON(const BatchJobResult& result, const std::string& datasetName);
+
+private:
+    const ExperimentManifest& manifest;
+    std::vector<BatchJobResult> results;
+    size_t datasetLoads = 0;
+    size_t peakLoadedBytes = 0;
+};
+
+#endif // BATCH_RUNNER_H
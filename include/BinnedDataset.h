@@ -0,0 +1,46 @@
+#ifndef BINNED_DATASET_H
+#define BINNED_DATASET_H
+
+#include "EncodedDataset.h"
+#include <cstdint>
+
+// Квантованное представление признаков для гистограммного бустинга:
+// каждый признак — столбец uint8 с не более чем 256 бинами.
+// Категориальный признак получает бин на значение (редкие значения сверх
+// лимита объединяются), числовой — бины по квантилям; последний бин
+// каждого признака зарезервирован под пропуски.
+class BinnedDataset {
+public:
+    static constexpr size_t kMaxBins = 256;
+
+    BinnedDataset() = default;
+
+    // Построение границ бинов по данным и квантование этих данных
+    explicit BinnedDataset(const EncodedDataset& data, size_t maxBins = kMaxBins);
+
+    // Квантование другого набора (закодированного по той же схеме)
+    // по границам уже построенного
+    BinnedDataset(const EncodedDataset& data, const BinnedDataset& mapper);
+
+    size_t getRowCount() const { return rowCount; }
+    size_t getFeatureCount() const { return columns.size(); }
+    const std::vector<std::uint8_t>& getColumn(size_t feature) const { return columns[feature]; }
+
+    // Число бинов признака, включая бин пропусков
+    size_t getBinCount(size_t feature) const { return binCounts[feature]; }
+    std::uint8_t getMissingBin(size_t feature) const {
+        return static_cast<std::uint8_t>(binCounts[feature] - 1);
+    }
+    bool isNumeric(size_t feature) const { return numeric[feature]; }
+
+private:
+    size_t rowCount = 0;
+    std::vector<std::vector<std::uint8_t>> columns;
+    std::vector<std::vector<std::uint8_t>> codeToBin;  // код значения -> бин
+    std::vector<size_t> binCounts;
+    std::vector<bool> numeric;
+
+    void quantize(const EncodedDataset& data);
+};
+
+#endif // BINNED_DATASET_H
@@ -1,43 +1,64 @@
 #ifndef CART_H
 #define CART_H
 
-#include "DecisionTree.h"
+#include "TreeBuilder.h"
+#include "BinnedDataset.h"
+#include <bitset>
 
-class CARTTree : public DecisionTree {
-private:
-    double giniIndex(const std::vector<DataExample>& examples) const;
-    double giniGain(const std::vector<DataExample>& examples,
-                   const std::string& feature) const;
-    
-protected:
-    double calculateImpurity(const std::vector<DataExample>& examples) const override;
-    std::pair<std::string, double> findBestSplit(
-        const std::vector<DataExample>& examples,
-        const std::vector<std::string>& availableFeatures) const override;
-    std::shared_ptr<TreeNode> buildTreeRecursive(
-        const std::vector<DataExample>& examples,
-        const std::vector<std::string>& availableFeatures,
-        int depth) override;
-    
+// Параметры регрессионного дерева для градиентного бустинга
+struct GradientTreeParams {
+    int maxLeaves = 31;            // бюджет листьев
+    int maxDepth = -1;             // -1 — без ограничения
+    int minDataInLeaf = 20;
+    double minSumHessian = 1e-3;
+    double lambda = 1.0;           // L2-регуляризация значений листьев
+    double minSplitGain = 0.0;
+    double learningRate = 0.1;     // множитель значений листьев
+    unsigned threadCount = 0;      // 0 — все ядра
+};
+
+// CART: разбиения по уменьшению индекса Джини; кроме классификации —
+// регрессионные деревья по градиентам для бустинга
+class CARTTree : public BasicDecisionTree<GiniCriterion> {
 public:
-    CARTTree() : isClassification(true) {}
-    
-    void train(const Dataset& dataset) override;
-    std::string predict(const DataExample& example) const override;
+    CARTTree() : isClassification(true) {
+        stopping.rule.minParentSize = 2;
+        stopping.rule.minChildSize = 2;
+    }
     
-    // Для регрессии
-    double predictRegression(const DataExample& example) const;
+    void setMinSamplesSplit(int minSamples) {
+        stopping.rule.minParentSize = minSamples;
+        stopping.rule.minChildSize = minSamples;
+    }
+    void setMinImpurityDecrease(double decrease) { criterion.minDecrease = decrease; }
     
-    // Прунинг по стоимости-сложности
-    void costComplexityPrune(const Dataset& validationSet);
+    // Регрессионное дерево по градиентам и гессианам функции потерь
+    // (гистограммный алгоритм): лист с наибольшим приростом делится первым,
+    // пока не исчерпан бюджет листьев. rowOutputs получает выход дерева
+    // для каждой строки обучающего набора; строки с нулевым гессианом
+    // в построении не участвуют и получают 0.
+    void fitGradientHistogram(const BinnedDataset& data,
+                              const std::vector<float>& gradients,
+                              const std::vector<float>& hessians,
+                              const GradientTreeParams& params,
+                              std::vector<double>& rowOutputs);
+    double predictRegression(const BinnedDataset& data, size_t row) const;
+    size_t getRegressionNodeCount() const { return regressionNodes.size(); }
+    size_t getRegressionBytes() const { return regressionNodes.capacity() * sizeof(RegressionNode); }
+    int getRegressionDepth() const;
     
 private:
     bool isClassification;  // true для классификации, false для регрессии
-    int maxDepth = 10;
-    int minSamplesSplit = 2;
-    double minImpurityDecrease = 0.0;
     
-    // Для регрессии
-    double mse(const std::vector<DataExample>& examples) const;
+    // Узел регрессионного дерева: бины из leftBins уходят влево
+    struct RegressionNode {
+        int feature = -1;              // -1 — лист
+        std::bitset<BinnedDataset::kMaxBins> leftBins;
+        int left = -1;
+        int right = -1;
+        int depth = 0;
+        double value = 0.0;
+    };
+    std::vector<RegressionNode> regressionNodes;
 };
 #endif // CART_H
\ No newline at end of file
@@ -1,51 +1,18 @@
 #ifndef CHAID_H
 #define CHAID_H
 
-#include "DecisionTree.h"
-#include <map>
+#include "TreeBuilder.h"
 
-class CHAIDTree : public DecisionTree {
-private:
-    struct ChiSquareResult {
-        double value;
-        double pValue;
-        int degreesOfFreedom;
-    };
-    
-    ChiSquareResult chiSquareTest(
-        const std::vector<DataExample>& examples,
-        const std::string& feature) const;
-    
-    // Объединение категорий
-    std::vector<std::vector<std::string>> mergeCategories(
-        const std::vector<DataExample>& examples,
-        const std::string& feature) const;
-    
-protected:
-    double calculateImpurity(const std::vector<DataExample>& examples) const override;
-    std::pair<std::string, double> findBestSplit(
-        const std::vector<DataExample>& examples,
-        const std::vector<std::string>& availableFeatures) const override;
-    std::shared_ptr<TreeNode> buildTreeRecursive(
-        const std::vector<DataExample>& examples,
-        const std::vector<std::string>& availableFeatures,
-        int depth) override;
-    
+// CHAID: разбиение по признаку с наиболее значимой связью с классом
+class CHAIDTree : public BasicDecisionTree<ChiSquareCriterion> {
 public:
-    CHAIDTree() = default;
-    
-    void train(const Dataset& dataset) override;
-    std::string predict(const DataExample& example) const override;
-    
+    CHAIDTree() {
+        stopping.rule.maxDepth = 3;  // CHAID обычно строит неглубокие деревья
+        stopping.rule.minParentSize = 50;
+        stopping.rule.minChildSize = 10;
+    }
+
     // Настройки CHAID
-    void setSignificanceLevel(double alpha) { significanceLevel = alpha; }
-    void setMaxMergeIterations(int iterations) { maxMergeIterations = iterations; }
-    
-private:
-    double significanceLevel = 0.05;
-    int maxMergeIterations = 50;
-    int minParentSize = 50;
-    int minChildSize = 10;
-    int maxDepth = 3;  // CHAID обычно строит неглубокие деревья
+    void setSignificanceLevel(double alpha) { criterion.significance = alpha; }
 };
-#endif // CHAID_H
\ No newline at end of file
+#endif // CHAID_H
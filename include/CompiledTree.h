@@ -0,0 +1,97 @@
+#ifndef COMPILED_TREE_H
+#define COMPILED_TREE_H
+
+#include "DecisionTree.h"
+#include "EncodedDataset.h"
+#include <cstdint>
+#include <algorithm>
+
+// Плоское представление обученного дерева для быстрого предсказания
+// по закодированным строкам: узлы лежат в одном массиве, переход к потомку —
+// индексация таблицы по коду значения вместо поиска строки в std::map.
+class CompiledTree {
+public:
+    using Code = EncodedDataset::Code;
+
+    CompiledTree() = default;
+
+    // Компиляция дерева по словарям схемы (того набора, на котором оно обучено)
+    CompiledTree(const DecisionTree& tree, const EncodedDataset& schema);
+
+    // Предсказание для одной строки; EncodedDataset::kMissing — «Unknown»
+    Code predictRow(const EncodedDataset& data, size_t row) const {
+        if (nodes.empty()) return EncodedDataset::kMissing;
+        int32_t index = 0;
+        while (nodes[index].feature >= 0) {
+            const Node& node = nodes[index];
+            Code value = data.getColumn(node.feature)[row];
+            if (value >= node.childCount) return EncodedDataset::kMissing;
+            index = children[node.firstChild + value];
+            if (index < 0) return EncodedDataset::kMissing;
+        }
+        return nodes[index].classCode;
+    }
+
+    // Предсказание для строк [begin, end) в out
+    void predictBatch(const EncodedDataset& data, size_t begin, size_t end, Code* out) const;
+    
+    // Предсказания дерева, усеченного до каждой глубины 0..maxDepth, за один
+    // проход пути строки: out[d] — класс большинства узла на глубине d
+    // (или листа, если путь короче); после отсутствующей ветви — kMissing
+    void predictByDepth(const EncodedDataset& data, size_t row, int maxDepth, Code* out) const {
+        int32_t index = nodes.empty() ? -1 : 0;
+        for (int depth = 0; depth <= maxDepth; ++depth) {
+            if (index < 0) {
+                out[depth] = EncodedDataset::kMissing;
+                continue;
+            }
+            const Node& node = nodes[index];
+            out[depth] = node.classCode;
+            if (node.feature < 0) continue;  // лист: ответ не меняется с глубиной
+            Code value = data.getColumn(node.feature)[row];
+            index = value < node.childCount ? children[node.firstChild + value] : -1;
+        }
+    }
+
+    // Вероятности классов для строки (classCount значений в out): доли классов
+    // в листе, а если ветви для значения нет — в последнем достигнутом узле
+    void predictProbaRow(const EncodedDataset& data, size_t row, double* out) const {
+        if (nodes.empty()) {
+            std::fill(out, out + classCount, 0.0);
+            return;
+        }
+        int32_t index = 0;
+        while (nodes[index].feature >= 0) {
+            const Node& node = nodes[index];
+            Code value = data.getColumn(node.feature)[row];
+            int32_t next = value < node.childCount ? children[node.firstChild + value] : -1;
+            if (next < 0) break;
+            index = next;
+        }
+        const double* source = probabilities.data() + static_cast<size_t>(index) * classCount;
+        std::copy(source, source + classCount, out);
+    }
+
+    // Вероятности для всех строк набора: rows × classCount
+    std::vector<double> predictProba(const EncodedDataset& data) const;
+
+    size_t getNodeCount() const { return nodes.size(); }
+    size_t getClassCount() const { return classCount; }
+
+private:
+    struct Node {
+        int32_t feature = -1;          // -1 — лист
+        uint32_t firstChild = 0;       // начало таблицы потомков в children
+        uint32_t childCount = 0;       // размер таблицы (мощность признака)
+        Code classCode = EncodedDataset::kMissing;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int32_t> children;     // индекс узла-потомка по коду значения, -1 — нет ветви
+    std::vector<double> probabilities; // nodes × classCount, доли классов в узле
+    size_t classCount = 0;
+
+    int32_t compileNode(const TreeNode& node, const EncodedDataset& schema);
+};
+
+#endif // COMPILED_TREE_H
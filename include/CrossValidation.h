@@ -0,0 +1,61 @@
+#ifndef CROSS_VALIDATION_H
+#define CROSS_VALIDATION_H
+
+#include "DecisionTree.h"
+#include "EncodedDataset.h"
+#include "ReportGenerator.h"
+#include <cstdint>
+#include <functional>
+
+// Стратифицированная k-кратная кросс-валидация для любых деревьев.
+// Фолды — списки номеров строк одного общего EncodedDataset: обучающая
+// часть задается нулевыми весами отложенных строк, данные не копируются.
+// Все обучения (алгоритм × фолд) выполняются параллельно.
+// Модели вне иерархии деревьев (ансамбли) проходят те же фолды через
+// evaluateModels, чтобы их метрики были сравнимы с метриками деревьев.
+class CrossValidation {
+public:
+    // Предсказания модели для отложенной части фолда; trainingTime —
+    // астрономическое время одного обучения (с), без кодирования и оценки
+    struct FoldPredictions {
+        std::vector<EncodedDataset::Code> classes;
+        std::vector<double> probabilities;         // rows × число классов или пусто
+        double trainingTime = 0.0;
+    };
+
+    // Обучение по обучающей части фолда и предсказание для отложенной
+    // (обе части — подмножества строк исходного набора с его словарями)
+    using FoldModel = std::function<FoldPredictions(const EncodedDataset& train,
+                                                    const EncodedDataset& test)>;
+
+    explicit CrossValidation(int folds = 10, std::uint32_t seed = 42);
+
+    void setThreadCount(unsigned count) { threadCount = count; }  // 0 — все ядра
+
+    // Номера строк тестовой части каждого фолда; доли классов в фолдах
+    // совпадают с долями во всем наборе с точностью до одной строки.
+    // Фолдам раздаются строки набора, а не копии: строка с кратностью w
+    // (сжатый набор) целиком уходит в один фолд, и доли считаются по
+    // различным строкам
+    static std::vector<std::vector<std::uint32_t>> stratifiedFolds(
+        const EncodedDataset& data, int folds, std::uint32_t seed);
+
+    // Средние и стандартные отклонения метрик по фолдам для каждого алгоритма
+    // (precision/recall/F1 — макроусреднение по классам, см. MetricsEngine)
+    std::vector<AlgorithmResult> evaluate(
+        const EncodedDataset& data,
+        const std::vector<std::pair<std::string, DecisionTreeFactory>>& algorithms) const;
+
+    // То же для произвольных моделей на тех же фолдах; фолды обучаются
+    // по очереди, параллельность — внутри модели
+    std::vector<AlgorithmResult> evaluateModels(
+        const EncodedDataset& data,
+        const std::vector<std::pair<std::string, FoldModel>>& models) const;
+
+private:
+    int folds;
+    std::uint32_t seed;
+    unsigned threadCount = 0;
+};
+
+#endif // CROSS_VALIDATION_H
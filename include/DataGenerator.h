@@ -0,0 +1,72 @@
+#ifndef DATA_GENERATOR_H
+#define DATA_GENERATOR_H
+
+#include "EncodedDataset.h"
+#include <cstdint>
+
+// Описание одного признака синтетического набора
+struct FeatureSpec {
+    std::string name;
+    size_t cardinality = 4;            // число различных значений
+    bool numeric = false;              // числовой (упорядоченные значения)
+};
+
+// Схема синтетического набора
+struct GeneratorSchema {
+    std::vector<FeatureSpec> features;
+    std::string targetName = "Решение";
+    std::vector<std::string> classNames = {"Доработать", "Встречное_предложение", "Одобрить", "Отказать"};
+    // Относительные частоты классов в листьях заложенного дерева и в шуме
+    // (пусто — равные); задают перекос классов
+    std::vector<double> classWeights;
+    double noise = 0.05;               // доля строк со случайным классом
+    int treeDepth = 5;                 // глубина заложенного дерева
+
+    // Схема по умолчанию: categorical категориальных и numericCount числовых признаков
+    static GeneratorSchema makeDefault(size_t categorical = 6, size_t numericCount = 2,
+                                       size_t cardinality = 8);
+};
+
+// Генератор синтетических данных произвольного размера без персональных
+// данных. Класс строки задается заложенным деревом решений (истина,
+// которую алгоритмы должны восстановить) с шумом. Строки пишутся сразу
+// в столбцы EncodedDataset блоками фиксированного размера; зерно блока
+// выводится из общего зерна, поэтому результат не зависит от числа потоков.
+class DataGenerator {
+public:
+    DataGenerator(GeneratorSchema schema, std::uint32_t seed = 42);
+
+    // rows строк; threadCount == 0 — все ядра
+    EncodedDataset generate(size_t rows, unsigned threadCount = 0) const;
+
+    // Класс строки по заложенному дереву (без шума)
+    EncodedDataset::Code plantedClass(const EncodedDataset& data, size_t row) const;
+
+    // CSV в формате Dataset::loadFromCSV; блоки строк форматируются
+    // параллельно и пишутся по порядку
+    static bool writeCSV(const EncodedDataset& data, const std::string& filename,
+                         unsigned threadCount = 0);
+
+    const GeneratorSchema& getSchema() const { return schema; }
+
+private:
+    // Узел заложенного дерева: бинарное разбиение по признаку
+    struct PlantedNode {
+        int feature = -1;                  // -1 — лист
+        std::vector<bool> leftValues;      // коды значений, уходящие влево
+        int left = -1;
+        int right = -1;
+        EncodedDataset::Code label = 0;
+    };
+
+    GeneratorSchema schema;
+    std::uint32_t seed;
+    EncodedDataset prototype;              // имена и словари без строк
+    std::vector<double> cumulativeWeights; // по отсортированным классам
+    std::vector<PlantedNode> tree;
+
+    int plantNode(int depth, std::mt19937& rng);
+    EncodedDataset::Code drawClass(std::mt19937& rng) const;
+};
+
+#endif // DATA_GENERATOR_H
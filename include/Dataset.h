@@ -12,14 +12,17 @@
 #include <algorithm>
 #include <random>
 #include <iomanip>  // Добавляем этот include
+#include <cstdint>
+#include <unordered_map>
 
 // Структура для примера данных
 struct DataExample {
     std::map<std::string, std::string> features;  // Признаки
     std::string target;                           // Целевая переменная
     int id;                                       // Идентификатор
+    int weight;                                   // Кратность: сколько одинаковых строк представляет пример
     
-    DataExample() : id(0) {}
+    DataExample() : id(0), weight(1) {}
     
     std::string toString() const {
         std::string result = "ID: " + std::to_string(id) + " -> ";
@@ -95,6 +98,21 @@ public:
         return true;
     }
     
+    // Пустой набор с заданной схемой; примеры добавляются через addExample
+    void setSchema(const std::vector<std::string>& features, const std::string& target) {
+        featureNames = features;
+        targetName = target;
+        examples.clear();
+        featureValues.clear();
+    }
+    
+    void addExample(const DataExample& example) {
+        for (const auto& [feature, value] : example.features) {
+            featureValues[feature].push_back(value);
+        }
+        examples.push_back(example);
+    }
+    
     // Создание тестовых данных для банковского кредита (расширенный набор)
     void createBankLoanData() {
         featureNames = {"Ставка", "Срок_рассмотрения", "Требования_к_залогу", "Репутация_банка"};
@@ -153,30 +171,73 @@ public:
                   << " примерами" << std::endl;
     }
     
-    // Получить все данные в виде таблицы (для отчета)
+    // Сжатие повторов: одинаковые строки (признаки и целевая переменная)
+    // сливаются в одну с кратностью, равной сумме кратностей. Порядок первых
+    // вхождений и их идентификаторы сохраняются. Деревья и метрики учитывают
+    // кратности, поэтому результат обучения тот же, а его стоимость зависит
+    // от числа различных строк. Разделение на выборки идет по строкам после
+    // сжатия — сжимать лучше уже разделенные выборки. Возвращает число строк.
+    size_t compressDuplicates() {
+        std::unordered_map<std::string, size_t> index;
+        std::vector<DataExample> unique;
+        std::string key;
+        for (const auto& example : examples) {
+            key.clear();
+            for (const auto& feature : featureNames) {
+                auto it = example.features.find(feature);
+                if (it != example.features.end()) key += it->second;
+                key += '\x1f';
+            }
+            key += example.target;
+            auto [it, inserted] = index.try_emplace(key, unique.size());
+            if (inserted) {
+                unique.push_back(example);
+            } else {
+                unique[it->second].weight += example.weight;
+            }
+        }
+        examples = std::move(unique);
+        
+        featureValues.clear();
+        for (const auto& example : examples) {
+            for (const auto& [feature, value] : example.features) {
+                featureValues[feature].push_back(value);
+            }
+        }
+        return examples.size();
+    }
+    
+    // Число исходных строк с учетом кратностей
+    std::uint64_t getTotalWeight() const {
+        std::uint64_t total = 0;
+        for (const auto& example : examples) total += example.weight;
+        return total;
+    }
+    
+    // Получить все данные в виде таблицы (столбцы — по схеме набора;
+    // для больших наборов отчеты используют ReportGenerator::writeRowView)
     std::string getDataTableHTML() const {
         std::stringstream html;
         html << "<table border='1' style='border-collapse: collapse; width: 100%; margin: 20px 0;'>\n";
         html << "<tr style='background-color: #4CAF50; color: white;'>\n";
         html << "<th>№</th>\n";
-        html << "<th>Ставка</th>\n";
-        html << "<th>Срок рассмотрения</th>\n";
-        html << "<th>Требования к залогу</th>\n";
-        html << "<th>Репутация банка</th>\n";
-        html << "<th>Решение</th>\n";
+        for (const auto& feature : featureNames) {
+            html << "<th>" << feature << "</th>\n";
+        }
+        html << "<th>" << targetName << "</th>\n";
         html << "</tr>\n";
         
+        std::map<std::string, int> classCount;
         for (const auto& example : examples) {
             html << "<tr>\n";
             html << "<td>" << example.id << "</td>\n";
-            html << "<td>" << example.features.at("Ставка") << "</td>\n";
-            html << "<td>" << example.features.at("Срок_рассмотрения") << "</td>\n";
-            html << "<td>" << example.features.at("Требования_к_залогу") << "</td>\n";
-            html << "<td>" << example.features.at("Репутация_банка") << "</td>\n";
-            html << "<td style='font-weight: bold; color: " 
-                 << (example.target == "Одобрить" ? "green" : "red") << "'>"
-                 << example.target << "</td>\n";
+            for (const auto& feature : featureNames) {
+                auto it = example.features.find(feature);
+                html << "<td>" << (it != example.features.end() ? it->second : "—") << "</td>\n";
+            }
+            html << "<td style='font-weight: bold;'>" << example.target << "</td>\n";
             html << "</tr>\n";
+            classCount[example.target] += example.weight;
         }
         
         html << "</table>\n";
@@ -185,34 +246,16 @@ public:
         html << "<div style='background-color: #f9f9f9; padding: 15px; border-radius: 5px; margin: 20px 0;'>\n";
         html << "<h3>Статистика набора данных:</h3>\n";
         html << "<ul>\n";
-        
-        int approveCount = 0, rejectCount = 0;
-        for (const auto& ex : examples) {
-            if (ex.target == "Одобрить") approveCount++;
-            else rejectCount++;
+        std::uint64_t totalWeight = getTotalWeight();
+        html << "<li>Всего примеров: " << totalWeight << "</li>\n";
+        if (totalWeight != examples.size()) {
+            html << "<li>Различных строк: " << examples.size() << "</li>\n";
         }
-        
-        html << "<li>Всего примеров: " << examples.size() << "</li>\n";
-        html << "<li>Одобрено кредитов: " << approveCount << " (" 
-             << std::fixed << std::setprecision(1) 
-             << (static_cast<double>(approveCount) / examples.size() * 100) << "%)</li>\n";
-        html << "<li>Отказано в кредите: " << rejectCount << " (" 
-             << std::fixed << std::setprecision(1) 
-             << (static_cast<double>(rejectCount) / examples.size() * 100) << "%)</li>\n";
-        
-        // Статистика по признакам
-        html << "<li><strong>Распределение по ставкам:</strong> ";
-        std::map<std::string, int> rateCount;
-        for (const auto& ex : examples) {
-            rateCount[ex.features.at("Ставка")]++;
-        }
-        for (const auto& [rate, count] : rateCount) {
-            html << rate << ": " << count << " (" 
+        for (const auto& [name, count] : classCount) {
+            html << "<li>" << name << ": " << count << " ("
                  << std::fixed << std::setprecision(1)
-                 << (static_cast<double>(count) / examples.size() * 100) << "%), ";
+                 << (static_cast<double>(count) / totalWeight * 100) << "%)</li>\n";
         }
-        html << "</li>\n";
-        
         html << "</ul>\n";
         html << "</div>\n";
         
@@ -223,6 +266,7 @@ public:
     const std::vector<DataExample>& getExamples() const { return examples; }
     const std::vector<std::string>& getFeatureNames() const { return featureNames; }
     const std::string& getTargetName() const { return targetName; }
+    const std::map<std::string, std::vector<std::string>>& getFeatureValues() const { return featureValues; }
     
     // Получение уникальных значений признака
     std::vector<std::string> getUniqueValues(const std::string& feature) const {
@@ -237,6 +281,12 @@ public:
     
     // Разделение данных на обучающие и тестовые
     std::pair<Dataset, Dataset> split(double trainRatio = 0.7) const {
+        std::random_device rd;
+        return split(trainRatio, rd());
+    }
+    
+    // Воспроизводимое разделение с заданным зерном
+    std::pair<Dataset, Dataset> split(double trainRatio, std::uint32_t seed) const {
         Dataset trainSet, testSet;
         trainSet.featureNames = featureNames;
         trainSet.targetName = targetName;
@@ -246,8 +296,7 @@ public:
         std::vector<DataExample> shuffled = examples;
         
         // Используем современный shuffle вместо устаревшего random_shuffle
-        std::random_device rd;
-        std::mt19937 g(rd());
+        std::mt19937 g(seed);
         std::shuffle(shuffled.begin(), shuffled.end(), g);
         
         size_t trainSize = static_cast<size_t>(examples.size() * trainRatio);
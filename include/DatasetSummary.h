@@ -0,0 +1,36 @@
+#ifndef DATASET_SUMMARY_H
+#define DATASET_SUMMARY_H
+
+#include <string>
+#include <vector>
+#include "Dataset.h"
+
+// Значение признака: число примеров и их распределение по классам
+struct ValueSummary {
+    std::string value;
+    size_t count = 0;
+    std::vector<size_t> classCounts;   // по DatasetSummary::classNames
+};
+
+struct FeatureSummary {
+    std::string name;
+    size_t missing = 0;                // примеров без значения признака
+    std::vector<ValueSummary> values;  // по убыванию частоты
+};
+
+// Сводная статистика набора по его схеме (признаки из getFeatureNames),
+// без предположений о конкретных столбцах. Считается за один проход:
+// блоки примеров обрабатываются параллельно, частичные счетчики
+// объединяются в конце. Счетчики взвешены кратностями примеров
+// (DataExample::weight): сводка сжатого набора та же, что исходного.
+struct DatasetSummary {
+    size_t rows = 0;                       // сумма кратностей
+    std::string targetName;
+    std::vector<std::string> classNames;   // по алфавиту
+    std::vector<size_t> classCounts;
+    std::vector<FeatureSummary> features;
+
+    static DatasetSummary compute(const Dataset& dataset, unsigned threadCount = 0);
+};
+
+#endif // DATASET_SUMMARY_H
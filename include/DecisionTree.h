@@ -2,7 +2,14 @@
 #define DECISION_TREE_H
 
 #include "Dataset.h"
+#include "EncodedDataset.h"
+#include "SplitStatistics.h"
 #include <memory>
+#include <functional>
+#include <random>
+#include <limits>
+
+class SplitStatsCache;
 
 // Структура узла дерева
 struct TreeNode {
@@ -13,6 +20,8 @@ struct TreeNode {
     std::map<std::string, std::shared_ptr<TreeNode>> children;
     double confidence;            // Уверенность в решении
     int samples;                  // Количество примеров в узле
+    std::vector<double> classCounts;  // Распределение классов в узле (decision заполнен
+                                      // и у внутренних узлов — класс большинства)
     
     TreeNode() : isLeaf(false), splitValue(0.0), confidence(1.0), samples(0) {}
     
@@ -25,6 +34,30 @@ struct TreeNode {
     }
 };
 
+// Ограничения роста дерева (размеры узлов взвешенные — с учетом кратности строк)
+struct StoppingRule {
+    int maxDepth = 10;
+    double minParentSize = 0.0;   // меньший узел не разделяется
+    double minChildSize = 0.0;    // меньший потомок становится листом с классом родителя
+};
+
+// Лучшее разбиение узла по одному признаку
+struct SplitCandidate {
+    double score = -std::numeric_limits<double>::infinity();  // -inf — разбиение неприемлемо
+    // Бинарное разбиение: значения, уходящие в левую ветвь.
+    // Пусто — отдельная ветвь на каждое значение (признак исчерпывается)
+    std::vector<bool> leftValues;
+};
+
+// Параметры построения по закодированным данным
+struct EncodedTrainOptions {
+    int maxFeatures = 0;       // признаков-кандидатов в узле (0 — все доступные)
+    std::uint32_t seed = 0;    // зерно для случайного выбора признаков
+    // Общий кэш таблиц узлов (см. SplitStatsCache); используется, только
+    // если построен для того же набора и тех же весов строк
+    SplitStatsCache* cache = nullptr;
+};
+
 // Абстрактный базовый класс для деревьев решений
 class DecisionTree {
 protected:
@@ -42,6 +75,12 @@ protected:
         const std::vector<std::string>& availableFeatures,
         int depth) = 0;
     
+    // Построение по закодированным данным (см. TreeBuilder): одно виртуальное
+    // обращение на обучение, критерий подставлен в построитель наследника
+    virtual std::shared_ptr<TreeNode> buildEncoded(const EncodedDataset& data,
+                                                   const std::vector<std::uint32_t>& rowWeights,
+                                                   const EncodedTrainOptions& options) const = 0;
+    
 public:
     DecisionTree() = default;
     virtual ~DecisionTree() = default;
@@ -49,18 +88,35 @@ public:
     virtual void train(const Dataset& dataset) = 0;
     virtual std::string predict(const DataExample& example) const = 0;
     
+    // Обучение по общему закодированному набору без копирования строк:
+    // rowWeights — кратность каждой строки (пусто — кратности самого набора,
+    // см. EncodedDataset::getWeights; 0 — строка не участвует), например
+    // счетчики бутстрэп-выборки
+    void trainEncoded(const EncodedDataset& data,
+                      const std::vector<std::uint32_t>& rowWeights = {},
+                      const EncodedTrainOptions& options = {});
+    
     // Общие методы
     std::shared_ptr<TreeNode> getRoot() const { return root; }
     int getTreeDepth(std::shared_ptr<TreeNode> node) const;
     int countNodes(std::shared_ptr<TreeNode> node) const;
     
+    // Потомки узла без повторов: при бинарном разбиении один потомок
+    // висит на нескольких значениях, метка ветви — их перечисление
+    static std::vector<std::pair<std::string, std::shared_ptr<TreeNode>>>
+    groupChildren(const TreeNode& node);
+    
     // Валидация
     double evaluate(const Dataset& testSet) const;
     
-    // Визуализация
+    // Визуализация и экспорт (с отсечением по глубине — TreeExporter)
     virtual void saveToDot(const std::string& filename) const;
+    void saveToJSON(const std::string& filename) const;
     virtual void printTree(std::shared_ptr<TreeNode> node = nullptr, 
                           int depth = 0) const;
 };
 
+// Фабрика деревьев для ансамблей и кросс-валидации
+using DecisionTreeFactory = std::function<std::unique_ptr<DecisionTree>()>;
+
 #endif // DECISION_TREE_H
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef DEPTH_SWEEP_H
+#define DEPTH_SWEEP_H
+
+#include "CompiledTree.h"
+#include "EncodedDataset.h"
+
+// Подбор глубины дерева за одно обучение: дерево строится до наибольшей
+// глубины, каждый узел хранит класс большинства, а точность дерева,
+// усеченного до каждой глубины 0..maxDepth, считается за один проход
+// валидационного набора (путь строки обрывается на каждой глубине).
+class DepthSweep {
+public:
+    // accuracy[d] — точность дерева, усеченного до глубины d
+    static std::vector<double> evaluate(const CompiledTree& tree,
+                                        const EncodedDataset& validation,
+                                        int maxDepth,
+                                        unsigned threadCount = 0);
+
+    // Наименьшая глубина с наибольшей точностью
+    static int bestDepth(const std::vector<double>& accuracy);
+};
+
+#endif // DEPTH_SWEEP_H
@@ -0,0 +1,96 @@
+#ifndef ENCODED_DATASET_H
+#define ENCODED_DATASET_H
+
+#include "Dataset.h"
+#include <cstdint>
+#include <limits>
+
+// Неизменяемое столбцовое представление набора данных: каждое значение
+// признака и класса заменено целочисленным кодом. Одна копия разделяется
+// всеми деревьями ансамбля, подвыборки задаются весами строк, а не копиями.
+class EncodedDataset {
+    friend class DataGenerator;
+    
+public:
+    using Code = std::uint32_t;
+    static constexpr Code kMissing = std::numeric_limits<Code>::max();
+
+    EncodedDataset() = default;
+
+    // Кодирование набора данных со своими словарями значений
+    explicit EncodedDataset(const Dataset& dataset);
+
+    // Кодирование примеров по заданным признакам (строковое обучение
+    // деревьев по произвольному подмножеству примеров)
+    EncodedDataset(const std::vector<DataExample>& examples,
+                   const std::vector<std::string>& features,
+                   const std::string& targetName = std::string());
+
+    // Кодирование по словарям другого набора (например, тестовой выборки
+    // по словарям обучающей); неизвестные значения получают kMissing
+    EncodedDataset(const Dataset& dataset, const EncodedDataset& schema);
+
+    size_t getRowCount() const { return targets.size(); }
+    size_t getFeatureCount() const { return featureNames.size(); }
+    size_t getClassCount() const { return classNames.size(); }
+
+    const std::vector<Code>& getColumn(size_t feature) const { return columns[feature]; }
+    const std::vector<Code>& getTargets() const { return targets; }
+
+    // Кратности строк (пусто — каждая строка по одному разу)
+    const std::vector<std::uint32_t>& getWeights() const { return weights; }
+    std::uint32_t getWeight(size_t row) const { return weights.empty() ? 1 : weights[row]; }
+    std::uint64_t getTotalWeight() const;
+
+    const std::vector<std::string>& getFeatureNames() const { return featureNames; }
+    const std::string& getTargetName() const { return targetName; }
+    const std::vector<std::string>& getClassNames() const { return classNames; }
+    const std::vector<std::string>& getValueNames(size_t feature) const { return valueNames[feature]; }
+    size_t getCardinality(size_t feature) const { return valueNames[feature].size(); }
+
+    // Признак числовой, если все его значения разбираются как числа;
+    // тогда коды упорядочены по возрастанию числового значения
+    bool isNumeric(size_t feature) const { return numeric[feature]; }
+
+    // Поиск по именам (-1 / kMissing, если не найдено)
+    int findFeature(const std::string& name) const;
+    Code encodeValue(size_t feature, const std::string& value) const;
+    Code encodeClass(const std::string& className) const;
+    const std::string& decodeClass(Code code) const;
+
+    // Отпечаток содержимого (FNV-1a по именам, словарям и кодам): один и тот же
+    // набор в разных запусках узнается без сравнения данных
+    std::uint64_t fingerprint() const;
+
+    // Подмножество строк с теми же словарями: коды совместимы с исходным
+    // набором (обучающая и тестовая части без повторного кодирования)
+    EncodedDataset selectRows(const std::vector<std::uint32_t>& rows) const;
+
+    // Набор без повторов: одинаковые строки кодов сливаются в одну с суммарной
+    // кратностью (см. Dataset::compressDuplicates), словари те же
+    EncodedDataset compressDuplicates() const;
+
+    // Строковый набор из не более maxRows строк, взятых равномерно
+    // (для отчетов по наборам, загруженным сразу в кодах)
+    Dataset decode(size_t maxRows = std::numeric_limits<size_t>::max()) const;
+
+    // Двоичный формат: заголовок, словари и столбцы кодов как есть
+    // (little-endian uint32) — загрузка без разбора строк
+    bool saveBinary(const std::string& filename) const;
+    bool loadBinary(const std::string& filename);
+
+private:
+    std::vector<std::string> featureNames;
+    std::string targetName;
+    std::vector<std::vector<std::string>> valueNames;  // словарь значений каждого признака
+    std::vector<bool> numeric;
+    std::vector<std::string> classNames;
+
+    std::vector<std::vector<Code>> columns;  // по столбцу на признак
+    std::vector<Code> targets;
+    std::vector<std::uint32_t> weights;
+
+    void encodeRows(const std::vector<DataExample>& examples);
+};
+
+#endif // ENCODED_DATASET_H
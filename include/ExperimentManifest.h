@@ -0,0 +1,91 @@
+#ifndef EXPERIMENT_MANIFEST_H
+#define EXPERIMENT_MANIFEST_H
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Источник данных: встроенный набор, сгенерированный DataGenerator,
+// CSV (Dataset::loadFromCSV) или двоичный файл EncodedDataset
+struct DatasetSpec {
+    std::string name;
+    std::string source = "builtin";        // builtin | generate | csv | binary
+    std::string path;                      // csv, binary
+    std::vector<std::string> features;     // csv: пусто — все столбцы заголовка, кроме целевого
+    std::string target;                    // csv: пусто — последний столбец
+    size_t rows = 0;                       // generate
+    std::uint32_t seed = 42;               // generate
+    double testShare = 0.3;                // доля тестовой выборки
+    bool compress = false;                 // сжатие повторов выборок после разделения
+
+    // Оценка памяти набора после загрузки (байты) — для допуска к загрузке
+    size_t estimateBytes() const;
+};
+
+// Одно задание: алгоритм с конкретными параметрами на наборе данных;
+// зерно задает разделение на выборки и случайность модели
+struct ExperimentJob {
+    size_t id = 0;
+    std::string experiment;
+    size_t dataset = 0;                    // индекс в getDatasets()
+    std::string algorithm;
+    std::vector<std::pair<std::string, std::string>> parameters;  // только применимые к алгоритму
+    std::uint32_t seed = 42;
+
+    // «CART max_depth=5 seed=1»
+    std::string label() const;
+};
+
+struct BatchSettings {
+    unsigned workers = 0;                  // 0 — все ядра
+    size_t memoryLimit = 0;                // байт на одновременно загруженные наборы (0 — без ограничения)
+    std::string outputDirectory = "output/batch";
+    bool reports = true;                   // HTML-отчет по каждому набору
+};
+
+// Манифест пакетного запуска в формате INI:
+//
+//   [batch]                 workers, memory_limit_mb, output, reports
+//   [dataset ИМЯ]           source, path, features, target, rows, seed, test_share,
+//                           compress
+//   [experiment ИМЯ]        datasets, algorithms, seeds и списки значений
+//                           параметров алгоритмов (max_depth = 3, 5, 10 ...)
+//
+// Значения — через запятую, комментарии — с «#» или «;». Задания —
+// декартово произведение наборов, алгоритмов, зерен и значений только
+// тех параметров, которые алгоритм использует.
+class ExperimentManifest {
+public:
+    bool load(const std::string& filename);
+    bool parse(std::istream& input, const std::string& sourceName);
+
+    const BatchSettings& getSettings() const { return settings; }
+    const std::vector<DatasetSpec>& getDatasets() const { return datasets; }
+
+    // Задания, сгруппированные по наборам данных (в порядке объявления наборов)
+    std::vector<ExperimentJob> expandJobs() const;
+
+    // Параметры, которые использует алгоритм; пусто — алгоритм неизвестен
+    static const std::vector<std::string>& parameterNames(const std::string& algorithm);
+
+private:
+    struct ExperimentSpec {
+        std::string name;
+        std::vector<std::string> datasets;
+        std::vector<std::string> algorithms;
+        std::vector<std::uint32_t> seeds = {42};
+        std::map<std::string, std::vector<std::string>> parameters;
+    };
+
+    BatchSettings settings;
+    std::vector<DatasetSpec> datasets;
+    std::vector<ExperimentSpec> experiments;
+
+    bool validate(const std::string& sourceName) const;
+    int findDataset(const std::string& name) const;
+};
+
+#endif // EXPERIMENT_MANIFEST_H
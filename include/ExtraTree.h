@@ -0,0 +1,39 @@
+#ifndef EXTRA_TREE_H
+#define EXTRA_TREE_H
+
+#include "TreeBuilder.h"
+
+// Случайный критерий Extra-Trees: разбиение признака не ищется перебором,
+// а вытягивается случайно — порог для числового признака или подмножество
+// категорий для категориального; оценка — прирост Джини по той же таблице
+struct ExtraSplitCriterion {
+    double impurity(const double* classCounts, size_t classes, double total) const {
+        return giniOf(classCounts, classes, total);
+    }
+
+    SplitCandidate evaluate(const ContingencyTable& table, std::mt19937& rng) const;
+
+    // Оценки нет: признаки перебираются по порядку без отсечения (так
+    // генератор расходуется одинаково); признак с одним значением не делится
+    double upperBound(const NodeClasses& /*node*/, size_t values, bool /*complete*/) const {
+        return values < 2 ? -std::numeric_limits<double>::infinity()
+                          : std::numeric_limits<double>::infinity();
+    }
+};
+
+// Чрезвычайно случайное дерево (Extra-Trees): бинарные разбиения по
+// ExtraSplitCriterion, один проход подсчета на признак, сортировка
+// в узлах не нужна
+class ExtraTree : public BasicDecisionTree<ExtraSplitCriterion> {
+public:
+    ExtraTree() {
+        stopping.rule.minParentSize = 2;
+        trainOptions.seed = 42;
+    }
+
+    void setMinSamplesSplit(int minSamples) { stopping.rule.minParentSize = minSamples; }
+    // Зерно строкового обучения (при обучении по закодированным данным —
+    // EncodedTrainOptions::seed)
+    void setSeed(std::uint32_t seed) { trainOptions.seed = seed; }
+};
+#endif // EXTRA_TREE_H
@@ -0,0 +1,55 @@
+#ifndef GRADIENT_BOOSTING_H
+#define GRADIENT_BOOSTING_H
+
+#include "CART.h"
+#include "BinnedDataset.h"
+#include "EncodedDataset.h"
+
+// Градиентный бустинг на регрессионных деревьях CARTTree.
+// Признаки квантуются один раз (BinnedDataset), каждое дерево растет
+// по гистограммам градиентов. Два класса — логистическая функция потерь
+// (одно дерево за раунд), больше — softmax (дерево на класс за раунд).
+class GradientBoosting {
+public:
+    GradientBoosting() = default;
+
+    void setRounds(int count) { rounds = count; }
+    void setLearningRate(double rate) { treeParams.learningRate = rate; }
+    void setMaxLeaves(int count) { treeParams.maxLeaves = count; }
+    void setMaxDepth(int depth) { treeParams.maxDepth = depth; }
+    void setMinDataInLeaf(int count) { treeParams.minDataInLeaf = count; }
+    void setLambda(double value) { treeParams.lambda = value; }
+    void setMaxBins(size_t count) { maxBins = count; }
+    void setThreadCount(unsigned count) { threadCount = count; treeParams.threadCount = count; }
+
+    void train(const EncodedDataset& data);
+
+    // Сырые оценки (логиты) для строк набора, закодированного по схеме обучающего
+    std::vector<double> predictRaw(const EncodedDataset& data) const;
+
+    // Предсказанные классы (пакетно, параллельно по блокам строк)
+    std::vector<EncodedDataset::Code> predictBatch(const EncodedDataset& data) const;
+
+    // Вероятности классов (сигмоида или softmax логитов): rows × число классов
+    std::vector<double> predictProba(const EncodedDataset& data) const;
+
+    // Доля верных ответов среди строк с известным классом
+    double evaluate(const EncodedDataset& testSet) const;
+
+    size_t getTreeCount() const { return trees.size(); }
+    const CARTTree& getTree(size_t index) const { return trees[index]; }
+
+private:
+    int rounds = 100;
+    size_t maxBins = BinnedDataset::kMaxBins;
+    unsigned threadCount = 0;
+    GradientTreeParams treeParams;
+
+    size_t classCount = 0;
+    size_t outputCount = 0;            // деревьев за раунд
+    std::vector<double> baseScores;    // начальные оценки (априорные логиты)
+    BinnedDataset binMapper;           // границы бинов обучающего набора
+    std::vector<CARTTree> trees;       // раунд за раундом, outputCount деревьев в раунде
+};
+
+#endif // GRADIENT_BOOSTING_H
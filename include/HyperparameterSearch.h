@@ -0,0 +1,83 @@
+#ifndef HYPERPARAMETER_SEARCH_H
+#define HYPERPARAMETER_SEARCH_H
+
+#include "DecisionTree.h"
+#include "EncodedDataset.h"
+#include <cstdint>
+
+// Одна конфигурация настраиваемых параметров; для каждого алгоритма
+// используются только его параметры (ID3 — глубина, C4.5 — глубина,
+// minSamplesSplit и minGainRatio, CART — глубина, minSamplesSplit
+// и minImpurityDecrease, CHAID — глубина и уровень значимости)
+struct TuningConfig {
+    std::string algorithm;             // "ID3", "C4.5", "CART", "CHAID"
+    int maxDepth = 10;
+    int minSamplesSplit = 2;
+    double significanceLevel = 0.05;
+    double minGainRatio = 0.01;
+    double minImpurityDecrease = 0.0;
+
+    // Дерево с параметрами конфигурации; nullptr — неизвестный алгоритм
+    std::unique_ptr<DecisionTree> makeTree() const;
+    std::string toString() const;
+};
+
+// Сетка значений параметров
+struct ParameterGrid {
+    std::vector<int> maxDepths = {2, 3, 4, 5, 6, 8, 10};
+    std::vector<int> minSamplesSplits = {2, 5, 10, 20};
+    std::vector<double> significanceLevels = {0.01, 0.05, 0.1};
+    std::vector<double> minGainRatios = {0.0, 0.01, 0.05};
+    std::vector<double> minImpurityDecreases = {0.0, 0.001, 0.01};
+};
+
+// Результат конфигурации по фолдам кросс-валидации
+struct TuningResult {
+    TuningConfig config;
+    double accuracy = 0.0;
+    double accuracyStd = 0.0;
+    double trainingTime = 0.0;         // суммарно по фолдам, секунды
+    int nodeCount = 0;                 // среднее по фолдам
+};
+
+// Перебор гиперпараметров по сетке или случайной подвыборке сетки.
+// Каждая конфигурация оценивается стратифицированной k-кратной
+// кросс-валидацией; обучения (конфигурация × фолд) раздаются пулу потоков.
+// Деревья одного фолда строятся с общим SplitStatsCache: конфигурации,
+// деревья которых совпадают до некоторой глубины, не пересчитывают
+// статистику общих узлов по строкам.
+class HyperparameterSearch {
+public:
+    explicit HyperparameterSearch(int folds = 5, std::uint32_t seed = 42);
+
+    void setThreadCount(unsigned count) { threadCount = count; }  // 0 — все ядра
+    void setCacheEnabled(bool enabled) { cacheEnabled = enabled; }
+    void setMaxCacheEntries(size_t entries) { maxCacheEntries = entries; }
+
+    // Все сочетания параметров алгоритма из сетки
+    static std::vector<TuningConfig> gridConfigs(const std::string& algorithm,
+                                                 const ParameterGrid& grid);
+    // Не более count различных сочетаний, выбранных случайно
+    static std::vector<TuningConfig> randomConfigs(const std::string& algorithm,
+                                                   const ParameterGrid& grid,
+                                                   size_t count, std::uint32_t seed);
+
+    // Результаты, отсортированные по убыванию средней точности
+    std::vector<TuningResult> evaluate(const EncodedDataset& data,
+                                       const std::vector<TuningConfig>& configs);
+
+    // Статистика кэша последнего запуска
+    size_t getCacheHitCount() const { return cacheHits; }
+    size_t getCacheMissCount() const { return cacheMisses; }
+
+private:
+    int folds;
+    std::uint32_t seed;
+    unsigned threadCount = 0;
+    bool cacheEnabled = true;
+    size_t maxCacheEntries = 1 << 20;
+    size_t cacheHits = 0;
+    size_t cacheMisses = 0;
+};
+
+#endif // HYPERPARAMETER_SEARCH_H
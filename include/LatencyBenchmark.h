@@ -0,0 +1,49 @@
+#ifndef LATENCY_BENCHMARK_H
+#define LATENCY_BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include "Dataset.h"
+#include "DecisionTree.h"
+#include "EncodedDataset.h"
+#include "LatencyHistogram.h"
+
+// Распределение задержки одного пути предсказания (нс на вызов)
+struct LatencyDistribution {
+    std::string path;              // «predict», «compiled», «batch N»
+    size_t batchSize = 1;          // решений за вызов
+    std::uint64_t samples = 0;     // замеренных вызовов
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double rowsPerSecond = 0.0;    // пропускная способность, решений в секунду
+};
+
+// Замер задержек предсказания: поток строк (тестовая выборка по кругу)
+// проигрывается через строковый predict, скомпилированное дерево по одной
+// строке и пакетный predictBatch с фиксированными размерами пакета.
+// Каждый вызов замеряется отдельно; из замера вычитается стоимость
+// самого чтения часов.
+class LatencyBenchmark {
+public:
+    explicit LatencyBenchmark(size_t decisions = 20000,
+                              std::vector<size_t> batchSizes = {16, 256});
+
+    // schema — закодированная обучающая выборка (словари дерева)
+    std::vector<LatencyDistribution> measure(const DecisionTree& tree,
+                                             const Dataset& rows,
+                                             const EncodedDataset& schema) const;
+
+    static LatencyDistribution summarize(const std::string& path, size_t batchSize,
+                                         const LatencyHistogram& histogram,
+                                         double seconds, std::uint64_t decisions);
+
+private:
+    size_t decisions;
+    std::vector<size_t> batchSizes;
+};
+
+#endif // LATENCY_BENCHMARK_H
@@ -0,0 +1,43 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Гистограмма задержек в духе HDR Histogram: значения до 2^precisionBits нс
+// хранятся точно, дальше каждый диапазон [2^k, 2^(k+1)) делится на
+// 2^(precisionBits-1) равных ячеек, так что относительная ошибка перцентиля
+// не превышает 2^-(precisionBits-1) при памяти, логарифмической по диапазону.
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(int precisionBits = 8);
+
+    void record(std::uint64_t nanoseconds);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    std::uint64_t getCount() const { return count; }
+    std::uint64_t getMin() const { return count ? minValue : 0; }
+    std::uint64_t getMax() const { return maxValue; }
+    double getMean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
+    // Значение, не меньшее percentile процентов замеров (0..100),
+    // с точностью до ячейки — верхняя граница ячейки, но не больше максимума
+    std::uint64_t valueAtPercentile(double percentile) const;
+
+private:
+    int precisionBits;
+    std::uint64_t exactLimit;       // 2^precisionBits — граница точных значений
+    std::uint64_t halfRange;        // ячеек в каждом следующем диапазоне
+    std::vector<std::uint64_t> counts;
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t minValue = 0;
+    std::uint64_t maxValue = 0;
+
+    size_t indexOf(std::uint64_t value) const;
+    std::uint64_t upperBoundOf(size_t index) const;
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,45 @@
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <cstddef>
+#include "Dataset.h"
+#include "DecisionTree.h"
+#include "EncodedDataset.h"
+
+// Байты, занятые структурой, по категориям. Оценка по емкостям контейнеров
+// и размерам узлов стандартной библиотеки (без учета выравнивания аллокатора)
+struct MemoryBreakdown {
+    size_t nodes = 0;          // объекты узлов дерева или записи примеров
+    size_t strings = 0;        // буферы строк в куче (короткие строки — внутри объекта)
+    size_t children = 0;       // узлы std::map (потомки узла, признаки примера)
+    size_t statistics = 0;     // распределения классов, столбцы, словари
+
+    size_t total() const { return nodes + strings + children + statistics; }
+
+    MemoryBreakdown& operator+=(const MemoryBreakdown& other) {
+        nodes += other.nodes;
+        strings += other.strings;
+        children += other.children;
+        statistics += other.statistics;
+        return *this;
+    }
+};
+
+class MemoryUsage {
+public:
+    static MemoryBreakdown ofDataset(const Dataset& dataset);
+    static MemoryBreakdown ofEncoded(const EncodedDataset& data);
+
+    // Узлы, общие для нескольких ветвей (бинарные разбиения), считаются один раз
+    static MemoryBreakdown ofTree(const DecisionTree& tree);
+
+    // Резидентная память процесса сейчас и ее пик с начала работы (байты);
+    // 0 — платформа не дает этих сведений
+    static size_t currentResidentBytes();
+    static size_t peakResidentBytes();
+
+    // Человекочитаемый размер: «512 Б», «12.3 КБ», «4.56 МБ»
+    static std::string formatBytes(size_t bytes);
+};
+
+#endif // MEMORY_USAGE_H
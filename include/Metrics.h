@@ -0,0 +1,74 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "EncodedDataset.h"
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+// Метрики одного класса (один против остальных)
+struct ClassMetrics {
+    double precision = 0.0;
+    double recall = 0.0;
+    double f1Score = 0.0;
+    std::uint64_t support = 0;         // строк с этим фактическим классом (с учетом кратностей)
+    double auc = std::numeric_limits<double>::quiet_NaN();  // NaN — нет вероятностей
+};
+
+// Метрики многоклассовой классификации по матрице ошибок
+struct ClassificationMetrics {
+    size_t classCount = 0;
+    // (classCount + 1)², строки — фактический класс, столбцы — предсказанный;
+    // последний индекс — неизвестный класс (EncodedDataset::kMissing)
+    std::vector<std::uint64_t> confusion;
+    std::uint64_t total = 0;           // сумма кратностей строк
+
+    double accuracy = 0.0;
+    std::vector<ClassMetrics> perClass;
+    double macroPrecision = 0.0;
+    double macroRecall = 0.0;
+    double macroF1 = 0.0;
+    double microPrecision = 0.0;
+    double microRecall = 0.0;
+    double microF1 = 0.0;
+    // Только при переданных вероятностях классов, иначе NaN
+    double logLoss = std::numeric_limits<double>::quiet_NaN();
+    double macroAuc = std::numeric_limits<double>::quiet_NaN();
+
+    std::uint64_t at(size_t actual, size_t predicted) const {
+        return confusion[actual * (classCount + 1) + predicted];
+    }
+};
+
+// Оценка предсказаний по массивам кодов классов за один проход:
+// строки делятся на блоки, каждый блок параллельно накапливает свою
+// матрицу ошибок, сумму log-loss и гистограммы вероятностей для AUC,
+// затем частичные итоги складываются. Все метрики выводятся из них.
+// Строка с кратностью w учитывается как w одинаковых строк.
+class MetricsEngine {
+public:
+    using Code = EncodedDataset::Code;
+
+    // Число интервалов гистограммы вероятностей при расчете AUC
+    static constexpr size_t kAucBins = 1024;
+
+    // probabilities — rows × classCount (вероятности классов по строкам)
+    // или nullptr; threads == 0 — все ядра; weights — кратности строк
+    // или nullptr (каждая строка по одному разу)
+    static ClassificationMetrics evaluate(const Code* actual,
+                                          const Code* predicted,
+                                          size_t rows,
+                                          size_t classCount,
+                                          const double* probabilities = nullptr,
+                                          unsigned threads = 0,
+                                          const std::uint32_t* weights = nullptr);
+
+    static ClassificationMetrics evaluate(const std::vector<Code>& actual,
+                                          const std::vector<Code>& predicted,
+                                          size_t classCount,
+                                          const std::vector<double>& probabilities = {},
+                                          unsigned threads = 0,
+                                          const std::vector<std::uint32_t>& weights = {});
+};
+
+#endif // METRICS_H
@@ -0,0 +1,58 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+#include <cstddef>
+
+// Число рабочих потоков по умолчанию (не меньше одного)
+inline unsigned defaultThreadCount() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+// Параллельный цикл по индексам [0, count): задачи раздаются потокам
+// динамически через общий счетчик, поэтому неравные по стоимости задачи
+// (деревья разной глубины, фолды разного размера) балансируются сами.
+// threads == 0 означает defaultThreadCount(). Первое исключение из задачи
+// пробрасывается в вызывающий поток после завершения всех потоков.
+template <typename Fn>
+void parallelFor(size_t count, unsigned threads, Fn&& fn) {
+    if (count == 0) return;
+    if (threads == 0) threads = defaultThreadCount();
+    threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+
+    auto worker = [&]() {
+        while (!failed.load(std::memory_order_relaxed)) {
+            size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count) break;
+            try {
+                fn(i);
+            } catch (...) {
+                if (!failed.exchange(true)) error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    if (error) std::rethrow_exception(error);
+}
+
+#endif // PARALLEL_H
@@ -0,0 +1,98 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Фазы обучения, по которым собирается время. Поиск разбиения включает
+// подсчет статистики и оценку критерия (время вложенных фаз входит в объемлющую)
+enum class ProfilePhase : size_t {
+    Counting,          // подсчет статистики по строкам (таблицы, гистограммы)
+    Impurity,          // оценка критерия разбиения по статистике
+    SplitSearch,       // поиск разбиения узла целиком
+    Partition,         // перераспределение строк по потомкам
+    NodeAllocation     // создание узлов дерева
+};
+
+constexpr size_t kProfilePhaseCount = 5;
+
+struct PhaseStats {
+    std::uint64_t calls = 0;
+    std::uint64_t nanoseconds = 0;
+};
+
+// Сводка счетчиков всех потоков
+struct ProfileSnapshot {
+    std::array<PhaseStats, kProfilePhaseCount> phases{};
+    std::uint64_t nodes = 0;           // построенных узлов
+    int maxDepth = 0;                  // наибольшая глубина рекурсии
+
+    const PhaseStats& operator[](ProfilePhase phase) const {
+        return phases[static_cast<size_t>(phase)];
+    }
+    bool empty() const { return nodes == 0; }
+
+    static const char* phaseName(ProfilePhase phase);
+};
+
+// Встроенный профилировщик обучения. Каждый поток пишет в свои счетчики
+// (без блокировок и разделяемых кэш-линий), при завершении потока они
+// переносятся в общий итог; collect() складывает итог и живые потоки.
+// Выключенный профилировщик стоит одной проверки флага на замер.
+class Profiler {
+public:
+    static void setEnabled(bool value) { enabled.store(value, std::memory_order_relaxed); }
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    static void add(ProfilePhase phase, std::uint64_t nanoseconds);
+    static void addNode(int depth);
+
+    // Вызывать, когда обучение завершено (все рабочие потоки присоединены)
+    static ProfileSnapshot collect();
+    static void reset();
+
+    // Только счетчики вызывающего потока: профиль однопоточного обучения,
+    // идущего одновременно с другими
+    static ProfileSnapshot collectThread();
+    static void resetThread();
+
+    // Процессорное время вызывающего потока, с: время однопоточного
+    // обучения не зависит от задач, идущих одновременно с ним
+    static double threadCpuSeconds();
+
+    // Длительность с единицей по величине: «12.3 мкс», «4.56 мс», «1.234 с»
+    static std::string formatSeconds(double seconds);
+
+private:
+    static inline std::atomic<bool> enabled{false};
+};
+
+// Замер фазы на время жизни объекта
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase phase)
+        : phase(phase), active(Profiler::isEnabled()) {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+
+    ~ProfileScope() {
+        if (!active) return;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        Profiler::add(phase, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfilePhase phase;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // PROFILER_H
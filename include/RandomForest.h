@@ -0,0 +1,61 @@
+#ifndef RANDOM_FOREST_H
+#define RANDOM_FOREST_H
+
+#include "DecisionTree.h"
+#include "CompiledTree.h"
+#include "TreeExporter.h"
+#include "EncodedDataset.h"
+#include <memory>
+
+// Случайный лес над существующими деревьями (ID3Tree, C45Tree, CARTTree,
+// ExtraTree — тогда обычно без бутстрэпа, см. setBootstrap).
+// Все деревья обучаются по одному общему EncodedDataset: бутстрэп-выборка
+// задается кратностями строк, признаки в каждом узле подвыбираются случайно.
+class RandomForest {
+public:
+    using TreeFactory = DecisionTreeFactory;
+
+    explicit RandomForest(TreeFactory factory);
+
+    void setTreeCount(int count) { treeCount = count; }
+    void setMaxFeatures(int count) { maxFeatures = count; }  // 0 — sqrt(числа признаков)
+    void setSeed(std::uint32_t value) { seed = value; }
+    void setThreadCount(unsigned count) { threadCount = count; }  // 0 — все ядра
+    void setBootstrap(bool enabled) { bootstrap = enabled; }      // false — каждое дерево на всех строках
+
+    // Параллельное обучение деревьев
+    void train(const EncodedDataset& data);
+
+    // Голосование всех деревьев за один пакетный проход по строкам
+    std::vector<EncodedDataset::Code> predictBatch(const EncodedDataset& data) const;
+
+    // Доли голосов деревьев за каждый класс: rows × число классов
+    std::vector<double> predictProba(const EncodedDataset& data) const;
+
+    // Предсказание для одного примера (голосование строковых предсказаний)
+    std::string predict(const DataExample& example) const;
+
+    // Доля верных ответов на наборе, закодированном по словарям обучающего
+    double evaluate(const EncodedDataset& testSet) const;
+
+    // Все деревья ансамбля одним файлом за один проход (см. TreeExporter)
+    bool saveToDot(const std::string& filename, const ExportOptions& options = ExportOptions()) const;
+    bool saveToJSON(const std::string& filename, const ExportOptions& options = ExportOptions()) const;
+
+    size_t getTreeCount() const { return trees.size(); }
+    const DecisionTree& getTree(size_t index) const { return *trees[index]; }
+
+private:
+    TreeFactory factory;
+    int treeCount = 100;
+    int maxFeatures = 0;
+    std::uint32_t seed = 42;
+    unsigned threadCount = 0;
+    bool bootstrap = true;
+    size_t classCount = 0;
+
+    std::vector<std::unique_ptr<DecisionTree>> trees;
+    std::vector<CompiledTree> compiledTrees;
+};
+
+#endif // RANDOM_FOREST_H
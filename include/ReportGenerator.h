@@ -2,21 +2,78 @@
 #define REPORT_GENERATOR_H
 
 #include <vector>
+#include <memory>
 #include <string>
 #include <fstream>
 #include "DecisionTree.h"
 #include "Dataset.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include "MemoryUsage.h"
+#include "AllocationCounter.h"
+#include "LatencyBenchmark.h"
+#include "ScalingStudy.h"
+#include "DatasetSummary.h"
+#include "ResultHistory.h"
 
 struct AlgorithmResult {
     std::string algorithmName;
     double accuracy;
-    double precision;
-    double recall;
-    double f1Score;
+    double precision;             // макроусреднение по классам
+    double recall;                // макроусреднение по классам
+    double f1Score;               // макроусреднение по классам
     int treeDepth;
     int nodeCount;
     double trainingTime;
     std::string dotFilePath;
+    std::string svgFilePath;                  // пусто — изображение не построено
+    std::shared_ptr<const TreeNode> treeRoot; // дерево для отрисовки (у ансамблей — первое)
+    
+    // Кросс-валидация: при folds > 1 метрики выше — средние по фолдам,
+    // а здесь — их стандартные отклонения
+    int folds = 1;
+    double accuracyStd = 0.0;
+    double precisionStd = 0.0;
+    double recallStd = 0.0;
+    double f1ScoreStd = 0.0;
+    double trainingTimeStd = 0.0;
+    
+    // Дополнительные метрики по матрице ошибок (NaN — не вычислялись)
+    double microF1 = 0.0;
+    double logLoss = std::numeric_limits<double>::quiet_NaN();
+    double auc = std::numeric_limits<double>::quiet_NaN();     // макроусреднение «один против остальных»
+    std::vector<std::string> classNames;
+    std::vector<ClassMetrics> perClass;
+    
+    // Профиль обучения по фазам (пустой — профилирование не велось)
+    ProfileSnapshot profile;
+    
+    // Память модели по категориям и резидентная память процесса (байты):
+    // до и после обучения и пик процесса после обучения и оценки. RSS —
+    // общий для процесса, поэтому при обучении одновременно с другими
+    // задачами не измеряется (0)
+    MemoryBreakdown modelMemory;
+    size_t residentBeforeTraining = 0;
+    size_t residentAfterTraining = 0;
+    size_t peakResident = 0;
+    
+    // Выделения памяти по фазам (сборка с COUNT_ALLOCATIONS)
+    // и число строк, для которых считались предсказания
+    AllocationSnapshot allocations{};
+    size_t predictedRows = 0;
+    
+    // Распределения задержки предсказания по путям (только одиночные деревья)
+    std::vector<LatencyDistribution> latency;
+};
+
+// Представление строк набора в отчетах: небольшой набор выводится целиком,
+// большой — равномерной выборкой строк и, по желанию, всеми строками
+// постранично в отдельных файлах рядом с отчетом
+struct ReportOptions {
+    size_t inlineRowLimit = 1000;  // набор не больше — все строки в отчете
+    size_t sampleRows = 200;       // иначе — столько строк равномерной выборкой
+    size_t pageRows = 0;           // > 0 — страницы по pageRows строк в <отчет>_rows/
+    unsigned threadCount = 0;      // потоки для статистики и страниц (0 — все ядра)
 };
 
 class ReportGenerator {
@@ -25,7 +82,8 @@ public:
     static void generateFullReport(
         const std::vector<AlgorithmResult>& results,
         const Dataset& dataset,
-        const std::string& filename);
+        const std::string& filename,
+        const ReportOptions& options = ReportOptions());
     
     // Генерация сравнительной таблицы
     static std::string generateComparisonTable(
@@ -34,13 +92,23 @@ public:
     // Генерация секции с описанием алгоритмов
     static std::string generateAlgorithmsDescription();
     
-    // Генерация секции с данными
-    static std::string generateDatasetDescription(const Dataset& dataset);
+    // Генерация секции с данными: сводная статистика по схеме набора
+    static std::string generateDatasetDescription(const DatasetSummary& summary);
+    
+    // Строки набора согласно options (целиком, выборкой, страницами);
+    // reportFilename задает расположение файлов страниц
+    static void writeRowView(std::ostream& out, const Dataset& dataset,
+                             const std::string& reportFilename, const ReportOptions& options);
     
-    // Создание интерактивной HTML страницы
+    // Создание интерактивной HTML страницы (scaling — точки исследования
+    // масштабирования, если оно проводилось; history — записи истории
+    // результатов этого набора для линий тренда по запускам)
     static void createInteractiveReport(
         const std::vector<AlgorithmResult>& results,
         const Dataset& dataset,
-        const std::string& filename);
+        const std::string& filename,
+        const std::vector<ScalingPoint>& scaling = {},
+        const std::vector<HistoryRecord>& history = {},
+        const ReportOptions& options = ReportOptions());
 };
 #endif // REPORT_GENERATOR_H
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef REPORT_SCRIPT_H
+#define REPORT_SCRIPT_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Автономный интерактивный отчет: встроенная библиотека графиков и таблиц
+// (SVG, без внешних зависимостей) и упаковка данных в блоки.
+// Блок — <script type='application/json'>: браузер не разбирает его при
+// открытии страницы, сценарий читает блок только при показе своей секции.
+// Большие числовые столбцы передаются типизированными массивами в base64
+// (порядок байтов — little-endian, как у x86 и ARM).
+class ReportScript {
+public:
+    // Сценарий времени выполнения: объект DT (графики, таблицы, ленивая загрузка)
+    static const char* runtime();
+
+    // Строка JSON в кавычках ("</" экранируется — блок не закроет тег script)
+    static std::string quote(const std::string& text);
+    // Число JSON; NaN и бесконечность — null
+    static std::string number(double value);
+    static std::string numbers(const std::vector<double>& values);
+    static std::string strings(const std::vector<std::string>& values);
+
+    static std::string base64(const void* data, size_t bytes);
+    // Целые столбцы: наименьший из Uint8/Uint16/Uint32 по наибольшему значению,
+    // {"type":"u8","data":"..."}
+    static std::string unsignedArray(const std::vector<std::uint32_t>& values);
+
+    static void writeBlob(std::ostream& out, const std::string& id, const std::string& json);
+};
+
+#endif // REPORT_SCRIPT_H
@@ -0,0 +1,28 @@
+#ifndef REPORT_STREAM_H
+#define REPORT_STREAM_H
+
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Поток вывода отчета в файл с большим буфером: отчет пишется по мере
+// формирования, без сборки всего документа в памяти, а запись на диск
+// идет крупными блоками
+class ReportStream : public std::ostream {
+public:
+    explicit ReportStream(const std::string& filename, size_t bufferSize = size_t(1) << 20);
+    ~ReportStream() override;
+
+    bool is_open() const { return file.is_open(); }
+    void close();
+
+    ReportStream(const ReportStream&) = delete;
+    ReportStream& operator=(const ReportStream&) = delete;
+
+private:
+    std::vector<char> buffer;
+    std::filebuf file;
+};
+
+#endif // REPORT_STREAM_H
@@ -0,0 +1,94 @@
+#ifndef RESULT_HISTORY_H
+#define RESULT_HISTORY_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Запись истории: одна модель запуска сравнения или одно измерение
+// бенчмарка. Время — секунды (среднее, отклонение и число замеров,
+// по которым они посчитаны: фолды кросс-валидации, серии бенчмарка)
+struct HistoryRecord {
+    std::string run;                   // идентификатор запуска: время начала (UTC) и номер процесса
+    std::string revision;              // git describe --always --dirty или DT_REVISION
+    std::string source;                // "comparison" или "benchmark"
+    std::string name;                  // алгоритм или имя измерения
+    std::string dataset;               // отпечаток набора данных (hex)
+    size_t rows = 0;
+    double timeMean = 0.0;
+    double timeStd = 0.0;
+    size_t timeSamples = 1;
+    size_t memoryBytes = 0;            // память модели
+    size_t peakResident = 0;           // пик резидентной памяти процесса (0 — не измерялся)
+    double accuracy = std::numeric_limits<double>::quiet_NaN();
+
+    // Ключ сопоставления записей разных запусков
+    std::string key() const;
+};
+
+struct RegressionOptions {
+    double significance = 0.05;        // порог p-value одностороннего t-теста Уэлча
+    double minSlowdown = 0.05;         // меньшее относительное замедление не считается регрессией
+    double minMemoryGrowth = 0.05;     // то же для памяти модели
+};
+
+// Сравнение одного ключа между базовой и текущей ревизиями
+struct RegressionFinding {
+    std::string source;
+    std::string name;
+    std::string dataset;
+    size_t rows = 0;
+    double baselineTime = 0.0;
+    double currentTime = 0.0;
+    size_t baselineSamples = 0;
+    size_t currentSamples = 0;
+    double timeChange = 0.0;           // относительное: 0.1 — на 10% медленнее
+    double pValue = std::numeric_limits<double>::quiet_NaN();  // NaN — замеров недостаточно для теста
+    size_t baselineMemory = 0;
+    size_t currentMemory = 0;
+    double memoryChange = 0.0;
+    bool slowdown = false;
+    bool memoryGrowth = false;
+};
+
+// Локальная история результатов в JSON lines: запуски дописывают записи,
+// режим сравнения ищет статистически значимые замедления и рост памяти
+// между ревизиями. Записи всех запусков одной ревизии объединяются
+// (повторные запуски увеличивают число замеров).
+class ResultHistory {
+public:
+    explicit ResultHistory(std::string filename);
+
+    const std::string& getFilename() const { return filename; }
+
+    bool append(const std::vector<HistoryRecord>& records) const;
+    // Отсутствующий файл — пустая история; строки, которые не разбираются, пропускаются
+    std::vector<HistoryRecord> load() const;
+
+    static std::string currentRevision();
+    static std::string newRunId();
+
+    // Ревизии в порядке первого появления в истории
+    static std::vector<std::string> revisions(const std::vector<HistoryRecord>& records);
+    // Ревизия по префиксу или идентификатору запуска; "" — не найдена
+    // (при нескольких подходящих — последняя)
+    static std::string findRevision(const std::vector<HistoryRecord>& records, const std::string& selector);
+
+    // Ключи, общие для обеих ревизий
+    static std::vector<RegressionFinding> compare(const std::vector<HistoryRecord>& records,
+                                                  const std::string& baselineRevision,
+                                                  const std::string& currentRevision,
+                                                  const RegressionOptions& options = RegressionOptions());
+
+    // Односторонний t-тест Уэлча по средним, отклонениям и числам замеров:
+    // вероятность получить такое превышение второго среднего над первым
+    // случайно; NaN — меньше двух замеров в одной из выборок
+    static double welchPValue(double mean1, double std1, size_t n1,
+                              double mean2, double std2, size_t n2);
+
+private:
+    std::string filename;
+};
+
+#endif // RESULT_HISTORY_H
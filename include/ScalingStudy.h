@@ -0,0 +1,51 @@
+#ifndef SCALING_STUDY_H
+#define SCALING_STUDY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Точка кривой масштабирования: алгоритм × размер набора × число потоков.
+// Ускорение — относительно наименьшего числа потоков того же алгоритма
+// и размера, эффективность — ускорение, деленное на рост числа потоков.
+struct ScalingPoint {
+    std::string algorithm;
+    size_t rows = 0;
+    unsigned threads = 1;
+    double trainingTime = 0.0;          // секунд, лучшее из повторов
+    double scoringTime = 0.0;
+    double trainingSpeedup = 1.0;
+    double scoringSpeedup = 1.0;
+    double trainingEfficiency = 1.0;
+    double scoringEfficiency = 1.0;
+};
+
+// Исследование масштабирования: обучение и пакетное предсказание каждого
+// алгоритма на синтетических наборах (DataGenerator) при разном числе потоков.
+// Одиночные деревья обучаются последовательно — их кривая обучения показывает
+// отсутствие ускорения; предсказание идет блоками строк через parallelFor.
+class ScalingStudy {
+public:
+    ScalingStudy(std::vector<size_t> sizes, std::vector<unsigned> threadCounts,
+                 std::uint32_t seed = 42);
+
+    void setRepetitions(int count) { repetitions = count < 1 ? 1 : count; }
+    void setEnsembleSize(int count) { ensembleSize = count < 1 ? 1 : count; }
+
+    std::vector<ScalingPoint> run() const;
+
+    // Сохранение точек в CSV
+    static bool saveCSV(const std::vector<ScalingPoint>& points, const std::string& filename);
+
+    // Потоки по умолчанию: 1, 2, 4, ... до числа ядер (минимум 1 и 2)
+    static std::vector<unsigned> defaultThreadCounts();
+
+private:
+    std::vector<size_t> sizes;
+    std::vector<unsigned> threadCounts;
+    std::uint32_t seed;
+    int repetitions = 3;
+    int ensembleSize = 20;
+};
+
+#endif // SCALING_STUDY_H
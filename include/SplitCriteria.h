@@ -0,0 +1,170 @@
+#ifndef SPLIT_CRITERIA_H
+#define SPLIT_CRITERIA_H
+
+#include "DecisionTree.h"
+#include "SplitStatistics.h"
+#include <algorithm>
+#include <limits>
+#include <random>
+
+// Критерии разбиения — политики построителя деревьев (см. TreeBuilder).
+// Критерий оценивает разбиение узла по таблице сопряженности одного
+// признака (многопутевое или бинарное — SplitCandidate::leftValues);
+// генератор нужен только случайным критериям (Extra-Trees). Методы
+// встраиваемые: в шаблонном построителе вызов подставляется прямо в цикл
+// по признакам узла.
+// Счетчики таблицы взвешены кратностями строк, поэтому строка с кратностью w
+// входит в каждый критерий (и в хи-квадрат CHAID) как w одинаковых строк.
+//
+// upperBound — дешевая (без подсчета таблицы) верхняя оценка evaluate для
+// признака с не более чем values значениями в узле; complete — значения
+// признака известны у всех строк узла (тогда распределение классов таблицы
+// совпадает с распределением узла). -inf — разбиение заведомо неприемлемо.
+// Построитель пропускает признаки, оценка которых не превосходит лучшего.
+
+// Запас на погрешность округления: оценка не должна оказаться меньше
+// вычисленного evaluate значения
+inline double relaxBound(double bound) {
+    return bound + 1e-9 * (1.0 + std::fabs(bound));
+}
+
+// ID3: прирост информации (энтропия в битах)
+struct InformationGainCriterion {
+    double minGain = 0.001;        // меньший прирост — разбиение неприемлемо
+
+    double impurity(const double* classCounts, size_t classes, double total) const {
+        return entropyOf(classCounts, classes, total);
+    }
+
+    SplitCandidate evaluate(const ContingencyTable& table, std::mt19937& /*rng*/) const {
+        SplitCandidate candidate;
+        double gain = entropyOf(table.classTotals.data(), table.classes, table.total) - childEntropy(table);
+        if (gain >= minGain) candidate.score = gain;
+        return candidate;
+    }
+
+    // Прирост не больше энтропии классов узла и не больше log2(values)
+    double upperBound(const NodeClasses& node, size_t values, bool complete) const {
+        double classEntropy = complete ? entropyOf(node.counts, node.classes, node.total)
+                                       : std::log2(static_cast<double>(node.observed));
+        double valueEntropy = std::log2(static_cast<double>(std::max<size_t>(values, 1)));
+        double bound = relaxBound(std::min(classEntropy, valueEntropy));
+        return bound < minGain ? -std::numeric_limits<double>::infinity() : bound;
+    }
+
+    // Средневзвешенная энтропия ветвей
+    static double childEntropy(const ContingencyTable& table) {
+        double weighted = 0.0;
+        for (size_t v = 0; v < table.values; ++v) {
+            if (table.valueTotals[v] <= 0.0) continue;
+            weighted += table.valueTotals[v] / table.total *
+                        entropyOf(table.row(v), table.classes, table.valueTotals[v]);
+        }
+        return weighted;
+    }
+};
+
+// C4.5: отношение прироста информации к информации разбиения
+struct GainRatioCriterion {
+    double minRatio = 0.01;        // отношение должно быть строго больше
+
+    double impurity(const double* classCounts, size_t classes, double total) const {
+        return entropyOf(classCounts, classes, total);
+    }
+
+    SplitCandidate evaluate(const ContingencyTable& table, std::mt19937& /*rng*/) const {
+        SplitCandidate candidate;
+        double gain = entropyOf(table.classTotals.data(), table.classes, table.total) -
+                      InformationGainCriterion::childEntropy(table);
+        double splitInformation = entropyOf(table.valueTotals.data(), table.values, table.total);
+        double ratio = splitInformation == 0.0 ? 0.0 : gain / splitInformation;
+        if (ratio > minRatio) candidate.score = ratio;
+        return candidate;
+    }
+
+    // Прирост не больше информации разбиения, поэтому отношение не больше 1;
+    // у признака с одним значением оно равно нулю
+    double upperBound(const NodeClasses& /*node*/, size_t values, bool /*complete*/) const {
+        double bound = relaxBound(values < 2 ? 0.0 : 1.0);
+        return bound <= minRatio ? -std::numeric_limits<double>::infinity() : bound;
+    }
+};
+
+// CART: уменьшение индекса Джини
+struct GiniCriterion {
+    double minDecrease = 0.0;
+
+    double impurity(const double* classCounts, size_t classes, double total) const {
+        return giniOf(classCounts, classes, total);
+    }
+
+    SplitCandidate evaluate(const ContingencyTable& table, std::mt19937& /*rng*/) const {
+        SplitCandidate candidate;
+        double weighted = 0.0;
+        for (size_t v = 0; v < table.values; ++v) {
+            if (table.valueTotals[v] <= 0.0) continue;
+            weighted += table.valueTotals[v] / table.total *
+                        giniOf(table.row(v), table.classes, table.valueTotals[v]);
+        }
+        double gain = giniOf(table.classTotals.data(), table.classes, table.total) - weighted;
+        if (gain >= minDecrease) candidate.score = gain;
+        return candidate;
+    }
+
+    // Уменьшение не больше индекса Джини узла; у признака с одним значением
+    // оно равно нулю
+    double upperBound(const NodeClasses& node, size_t values, bool complete) const {
+        double classGini = complete ? giniOf(node.counts, node.classes, node.total)
+                                    : 1.0 - 1.0 / static_cast<double>(node.observed);
+        double bound = relaxBound(values < 2 ? 0.0 : classGini);
+        return bound < minDecrease ? -std::numeric_limits<double>::infinity() : bound;
+    }
+};
+
+// CHAID: статистика хи-квадрат при значимой связи признака с классом
+// (p-value — упрощенная аппроксимация exp(-χ² / 2df))
+struct ChiSquareCriterion {
+    double significance = 0.05;
+
+    // Неоднородность узла для CHAID не определена
+    double impurity(const double*, size_t, double) const { return 0.0; }
+
+    SplitCandidate evaluate(const ContingencyTable& table, std::mt19937& /*rng*/) const {
+        SplitCandidate candidate;
+
+        // Учитываются только встретившиеся в узле классы и значения
+        size_t observedClasses = 0, observedValues = 0;
+        for (double count : table.classTotals) if (count > 0) observedClasses++;
+        for (double count : table.valueTotals) if (count > 0) observedValues++;
+        if (observedClasses < 2 || observedValues < 2) {
+            return candidate;
+        }
+
+        double chiSquare = 0.0;
+        for (size_t v = 0; v < table.values; ++v) {
+            if (table.valueTotals[v] <= 0.0) continue;
+            for (size_t c = 0; c < table.classes; ++c) {
+                if (table.classTotals[c] <= 0.0) continue;
+                double expected = table.classTotals[c] * table.valueTotals[v] / table.total;
+                double diff = table.at(v, c) - expected;
+                chiSquare += diff * diff / expected;
+            }
+        }
+
+        int degreesOfFreedom = static_cast<int>((observedClasses - 1) * (observedValues - 1));
+        double pValue = std::exp(-chiSquare / (2 * degreesOfFreedom));
+        if (pValue < significance) candidate.score = chiSquare;
+        return candidate;
+    }
+
+    // χ² ≤ N·(min(значений, классов) − 1) (V Крамера не больше 1); значимость
+    // при df ≥ 1 требует χ² > −2·ln(significance)
+    double upperBound(const NodeClasses& node, size_t values, bool /*complete*/) const {
+        size_t levels = std::min(values, node.observed);
+        double bound = relaxBound(node.total * (static_cast<double>(levels) - 1.0));
+        bool reachable = levels >= 2 && bound > -2.0 * std::log(significance);
+        return reachable ? bound : -std::numeric_limits<double>::infinity();
+    }
+};
+
+#endif // SPLIT_CRITERIA_H
@@ -0,0 +1,137 @@
+#ifndef SPLIT_STATISTICS_H
+#define SPLIT_STATISTICS_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+// Таблица сопряженности «значение признака × класс» для одного узла.
+// Все счетчики взвешенные: вес строки — ее кратность в выборке.
+struct ContingencyTable {
+    size_t values = 0;
+    size_t classes = 0;
+    bool ordered = false;              // коды значений упорядочены (числовой признак)
+    std::vector<double> counts;        // values × classes, по строкам значений
+    std::vector<double> valueTotals;   // сумма по каждому значению признака
+    std::vector<double> classTotals;   // сумма по каждому классу
+    double total = 0.0;
+
+    // Подготовка таблицы без лишних перевыделений памяти
+    void reset(size_t valueCount, size_t classCount) {
+        values = valueCount;
+        classes = classCount;
+        counts.assign(valueCount * classCount, 0.0);
+        valueTotals.assign(valueCount, 0.0);
+        classTotals.assign(classCount, 0.0);
+        total = 0.0;
+    }
+
+    double at(size_t value, size_t cls) const { return counts[value * classes + cls]; }
+    
+    // Значений признака, встретившихся в узле
+    size_t observedValues() const {
+        size_t observed = 0;
+        for (double count : valueTotals) if (count > 0.0) observed++;
+        return observed;
+    }
+    const double* row(size_t value) const { return counts.data() + value * classes; }
+
+    // Пересчет итогов после заполнения counts
+    void finalize() {
+        total = 0.0;
+        for (size_t v = 0; v < values; ++v) {
+            double sum = 0.0;
+            for (size_t c = 0; c < classes; ++c) {
+                sum += counts[v * classes + c];
+                classTotals[c] += counts[v * classes + c];
+            }
+            valueTotals[v] = sum;
+            total += sum;
+        }
+    }
+};
+
+// Распределение классов узла — для верхних оценок качества разбиения
+struct NodeClasses {
+    const double* counts = nullptr;
+    size_t classes = 0;
+    double total = 0.0;
+    size_t observed = 0;               // классов, встретившихся в узле
+};
+
+// Сведения о признаке для отсечения кандидатов в поиске разбиения:
+// уточняются в узле, где признак оценивался, и переходят к потомкам
+// (у потомка значений не больше, чем у предка)
+struct FeatureBound {
+    size_t values = 0;                 // значений, встречающихся в узле, не больше
+    bool complete = false;             // значение признака известно у всех строк узла
+};
+
+// Поиск лучшего признака методом ветвей и границ. bound(f) — верхняя оценка
+// признака без подсчета таблицы (-inf — признак заведомо не подходит),
+// evaluate(f) — точная оценка, accept(f) вызывается, когда f становится
+// лучшим. Признаки перебираются по убыванию оценки (при равенстве — в порядке
+// candidates); признак, чья оценка меньше лучшего результата (или равна ему
+// при большем номере), не считается. Выбор тот же, что при полном переборе
+// по возрастанию номеров со строгим сравнением: наибольшая оценка, при
+// равенстве — меньший номер. Возвращает номер признака или SIZE_MAX.
+template <typename Bound, typename Evaluate, typename Accept>
+size_t boundedSearch(const std::vector<size_t>& candidates, Bound bound, Evaluate evaluate, Accept accept) {
+    const size_t none = static_cast<size_t>(-1);
+    const double inadmissible = -std::numeric_limits<double>::infinity();
+    std::vector<std::pair<double, size_t>> order;
+    order.reserve(candidates.size());
+    for (size_t feature : candidates) {
+        double limit = bound(feature);
+        if (limit > inadmissible) order.emplace_back(limit, feature);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const std::pair<double, size_t>& a, const std::pair<double, size_t>& b) {
+                         return a.first > b.first;
+                     });
+    
+    size_t best = none;
+    double bestScore = inadmissible;
+    for (const auto& [limit, feature] : order) {
+        if (best != none) {
+            if (limit < bestScore) break;          // дальше оценки только меньше
+            if (limit == bestScore && feature > best) continue;
+        }
+        double score = evaluate(feature);
+        if (score > bestScore || (best != none && score == bestScore && feature < best)) {
+            bestScore = score;
+            best = feature;
+            accept(feature);
+        }
+    }
+    return best;
+}
+
+// Энтропия распределения классов (в битах)
+inline double entropyOf(const double* classCounts, size_t classes, double total) {
+    if (total <= 0.0) return 0.0;
+    double result = 0.0;
+    for (size_t c = 0; c < classes; ++c) {
+        if (classCounts[c] > 0.0) {
+            double p = classCounts[c] / total;
+            result -= p * std::log2(p);
+        }
+    }
+    return result;
+}
+
+// Индекс Джини распределения классов
+inline double giniOf(const double* classCounts, size_t classes, double total) {
+    if (total <= 0.0) return 0.0;
+    double result = 1.0;
+    for (size_t c = 0; c < classes; ++c) {
+        double p = classCounts[c] / total;
+        result -= p * p;
+    }
+    return result;
+}
+
+#endif // SPLIT_STATISTICS_H
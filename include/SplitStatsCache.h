@@ -0,0 +1,65 @@
+#ifndef SPLIT_STATS_CACHE_H
+#define SPLIT_STATS_CACHE_H
+
+#include "EncodedDataset.h"
+#include "SplitStatistics.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+
+// Общий кэш таблиц сопряженности узлов для серии обучений на одном наборе
+// с одними весами строк (например, перебор гиперпараметров на одном фолде).
+// Строки узла однозначно определяются путем разбиений от корня, поэтому
+// ключ — закодированный путь и номер признака: деревья разных конфигураций
+// с общим префиксом берут статистику из кэша вместо подсчета по строкам.
+// Кэш привязан к набору и весам через отпечаток контекста и потокобезопасен.
+class SplitStatsCache {
+public:
+    using Table = std::shared_ptr<const ContingencyTable>;
+    // Псевдопризнак для распределения классов узла (таблица из одной строки)
+    static constexpr size_t kClassDistribution = 0xffffffffu;
+
+    SplitStatsCache(const EncodedDataset& data,
+                    const std::vector<std::uint32_t>& rowWeights,
+                    size_t maxEntries = 1 << 20);
+
+    // Узлы с меньшим числом строк считаются напрямую: подсчет по ним
+    // дешевле поиска в кэше, а таких узлов в глубоких деревьях большинство
+    void setMinNodeRows(size_t rows) { minNodeRows = rows; }
+    size_t getMinNodeRows() const { return minNodeRows; }
+
+    // Кэш построен для этого набора и этих весов
+    bool matches(const EncodedDataset& data, const std::vector<std::uint32_t>& rowWeights) const;
+
+    // nullptr — таблицы нет в кэше
+    Table find(const std::string& path, size_t feature) const;
+    // При исчерпании лимита записей новые таблицы не сохраняются
+    void insert(const std::string& path, size_t feature, const ContingencyTable& table);
+
+    size_t getHitCount() const { return hits.load(); }
+    size_t getMissCount() const { return misses.load(); }
+    size_t getEntryCount() const;
+
+    // Дописывание шага пути: код признака/значения фиксированной ширины
+    static void appendCode(std::string& path, std::uint32_t code);
+
+private:
+    const EncodedDataset* data;
+    std::uint64_t contextFingerprint;
+    size_t maxEntries;
+    size_t minNodeRows = 512;
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, Table> tables;
+    mutable std::atomic<size_t> hits{0};
+    mutable std::atomic<size_t> misses{0};
+
+    static std::uint64_t fingerprint(const EncodedDataset& data,
+                                     const std::vector<std::uint32_t>& rowWeights);
+    static std::string makeKey(const std::string& path, size_t feature);
+};
+
+#endif // SPLIT_STATS_CACHE_H
@@ -0,0 +1,492 @@
+#ifndef TREE_BUILDER_H
+#define TREE_BUILDER_H
+
+#include "DecisionTree.h"
+#include "SplitCriteria.h"
+#include "SplitStatsCache.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <map>
+#include <random>
+
+// Остановка роста по StoppingRule: узел становится листом, если он однороден,
+// признаки исчерпаны, достигнута наибольшая глубина или узел меньше
+// minParentSize; потомок меньше minChildSize — лист с классом родителя
+struct RuleStopping {
+    StoppingRule rule;
+
+    bool stopAt(double size, size_t nonEmptyClasses, size_t availableFeatures, int depth) const {
+        return nonEmptyClasses <= 1 || availableFeatures == 0 || depth >= rule.maxDepth ||
+               size < rule.minParentSize;
+    }
+    bool stopChild(double size) const { return size < rule.minChildSize; }
+};
+
+// Лист с классом большинства; уверенность — доля этого класса в узле
+struct MajorityLeaf {
+    void fill(TreeNode& leaf, const std::string& decision, double majorityCount, double total) const {
+        leaf.isLeaf = true;
+        leaf.decision = decision;
+        leaf.samples = static_cast<int>(total);
+        leaf.confidence = total > 0.0 ? majorityCount / total : 1.0;
+    }
+};
+
+// Построение дерева по закодированным данным — единственный построитель
+// всех деревьев: строковое обучение кодирует примеры в EncodedDataset
+// и строит тем же кодом. Критерий, остановка и лист — политики времени
+// компиляции: оценка разбиения подставляется в цикл по признакам узла без
+// виртуальных вызовов. Строки узла — отрезок общего массива индексов,
+// который переупорядочивается на месте при разбиении, поэтому ни строки,
+// ни подвыборки не копируются; счетчики взвешены кратностями строк.
+// Признаки узла перебираются методом ветвей и границ (boundedSearch) по
+// верхним оценкам критерия; число значений признака, встреченных в узле,
+// переходит к потомкам, так что постоянные в узле признаки не считаются.
+// Разбиение с непустым leftValues — бинарное (признак остается потомкам),
+// иначе — ветвь на каждое значение (признак исчерпывается).
+template <typename Criterion, typename Stopping = RuleStopping, typename Leaf = MajorityLeaf>
+class TreeBuilder {
+public:
+    TreeBuilder(const Criterion& criterion, const Stopping& stopping, const Leaf& leaf = Leaf())
+        : criterion(criterion), stopping(stopping), leaf(leaf) {}
+
+    // rowWeights — кратности строк (пусто — кратности самого набора, 0 — строка
+    // не участвует); depth — глубина корня, если строится поддерево
+    std::shared_ptr<TreeNode> build(const EncodedDataset& dataset,
+                                     const std::vector<std::uint32_t>& rowWeights = {},
+                                     const EncodedTrainOptions& trainOptions = {},
+                                     int depth = 0) {
+        start(dataset, rowWeights, trainOptions);
+        rootDepth = depth;
+        return buildNode(0, rows.size(), allFeatures(), depth, std::string());
+    }
+
+    // Лучший признак для всех строк: имя и оценка ("" — разбиение неприемлемо)
+    std::pair<std::string, double> findBestSplit(const EncodedDataset& dataset) {
+        start(dataset, {}, {});
+        if (rows.empty() || dataset.getFeatureCount() == 0) return {"", 0.0};
+        std::vector<double> classCounts = countClasses(0, rows.size());
+        NodeClasses node = describe(classCounts);
+        std::vector<FeatureBound> bounds = rootBounds;
+        SplitCandidate best;
+        ContingencyTable bestTable;
+        size_t feature = bestFeature(0, rows.size(), allFeatures(), node, bounds, std::string(),
+                                     best, bestTable);
+        if (feature == kNoFeature) return {"", 0.0};
+        return {dataset.getFeatureNames()[feature], best.score};
+    }
+
+private:
+    static constexpr size_t kNoFeature = static_cast<size_t>(-1);
+
+    Criterion criterion;
+    Stopping stopping;
+    Leaf leaf;
+
+    const EncodedDataset* data = nullptr;
+    const std::uint32_t* weights = nullptr;
+    EncodedTrainOptions options;
+    std::mt19937 rng;
+    SplitStatsCache* cache = nullptr;
+    std::vector<std::uint32_t> rows;
+    std::vector<std::uint32_t> scratch;
+
+    // Сведения о признаках по уровням текущего пути от корня: узел глубины d
+    // начинает с копии уровня d - 1 (своего родителя) и уточняет ее
+    std::vector<FeatureBound> rootBounds;
+    std::vector<std::vector<FeatureBound>> levels;
+    int rootDepth = 0;
+
+    void start(const EncodedDataset& dataset, const std::vector<std::uint32_t>& rowWeights,
+               const EncodedTrainOptions& trainOptions) {
+        data = &dataset;
+        const auto& ownWeights = dataset.getWeights();
+        weights = !rowWeights.empty() ? rowWeights.data() : ownWeights.empty() ? nullptr : ownWeights.data();
+        options = trainOptions;
+        rng.seed(trainOptions.seed);
+        cache = trainOptions.cache && trainOptions.cache->matches(dataset, rowWeights) ? trainOptions.cache : nullptr;
+
+        // Строки с нулевой кратностью или неизвестным классом не участвуют
+        size_t rowCount = dataset.getRowCount();
+        const auto& targets = dataset.getTargets();
+        rows.clear();
+        rows.reserve(rowCount);
+        for (size_t i = 0; i < rowCount; ++i) {
+            if ((!weights || weights[i] > 0) && targets[i] != EncodedDataset::kMissing) {
+                rows.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        scratch.resize(rows.size());
+
+        // В корне известен только размер словаря; пропуски значений возможны
+        rootBounds.assign(dataset.getFeatureCount(), FeatureBound());
+        for (size_t f = 0; f < rootBounds.size(); ++f) rootBounds[f].values = dataset.getCardinality(f);
+        levels.clear();
+    }
+
+    std::vector<size_t> allFeatures() const {
+        std::vector<size_t> available(data->getFeatureCount());
+        for (size_t f = 0; f < available.size(); ++f) available[f] = f;
+        return available;
+    }
+
+    double weightOf(std::uint32_t row) const { return weights ? weights[row] : 1.0; }
+
+    void countTable(size_t begin, size_t end, size_t feature, ContingencyTable& table) const {
+        ProfileScope scope(ProfilePhase::Counting);
+        const EncodedDataset::Code* column = data->getColumn(feature).data();
+        const EncodedDataset::Code* targets = data->getTargets().data();
+        size_t classes = data->getClassCount();
+        table.reset(data->getCardinality(feature), classes);
+        table.ordered = data->isNumeric(feature);
+        for (size_t i = begin; i < end; ++i) {
+            std::uint32_t row = rows[i];
+            EncodedDataset::Code value = column[row];
+            if (value == EncodedDataset::kMissing) continue;
+            table.counts[value * classes + targets[row]] += weightOf(row);
+        }
+        table.finalize();
+    }
+
+    // Взвешенное распределение классов по строкам [begin, end)
+    std::vector<double> countClasses(size_t begin, size_t end) const {
+        ProfileScope scope(ProfilePhase::Counting);
+        std::vector<double> counts(data->getClassCount(), 0.0);
+        const EncodedDataset::Code* targets = data->getTargets().data();
+        for (size_t i = begin; i < end; ++i) counts[targets[rows[i]]] += weightOf(rows[i]);
+        return counts;
+    }
+
+    // Распределение классов узла через кэш (если он подключен)
+    std::vector<double> nodeClassCounts(size_t begin, size_t end, const std::string& path) const {
+        if (!usesCache(begin, end)) return countClasses(begin, end);
+        auto cached = cache->find(path, SplitStatsCache::kClassDistribution);
+        if (cached) return cached->counts;
+
+        ContingencyTable distribution;
+        distribution.reset(1, data->getClassCount());
+        distribution.counts = countClasses(begin, end);
+        distribution.finalize();
+        cache->insert(path, SplitStatsCache::kClassDistribution, distribution);
+        return distribution.counts;
+    }
+
+    static NodeClasses describe(const std::vector<double>& classCounts) {
+        NodeClasses node;
+        node.counts = classCounts.data();
+        node.classes = classCounts.size();
+        for (double count : classCounts) {
+            node.total += count;
+            if (count > 0.0) node.observed++;
+        }
+        return node;
+    }
+
+    // Кандидаты: все доступные признаки или случайное подмножество из maxFeatures
+    std::vector<size_t> sampleFeatures(const std::vector<size_t>& available) {
+        std::vector<size_t> candidates = available;
+        size_t limit = static_cast<size_t>(options.maxFeatures);
+        if (limit > 0 && limit < candidates.size()) {
+            for (size_t i = 0; i < limit; ++i) {
+                std::uniform_int_distribution<size_t> pick(i, candidates.size() - 1);
+                std::swap(candidates[i], candidates[pick(rng)]);
+            }
+            candidates.resize(limit);
+            std::sort(candidates.begin(), candidates.end());
+        }
+        return candidates;
+    }
+
+    // Число строк узла определяется путем, поэтому решение одинаково
+    // для всех деревьев, разделяющих кэш
+    bool usesCache(size_t begin, size_t end) const {
+        return cache && end - begin >= cache->getMinNodeRows();
+    }
+
+    // Путь потомка для ключа кэша: многопутевое разбиение — признак и значение,
+    // бинарное — помеченный признак, маска левых значений и сторона
+    std::string multiwayPath(const std::string& path, size_t feature, size_t value) const {
+        if (!cache) return std::string();
+        std::string child = path;
+        SplitStatsCache::appendCode(child, static_cast<std::uint32_t>(feature));
+        SplitStatsCache::appendCode(child, static_cast<std::uint32_t>(value));
+        return child;
+    }
+
+    std::string binaryPath(const std::string& path, size_t feature, const std::vector<bool>& leftValues,
+                           bool left) const {
+        if (!cache) return std::string();
+        std::string child = path;
+        SplitStatsCache::appendCode(child, static_cast<std::uint32_t>(feature) | 0x80000000u);
+        for (size_t word = 0; word < leftValues.size(); word += 32) {
+            std::uint32_t bits = 0;
+            for (size_t v = word; v < std::min(word + 32, leftValues.size()); ++v) {
+                if (leftValues[v]) bits |= 1u << (v - word);
+            }
+            SplitStatsCache::appendCode(child, bits);
+        }
+        SplitStatsCache::appendCode(child, left ? 1u : 0u);
+        return child;
+    }
+
+    // Лучший признак (наибольшая оценка, при равенстве — первый);
+    // kNoFeature — ни один не подходит. bounds уточняются по посчитанным таблицам
+    size_t bestFeature(size_t begin, size_t end, const std::vector<size_t>& candidates,
+                       const NodeClasses& node, std::vector<FeatureBound>& bounds,
+                       const std::string& path, SplitCandidate& best, ContingencyTable& bestTable) {
+        ProfileScope search(ProfilePhase::SplitSearch);
+        ContingencyTable table;
+        SplitCandidate candidate;
+        SplitStatsCache::Table cached;
+        bool nodeCached = usesCache(begin, end);
+        size_t result = boundedSearch(candidates,
+            [&](size_t feature) {
+                return criterion.upperBound(node, bounds[feature].values, bounds[feature].complete);
+            },
+            [&](size_t feature) {
+                // Таблица из кэша, если узел с тем же путем уже считался
+                cached = nodeCached ? cache->find(path, feature) : nullptr;
+                if (!cached) {
+                    countTable(begin, end, feature, table);
+                    if (nodeCached) cache->insert(path, feature, table);
+                }
+                const ContingencyTable& current = cached ? *cached : table;
+                bounds[feature].values = current.observedValues();
+                bounds[feature].complete = current.total == node.total;
+                ProfileScope impurity(ProfilePhase::Impurity);
+                candidate = criterion.evaluate(current, rng);
+                return candidate.score;
+            },
+            [&](size_t) {
+                best = std::move(candidate);
+                if (cached) {
+                    bestTable = *cached;
+                } else {
+                    std::swap(table, bestTable);
+                }
+            });
+        return result == static_cast<size_t>(-1) ? kNoFeature : result;
+    }
+
+    std::shared_ptr<TreeNode> makeLeaf(const std::string& decision, double majorityCount, double total,
+                                       std::vector<double> classCounts = {}) const {
+        ProfileScope scope(ProfilePhase::NodeAllocation);
+        auto node = std::make_shared<TreeNode>();
+        leaf.fill(*node, decision, majorityCount, total);
+        node->classCounts = std::move(classCounts);
+        return node;
+    }
+
+    std::shared_ptr<TreeNode> buildNode(size_t begin, size_t end, const std::vector<size_t>& available,
+                                        int depth, const std::string& path) {
+        Profiler::addNode(depth);
+        if (begin == end) {
+            return makeLeaf("Unknown", 0.0, 0.0);
+        }
+
+        // Распределение классов и класс большинства (первый по порядку при равенстве)
+        std::vector<double> classCounts = nodeClassCounts(begin, end, path);
+        NodeClasses classes = describe(classCounts);
+        double total = classes.total;
+        size_t majority = 0;
+        for (size_t c = 0; c < classCounts.size(); ++c) {
+            if (classCounts[c] > classCounts[majority]) majority = c;
+        }
+        const std::string& majorityClass = data->getClassNames()[majority];
+        double majorityCount = classCounts[majority];
+
+        if (stopping.stopAt(total, classes.observed, available.size(), depth)) {
+            return makeLeaf(majorityClass, majorityCount, total, std::move(classCounts));
+        }
+
+        size_t level = static_cast<size_t>(depth - rootDepth);
+        if (levels.size() <= level) levels.resize(level + 1);
+        levels[level] = level == 0 ? rootBounds : levels[level - 1];
+
+        SplitCandidate best;
+        ContingencyTable bestTable;
+        size_t feature = bestFeature(begin, end, sampleFeatures(available), classes, levels[level], path,
+                                     best, bestTable);
+        if (feature == kNoFeature) {
+            return makeLeaf(majorityClass, majorityCount, total, std::move(classCounts));
+        }
+
+        // Внутренний узел хранит класс большинства и распределение классов:
+        // по ним дерево можно усечь на любой глубине без переобучения
+        std::shared_ptr<TreeNode> node;
+        {
+            ProfileScope scope(ProfilePhase::NodeAllocation);
+            node = std::make_shared<TreeNode>();
+        }
+        node->isLeaf = false;
+        node->feature = data->getFeatureNames()[feature];
+        node->samples = static_cast<int>(total);
+        node->decision = majorityClass;
+        node->confidence = majorityCount / total;
+        node->classCounts = std::move(classCounts);
+
+        if (!best.leftValues.empty()) {
+            splitBinary(*node, begin, end, feature, best.leftValues, bestTable, available, depth,
+                        majorityClass, path);
+        } else {
+            splitMultiway(*node, begin, end, feature, bestTable, available, depth, majorityClass, path);
+        }
+        return node;
+    }
+
+    std::shared_ptr<TreeNode> buildChild(size_t begin, size_t end, double size,
+                                         const std::vector<size_t>& available, int depth,
+                                         const std::string& parentMajority, const std::string& path) {
+        if (stopping.stopChild(size)) {
+            return makeLeaf(parentMajority, size, size, countClasses(begin, end));
+        }
+        return buildNode(begin, end, available, depth, path);
+    }
+
+    // Разбиение на две ветви; признак остается доступным для потомков
+    void splitBinary(TreeNode& node, size_t begin, size_t end, size_t feature,
+                     const std::vector<bool>& leftValues, const ContingencyTable& table,
+                     const std::vector<size_t>& available, int depth,
+                     const std::string& majorityClass, const std::string& path) {
+        const EncodedDataset::Code* column = data->getColumn(feature).data();
+        auto isLeft = [&](std::uint32_t row) {
+            EncodedDataset::Code value = column[row];
+            return value != EncodedDataset::kMissing && leftValues[value];
+        };
+        size_t middle;
+        {
+            ProfileScope scope(ProfilePhase::Partition);
+            middle = std::partition(rows.begin() + begin, rows.begin() + end, isLeft) - rows.begin();
+        }
+
+        double leftSize = 0.0;
+        for (size_t v = 0; v < table.values; ++v) {
+            if (leftValues[v]) leftSize += table.valueTotals[v];
+        }
+
+        auto left = buildChild(begin, middle, leftSize, available, depth + 1, majorityClass,
+                               binaryPath(path, feature, leftValues, true));
+        auto right = buildChild(middle, end, table.total - leftSize, available, depth + 1, majorityClass,
+                                binaryPath(path, feature, leftValues, false));
+
+        const auto& valueNames = data->getValueNames(feature);
+        for (size_t v = 0; v < valueNames.size(); ++v) {
+            node.children[valueNames[v]] = leftValues[v] ? left : right;
+        }
+    }
+
+    // Разбиение на ветвь для каждого значения; признак исчерпывается
+    void splitMultiway(TreeNode& node, size_t begin, size_t end, size_t feature,
+                       const ContingencyTable& table, const std::vector<size_t>& available, int depth,
+                       const std::string& majorityClass, const std::string& path) {
+        // Сортировка строк подсчетом по значению через буфер; строки
+        // с пропущенным значением ни в одну ветвь не попадают
+        const EncodedDataset::Code* column = data->getColumn(feature).data();
+        size_t valueCount = data->getCardinality(feature);
+        std::vector<size_t> offsets(valueCount + 1, 0);
+        {
+            ProfileScope scope(ProfilePhase::Partition);
+            for (size_t i = begin; i < end; ++i) {
+                EncodedDataset::Code value = column[rows[i]];
+                if (value != EncodedDataset::kMissing) offsets[value + 1]++;
+            }
+            for (size_t v = 0; v < valueCount; ++v) offsets[v + 1] += offsets[v];
+            size_t assigned = offsets[valueCount];
+            std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = begin; i < end; ++i) {
+                EncodedDataset::Code value = column[rows[i]];
+                if (value != EncodedDataset::kMissing) scratch[begin + cursor[value]++] = rows[i];
+            }
+            std::copy(scratch.begin() + begin, scratch.begin() + begin + assigned, rows.begin() + begin);
+        }
+
+        std::vector<size_t> childFeatures;
+        childFeatures.reserve(available.size());
+        for (size_t other : available) {
+            if (other != feature) childFeatures.push_back(other);
+        }
+
+        const auto& valueNames = data->getValueNames(feature);
+        for (size_t v = 0; v < valueCount; ++v) {
+            size_t childBegin = begin + offsets[v];
+            size_t childEnd = begin + offsets[v + 1];
+            if (childBegin == childEnd) continue;
+            node.children[valueNames[v]] = buildChild(childBegin, childEnd, table.valueTotals[v],
+                                                      childFeatures, depth + 1, majorityClass,
+                                                      multiwayPath(path, feature, v));
+        }
+    }
+};
+
+// Основа деревьев: обучение по закодированным данным и по строковым примерам
+// (они кодируются в EncodedDataset) идет через один TreeBuilder с критерием
+// и ограничениями роста наследника. Наследники задают критерий и значения
+// параметров по умолчанию.
+template <typename Criterion, typename Stopping = RuleStopping, typename Leaf = MajorityLeaf>
+class BasicDecisionTree : public DecisionTree {
+protected:
+    Criterion criterion;
+    Stopping stopping;
+    Leaf leaf;
+    // Параметры строкового обучения (зерно случайного критерия)
+    EncodedTrainOptions trainOptions;
+
+    TreeBuilder<Criterion, Stopping, Leaf> makeBuilder() const {
+        return TreeBuilder<Criterion, Stopping, Leaf>(criterion, stopping, leaf);
+    }
+
+    double calculateImpurity(const std::vector<DataExample>& examples) const override {
+        std::map<std::string, double> counts;
+        double total = 0.0;
+        for (const auto& example : examples) {
+            if (example.weight <= 0) continue;
+            counts[example.target] += example.weight;
+            total += example.weight;
+        }
+        std::vector<double> classCounts;
+        for (const auto& entry : counts) classCounts.push_back(entry.second);
+        return criterion.impurity(classCounts.data(), classCounts.size(), total);
+    }
+
+    std::pair<std::string, double> findBestSplit(
+        const std::vector<DataExample>& examples,
+        const std::vector<std::string>& availableFeatures) const override {
+        return makeBuilder().findBestSplit(EncodedDataset(examples, availableFeatures));
+    }
+
+    std::shared_ptr<TreeNode> buildTreeRecursive(
+        const std::vector<DataExample>& examples,
+        const std::vector<std::string>& availableFeatures,
+        int depth) override {
+        return makeBuilder().build(EncodedDataset(examples, availableFeatures), {}, trainOptions, depth);
+    }
+
+    std::shared_ptr<TreeNode> buildEncoded(const EncodedDataset& data,
+                                           const std::vector<std::uint32_t>& rowWeights,
+                                           const EncodedTrainOptions& options) const override {
+        return makeBuilder().build(data, rowWeights, options);
+    }
+
+public:
+    void train(const Dataset& dataset) override {
+        features = dataset.getFeatureNames();
+        targetName = dataset.getTargetName();
+        root = makeBuilder().build(EncodedDataset(dataset), {}, trainOptions);
+    }
+
+    std::string predict(const DataExample& example) const override {
+        const TreeNode* node = root.get();
+        while (node && !node->isLeaf) {
+            auto child = node->children.find(example.features.at(node->feature));
+            if (child == node->children.end()) {
+                return "Unknown";  // значение не встречалось при обучении
+            }
+            node = child->second.get();
+        }
+        return node ? node->decision : "Unknown";
+    }
+
+    void setMaxDepth(int depth) { stopping.rule.maxDepth = depth; }
+};
+
+#endif // TREE_BUILDER_H
@@ -0,0 +1,69 @@
+#ifndef TREE_EXPORTER_H
+#define TREE_EXPORTER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "DecisionTree.h"
+
+struct ExportOptions {
+    int maxDepth = -1;            // глубже — узел выводится свернутым (-1 — без ограничения)
+    int minSamples = 0;           // внутренний узел с меньшим числом примеров сворачивается
+    size_t bufferSize = size_t(1) << 20;  // порог сброса буфера в файл
+};
+
+// Экспорт деревьев в DOT и JSON за один прямой (preorder) обход:
+// идентификаторы узлов — сквозной счетчик, без словаря узлов и второго
+// прохода; текст собирается в большом буфере, который переиспользуется
+// между вызовами и сбрасывается в файл крупными блоками.
+// Экземпляр не потокобезопасен — по одному на поток.
+class TreeExporter {
+public:
+    explicit TreeExporter(ExportOptions options = ExportOptions());
+
+    // Несколько корней — ансамбль: в DOT каждое дерево в своем кластере,
+    // в JSON у узла есть номер дерева
+    bool writeDot(const TreeNode* root, const std::string& filename);
+    bool writeDot(const std::vector<const TreeNode*>& roots, const std::string& filename);
+
+    // JSON — плоский список узлов в прямом порядке со ссылкой на родителя
+    bool writeJSON(const TreeNode* root, const std::string& filename);
+    bool writeJSON(const std::vector<const TreeNode*>& roots, const std::string& filename);
+
+    size_t getWrittenNodes() const { return writtenNodes; }  // за последний вызов
+
+    void setOptions(const ExportOptions& value) { options = value; }
+
+private:
+    // Кадр обхода: узел, его родитель (для метки ребра) и номер родителя
+    struct Frame {
+        const TreeNode* node;
+        const TreeNode* parent;
+        long long parentId;
+        int depth;
+    };
+
+    ExportOptions options;
+    std::string buffer;
+    std::vector<Frame> stack;
+    std::ofstream file;
+    size_t writtenNodes = 0;
+
+    bool open(const std::string& filename);
+    bool finish();
+    void flushIfFull();
+
+    bool isCollapsed(const TreeNode& node, int depth) const;
+    void pushChildren(const TreeNode& node, long long id, int depth);
+
+    void append(const char* text) { buffer += text; }
+    void append(const std::string& text) { buffer += text; }
+    void appendNumber(long long value);
+    void appendNumber(double value, int precision = -1);  // -1 — кратчайшая точная запись
+    void appendDotEscaped(const std::string& text);
+    void appendJSONEscaped(const std::string& text);
+    // Метка ребра: все значения родителя, ведущие к этому потомку
+    void appendEdgeLabel(const TreeNode& parent, const TreeNode* child, bool json);
+};
+
+#endif // TREE_EXPORTER_H
@@ -0,0 +1,41 @@
+#ifndef TREE_RENDERER_H
+#define TREE_RENDERER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "DecisionTree.h"
+
+struct RenderOptions {
+    int maxDepth = -1;             // глубже — поддерево свернуто в один узел (-1 — без ограничения)
+    double nodeWidth = 150.0;
+    double nodeHeight = 48.0;
+    double siblingGap = 20.0;      // наименьший зазор между соседними узлами
+    double levelGap = 80.0;        // между уровнями
+    double margin = 20.0;
+};
+
+// Задание на отрисовку: корень дерева (держит узлы живыми) и файл SVG
+struct RenderJob {
+    std::shared_ptr<const TreeNode> root;
+    std::string filename;
+};
+
+// Отрисовка дерева в SVG без внешних программ. Раскладка — аккуратное
+// дерево Рейнгольда–Тилфорда в линейной версии Бухгейма (Walker с
+// потоками и отложенными сдвигами): родитель по центру над потомками,
+// поддеревья сдвинуты вплотную без пересечений.
+class TreeRenderer {
+public:
+    explicit TreeRenderer(RenderOptions options = RenderOptions());
+
+    bool renderSVG(const TreeNode* root, const std::string& filename) const;
+
+    // Параллельная отрисовка нескольких деревьев; число успешно записанных
+    size_t renderAll(const std::vector<RenderJob>& jobs, unsigned threadCount = 0) const;
+
+private:
+    RenderOptions options;
+};
+
+#endif // TREE_RENDERER_H
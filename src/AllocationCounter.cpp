@@ -0,0 +1,98 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<size_t> currentPhase{static_cast<size_t>(AllocationPhase::Other)};
+std::array<std::atomic<std::uint64_t>, kAllocationPhaseCount> allocationCounts{};
+std::array<std::atomic<std::uint64_t>, kAllocationPhaseCount> allocationBytes{};
+
+#ifdef DT_COUNT_ALLOCATIONS
+void* countedAllocate(std::size_t size) {
+    size_t phase = currentPhase.load(std::memory_order_relaxed);
+    allocationCounts[phase].fetch_add(1, std::memory_order_relaxed);
+    allocationBytes[phase].fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+#endif
+
+} // namespace
+
+AllocationSnapshot AllocationCounter::snapshot() {
+    AllocationSnapshot result;
+    for (size_t p = 0; p < kAllocationPhaseCount; ++p) {
+        result[p].count = allocationCounts[p].load(std::memory_order_relaxed);
+        result[p].bytes = allocationBytes[p].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+AllocationStats AllocationCounter::total() {
+    AllocationStats result;
+    for (const auto& stats : snapshot()) {
+        result.count += stats.count;
+        result.bytes += stats.bytes;
+    }
+    return result;
+}
+
+AllocationSnapshot AllocationCounter::difference(const AllocationSnapshot& after,
+                                                 const AllocationSnapshot& before) {
+    AllocationSnapshot result;
+    for (size_t p = 0; p < kAllocationPhaseCount; ++p) {
+        result[p].count = after[p].count - before[p].count;
+        result[p].bytes = after[p].bytes - before[p].bytes;
+    }
+    return result;
+}
+
+AllocationPhase AllocationCounter::getPhase() {
+    return static_cast<AllocationPhase>(currentPhase.load(std::memory_order_relaxed));
+}
+
+void AllocationCounter::setPhase(AllocationPhase phase) {
+    currentPhase.store(static_cast<size_t>(phase), std::memory_order_relaxed);
+}
+
+const char* AllocationCounter::phaseName(AllocationPhase phase) {
+    switch (phase) {
+        case AllocationPhase::Other: return "Прочее";
+        case AllocationPhase::Train: return "Обучение";
+        case AllocationPhase::Predict: return "Предсказание";
+        case AllocationPhase::Evaluate: return "Метрики";
+        case AllocationPhase::Export: return "Экспорт DOT";
+    }
+    return "";
+}
+
+#ifdef DT_COUNT_ALLOCATIONS
+
+// Замена глобальных операторов: подсчет и выделение через malloc
+void* operator new(std::size_t size) {
+    if (void* pointer = countedAllocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* pointer = countedAllocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+#endif // DT_COUNT_ALLOCATIONS
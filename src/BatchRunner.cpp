@@ -0,0 +1,483 @@
+#include "BatchRunner.h"
+#include "CompiledTree.h"
+#include "DataGenerator.h"
+#include "ExtraTree.h"
+#include "GradientBoosting.h"
+#include "HyperparameterSearch.h"
+#include "MemoryUsage.h"
+#include "Metrics.h"
+#include "Parallel.h"
+#include "Profiler.h"
+#include "RandomForest.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// Строковое представление наборов, загруженных сразу в кодах, нужно только
+// отчету: равномерная выборка строк (строка Dataset — словарь признаков,
+// в десятки раз больше строки кодов)
+const size_t kReportRows = 10000;
+
+// Загруженный набор: коды для обучения и строковый набор для отчета
+struct LoadedDataset {
+    EncodedDataset data;
+    Dataset rows;
+    size_t bytes = 0;
+};
+
+// Состояние набора в планировщике
+struct DatasetSlot {
+    enum class State { Unloaded, Loading, Ready, Failed, Released };
+    State state = State::Unloaded;
+    std::shared_ptr<LoadedDataset> loaded;
+    size_t reservedBytes = 0;          // оценка при загрузке, затем фактический объем
+    size_t remainingJobs = 0;
+    std::string error;
+};
+
+std::string jsonEscape(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '"' || c == '\\') result += '\\';
+        if (c == '\n') result += "\\n";
+        else result += c;
+    }
+    return result;
+}
+
+std::string jsonNumber(double value) {
+    if (!std::isfinite(value)) return "null";
+    std::ostringstream out;
+    out << std::setprecision(10) << value;
+    return out.str();
+}
+
+// Имена столбцов первой строки CSV
+std::vector<std::string> readHeader(const std::string& path) {
+    std::vector<std::string> columns;
+    std::ifstream file(path);
+    std::string line, cell;
+    if (!std::getline(file, line)) return columns;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    std::stringstream ss(line);
+    while (std::getline(ss, cell, ',')) columns.push_back(cell);
+    return columns;
+}
+
+bool loadDataset(const DatasetSpec& spec, bool keepRows, LoadedDataset& loaded, std::string& error) {
+    if (spec.source == "builtin") {
+        loaded.rows.createBankLoanData();
+        loaded.data = EncodedDataset(loaded.rows);
+    } else if (spec.source == "csv") {
+        std::vector<std::string> features = spec.features;
+        std::string target = spec.target;
+        if (features.empty() || target.empty()) {
+            std::vector<std::string> header = readHeader(spec.path);
+            if (header.size() < 2) {
+                error = "не удалось прочитать заголовок " + spec.path;
+                return false;
+            }
+            if (target.empty()) target = header.back();
+            if (features.empty()) {
+                for (const auto& column : header) {
+                    if (column != target) features.push_back(column);
+                }
+            }
+        }
+        if (!loaded.rows.loadFromCSV(spec.path, features, target)) {
+            error = "не удалось загрузить " + spec.path;
+            return false;
+        }
+        loaded.data = EncodedDataset(loaded.rows);
+    } else if (spec.source == "generate") {
+        DataGenerator generator(GeneratorSchema::makeDefault(), spec.seed);
+        loaded.data = generator.generate(spec.rows, 1);
+        if (keepRows) loaded.rows = loaded.data.decode(kReportRows);
+    } else {
+        if (!loaded.data.loadBinary(spec.path)) {
+            error = "не удалось загрузить " + spec.path;
+            return false;
+        }
+        if (keepRows) loaded.rows = loaded.data.decode(kReportRows);
+    }
+
+    if (loaded.data.getRowCount() < 2) {
+        error = "в наборе меньше двух строк";
+        return false;
+    }
+    if (!keepRows) loaded.rows = Dataset();
+    loaded.bytes = MemoryUsage::ofEncoded(loaded.data).total() + MemoryUsage::ofDataset(loaded.rows).total();
+    return true;
+}
+
+// Перемешанное по зерну разделение номеров строк на обучающие и тестовые
+void splitRows(size_t rowCount, double testShare, std::uint32_t seed,
+               std::vector<std::uint32_t>& trainRows, std::vector<std::uint32_t>& testRows) {
+    std::vector<std::uint32_t> order(rowCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::mt19937 rng(seed);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    size_t testCount = static_cast<size_t>(std::llround(rowCount * testShare));
+    testCount = std::min(std::max<size_t>(testCount, 1), rowCount - 1);
+    testRows.assign(order.begin(), order.begin() + testCount);
+    trainRows.assign(order.begin() + testCount, order.end());
+    std::sort(testRows.begin(), testRows.end());
+    std::sort(trainRows.begin(), trainRows.end());
+}
+
+double parameter(const ExperimentJob& job, const std::string& name, double fallback) {
+    for (const auto& [key, value] : job.parameters) {
+        if (key == name) return std::strtod(value.c_str(), nullptr);
+    }
+    return fallback;
+}
+
+// Дерево для леса с параметрами задания
+DecisionTreeFactory forestTreeFactory(const ExperimentJob& job) {
+    bool extra = job.algorithm == "ExtraTrees";
+    int maxDepth = static_cast<int>(parameter(job, "max_depth", -1));
+    int minSamplesSplit = static_cast<int>(parameter(job, "min_samples_split", -1));
+    return [extra, maxDepth, minSamplesSplit]() -> std::unique_ptr<DecisionTree> {
+        if (extra) {
+            auto tree = std::make_unique<ExtraTree>();
+            if (maxDepth >= 0) tree->setMaxDepth(maxDepth);
+            if (minSamplesSplit >= 0) tree->setMinSamplesSplit(minSamplesSplit);
+            return tree;
+        }
+        auto tree = std::make_unique<CARTTree>();
+        if (maxDepth >= 0) tree->setMaxDepth(maxDepth);
+        if (minSamplesSplit >= 0) tree->setMinSamplesSplit(minSamplesSplit);
+        return tree;
+    };
+}
+
+// Обучение и оценка модели задания в вызывающем потоке
+BatchJobResult runJob(const ExperimentJob& job, const DatasetSpec& spec, const LoadedDataset& loaded) {
+    BatchJobResult outcome;
+    outcome.job = job;
+    AlgorithmResult& result = outcome.result;
+    result.algorithmName = job.label();
+
+    std::vector<std::uint32_t> trainRows, testRows;
+    splitRows(loaded.data.getRowCount(), spec.testShare, job.seed, trainRows, testRows);
+    EncodedDataset train = loaded.data.selectRows(trainRows);
+    EncodedDataset test = loaded.data.selectRows(testRows);
+    if (spec.compress) {
+        // Разделение то же, что без сжатия: сжимаются уже готовые выборки
+        train = train.compressDuplicates();
+        test = test.compressDuplicates();
+    }
+    outcome.trainRows = trainRows.size();
+    outcome.testRows = testRows.size();
+    outcome.trainDistinct = train.getRowCount();
+
+    std::vector<EncodedDataset::Code> predictions(test.getRowCount());
+    std::vector<double> probabilities;
+    Profiler::resetThread();
+    double start = Profiler::threadCpuSeconds();
+
+    if (job.algorithm == "RandomForest" || job.algorithm == "ExtraTrees") {
+        RandomForest forest(forestTreeFactory(job));
+        forest.setTreeCount(static_cast<int>(parameter(job, "trees", 100)));
+        forest.setMaxFeatures(static_cast<int>(parameter(job, "max_features", 0)));
+        forest.setSeed(job.seed);
+        forest.setThreadCount(1);
+        forest.setBootstrap(job.algorithm == "RandomForest");
+        forest.train(train);
+        result.trainingTime = Profiler::threadCpuSeconds() - start;
+        predictions = forest.predictBatch(test);
+        probabilities = forest.predictProba(test);
+        result.treeDepth = 0;
+        result.nodeCount = 0;
+        for (size_t i = 0; i < forest.getTreeCount(); ++i) {
+            const DecisionTree& tree = forest.getTree(i);
+            result.treeDepth = std::max(result.treeDepth, tree.getTreeDepth(tree.getRoot()));
+            result.nodeCount += tree.countNodes(tree.getRoot());
+            result.modelMemory += MemoryUsage::ofTree(tree);
+        }
+    } else if (job.algorithm == "GradientBoosting") {
+        GradientBoosting boosting;
+        if (parameter(job, "rounds", -1) >= 0) boosting.setRounds(static_cast<int>(parameter(job, "rounds", 0)));
+        if (parameter(job, "learning_rate", -1) > 0) boosting.setLearningRate(parameter(job, "learning_rate", 0));
+        if (parameter(job, "max_leaves", -1) >= 0) boosting.setMaxLeaves(static_cast<int>(parameter(job, "max_leaves", 0)));
+        if (parameter(job, "max_depth", -1) >= 0) boosting.setMaxDepth(static_cast<int>(parameter(job, "max_depth", 0)));
+        if (parameter(job, "min_data_in_leaf", -1) >= 0) {
+            boosting.setMinDataInLeaf(static_cast<int>(parameter(job, "min_data_in_leaf", 0)));
+        }
+        boosting.setThreadCount(1);
+        boosting.train(train);
+        result.trainingTime = Profiler::threadCpuSeconds() - start;
+        predictions = boosting.predictBatch(test);
+        probabilities = boosting.predictProba(test);
+        result.treeDepth = 0;
+        result.nodeCount = 0;
+        for (size_t i = 0; i < boosting.getTreeCount(); ++i) {
+            const CARTTree& tree = boosting.getTree(i);
+            result.treeDepth = std::max(result.treeDepth, tree.getRegressionDepth());
+            result.nodeCount += static_cast<int>(tree.getRegressionNodeCount());
+            result.modelMemory.nodes += tree.getRegressionBytes();
+        }
+    } else {
+        TuningConfig config;
+        config.algorithm = job.algorithm;
+        config.maxDepth = static_cast<int>(parameter(job, "max_depth", config.maxDepth));
+        config.minSamplesSplit = static_cast<int>(parameter(job, "min_samples_split", config.minSamplesSplit));
+        config.significanceLevel = parameter(job, "significance_level", config.significanceLevel);
+        config.minGainRatio = parameter(job, "min_gain_ratio", config.minGainRatio);
+        config.minImpurityDecrease = parameter(job, "min_impurity_decrease", config.minImpurityDecrease);
+        std::unique_ptr<DecisionTree> tree = config.makeTree();
+        tree->trainEncoded(train);
+        result.trainingTime = Profiler::threadCpuSeconds() - start;
+        CompiledTree compiled(*tree, train);
+        compiled.predictBatch(test, 0, predictions.size(), predictions.data());
+        probabilities = compiled.predictProba(test);
+        result.treeDepth = tree->getTreeDepth(tree->getRoot());
+        result.nodeCount = tree->countNodes(tree->getRoot());
+        result.modelMemory = MemoryUsage::ofTree(*tree);
+    }
+    result.profile = Profiler::collectThread();
+    result.predictedRows = test.getRowCount();
+
+    ClassificationMetrics metrics = MetricsEngine::evaluate(
+        test.getTargets(), predictions, test.getClassCount(), probabilities, 1, test.getWeights());
+    result.accuracy = metrics.accuracy;
+    result.precision = metrics.macroPrecision;
+    result.recall = metrics.macroRecall;
+    result.f1Score = metrics.macroF1;
+    result.microF1 = metrics.microF1;
+    result.logLoss = metrics.logLoss;
+    result.auc = metrics.macroAuc;
+    result.classNames = test.getClassNames();
+    result.perClass = metrics.perClass;
+
+    outcome.succeeded = true;
+    return outcome;
+}
+
+} // namespace
+
+BatchRunner::BatchRunner(const ExperimentManifest& manifest) : manifest(manifest) {}
+
+std::string BatchRunner::toJSON(const BatchJobResult& outcome, const std::string& datasetName) {
+    const ExperimentJob& job = outcome.job;
+    const AlgorithmResult& result = outcome.result;
+    std::ostringstream json;
+    json << "{\"job\":" << job.id
+         << ",\"experiment\":\"" << jsonEscape(job.experiment) << "\""
+         << ",\"dataset\":\"" << jsonEscape(datasetName) << "\""
+         << ",\"algorithm\":\"" << jsonEscape(job.algorithm) << "\""
+         << ",\"parameters\":{";
+    for (size_t i = 0; i < job.parameters.size(); ++i) {
+        // Значение манифеста проверено как число, но может быть не в формате
+        // JSON (.5, +1, 0x10, inf) — выводится заново
+        json << (i > 0 ? "," : "") << "\"" << jsonEscape(job.parameters[i].first) << "\":"
+             << jsonNumber(std::strtod(job.parameters[i].second.c_str(), nullptr));
+    }
+    json << "},\"seed\":" << job.seed;
+    if (!outcome.succeeded) {
+        json << ",\"error\":\"" << jsonEscape(outcome.error) << "\"}";
+        return json.str();
+    }
+    json << ",\"train_rows\":" << outcome.trainRows
+         << ",\"test_rows\":" << outcome.testRows;
+    if (outcome.trainDistinct != outcome.trainRows) json << ",\"train_distinct\":" << outcome.trainDistinct;
+    json
+         << ",\"accuracy\":" << jsonNumber(result.accuracy)
+         << ",\"precision\":" << jsonNumber(result.precision)
+         << ",\"recall\":" << jsonNumber(result.recall)
+         << ",\"f1\":" << jsonNumber(result.f1Score)
+         << ",\"micro_f1\":" << jsonNumber(result.microF1)
+         << ",\"log_loss\":" << jsonNumber(result.logLoss)
+         << ",\"auc\":" << jsonNumber(result.auc)
+         << ",\"training_time\":" << jsonNumber(result.trainingTime)
+         << ",\"depth\":" << result.treeDepth
+         << ",\"nodes\":" << result.nodeCount
+         << ",\"model_bytes\":" << result.modelMemory.total() << "}";
+    return json.str();
+}
+
+bool BatchRunner::run() {
+    const BatchSettings& settings = manifest.getSettings();
+    const std::vector<DatasetSpec>& datasets = manifest.getDatasets();
+    std::vector<ExperimentJob> jobs = manifest.expandJobs();
+
+    std::error_code error;
+    std::filesystem::create_directories(settings.outputDirectory, error);
+    if (error) {
+        std::cerr << "Ошибка создания каталога " << settings.outputDirectory << ": "
+                  << error.message() << std::endl;
+        return false;
+    }
+    std::string jsonPath = settings.outputDirectory + "/results.jsonl";
+    std::ofstream jsonl(jsonPath);
+    if (!jsonl.is_open()) {
+        std::cerr << "Ошибка открытия файла результатов: " << jsonPath << std::endl;
+        return false;
+    }
+
+    results.assign(jobs.size(), BatchJobResult());
+    datasetLoads = 0;
+    peakLoadedBytes = 0;
+
+    std::vector<DatasetSlot> slots(datasets.size());
+    for (const auto& job : jobs) slots[job.dataset].remainingJobs++;
+    std::vector<bool> taken(jobs.size(), false);
+    size_t firstPending = 0;           // все задания до него уже взяты
+    size_t loadedBytes = 0;
+    size_t completed = 0;
+    bool allSucceeded = true;
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            while (firstPending < jobs.size() && taken[firstPending]) firstPending++;
+            if (firstPending == jobs.size()) return;
+
+            // Первое задание, которое можно начать: набор загружен (или не
+            // загрузился), либо еще не загружен и помещается в лимит памяти.
+            // Задания набора, который сейчас загружается, ждут этой загрузки
+            size_t chosen = jobs.size();
+            bool mustLoad = false;
+            for (size_t i = firstPending; i < jobs.size(); ++i) {
+                if (taken[i]) continue;
+                const DatasetSlot& slot = slots[jobs[i].dataset];
+                if (slot.state == DatasetSlot::State::Ready || slot.state == DatasetSlot::State::Failed) {
+                    chosen = i;
+                    break;
+                }
+                if (slot.state == DatasetSlot::State::Unloaded) {
+                    size_t estimate = datasets[jobs[i].dataset].estimateBytes();
+                    if (settings.memoryLimit == 0 || loadedBytes == 0 ||
+                        loadedBytes + estimate <= settings.memoryLimit) {
+                        chosen = i;
+                        mustLoad = true;
+                        break;
+                    }
+                }
+            }
+            if (chosen == jobs.size()) {
+                changed.wait(lock);
+                continue;
+            }
+
+            taken[chosen] = true;
+            const ExperimentJob& job = jobs[chosen];
+            const DatasetSpec& spec = datasets[job.dataset];
+            DatasetSlot& slot = slots[job.dataset];
+
+            if (mustLoad) {
+                slot.state = DatasetSlot::State::Loading;
+                slot.reservedBytes = spec.estimateBytes();
+                loadedBytes += slot.reservedBytes;
+                lock.unlock();
+
+                auto loaded = std::make_shared<LoadedDataset>();
+                std::string error;
+                bool ok = loadDataset(spec, settings.reports, *loaded, error);
+
+                lock.lock();
+                loadedBytes -= slot.reservedBytes;
+                if (ok) {
+                    slot.loaded = loaded;
+                    slot.reservedBytes = loaded->bytes;
+                    slot.state = DatasetSlot::State::Ready;
+                    datasetLoads++;
+                    std::cout << "Загружен набор " << spec.name << ": " << loaded->data.getRowCount()
+                              << " строк, " << MemoryUsage::formatBytes(loaded->bytes) << std::endl;
+                } else {
+                    slot.reservedBytes = 0;
+                    slot.state = DatasetSlot::State::Failed;
+                    slot.error = error;
+                    std::cerr << "Набор " << spec.name << ": " << error << std::endl;
+                }
+                loadedBytes += slot.reservedBytes;
+                peakLoadedBytes = std::max(peakLoadedBytes, loadedBytes);
+                changed.notify_all();
+            }
+
+            std::shared_ptr<LoadedDataset> loaded = slot.loaded;
+            std::string loadError = slot.error;
+            lock.unlock();
+
+            BatchJobResult outcome;
+            if (loaded) {
+                try {
+                    outcome = runJob(job, spec, *loaded);
+                } catch (const std::exception& e) {
+                    outcome.error = e.what();
+                }
+            } else {
+                outcome.error = "набор не загружен: " + loadError;
+            }
+            outcome.job = job;
+            outcome.result.algorithmName = job.label();
+
+            lock.lock();
+            jsonl << toJSON(outcome, spec.name) << "\n";
+            jsonl.flush();
+            completed++;
+            allSucceeded = allSucceeded && outcome.succeeded;
+            std::cout << "[" << completed << "/" << jobs.size() << "] " << spec.name << ": "
+                      << outcome.result.algorithmName;
+            if (outcome.succeeded) {
+                std::cout << " — точность " << std::fixed << std::setprecision(2)
+                          << outcome.result.accuracy * 100 << "%, " << std::setprecision(3)
+                          << outcome.result.trainingTime << " с" << std::endl;
+            } else {
+                std::cout << " — ошибка: " << outcome.error << std::endl;
+            }
+            results[chosen] = std::move(outcome);
+
+            if (--slot.remainingJobs > 0) continue;
+
+            // Последнее задание набора: отчет по всем его моделям и выгрузка
+            if (loaded && settings.reports) {
+                std::vector<AlgorithmResult> datasetResults;
+                for (const auto& finished : results) {
+                    if (finished.succeeded && finished.job.dataset == job.dataset) {
+                        datasetResults.push_back(finished.result);
+                    }
+                }
+                lock.unlock();
+                ReportOptions options;
+                options.threadCount = 1;
+                std::string reportPath = settings.outputDirectory + "/" + spec.name + "_report.html";
+                ReportGenerator::generateFullReport(datasetResults, loaded->rows, reportPath, options);
+                lock.lock();
+                std::cout << "Отчет по набору " << spec.name << ": " << reportPath << std::endl;
+            }
+            loaded.reset();
+            slot.loaded.reset();
+            loadedBytes -= slot.reservedBytes;
+            slot.reservedBytes = 0;
+            slot.state = DatasetSlot::State::Released;
+            changed.notify_all();
+        }
+    };
+
+    unsigned workerCount = settings.workers > 0 ? settings.workers : defaultThreadCount();
+    workerCount = static_cast<unsigned>(std::min<size_t>(workerCount, std::max<size_t>(jobs.size(), 1)));
+    std::vector<std::thread> pool;
+    for (unsigned w = 1; w < workerCount; ++w) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    return allSucceeded && jsonl.good();
+}
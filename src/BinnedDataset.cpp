@@ -0,0 +1,86 @@
+#include "BinnedDataset.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <numeric>
+
+BinnedDataset::BinnedDataset(const EncodedDataset& data, size_t maxBins) {
+    size_t featureCount = data.getFeatureCount();
+    maxBins = std::min(std::max<size_t>(maxBins, 2), kMaxBins);
+    size_t valueBins = maxBins - 1;  // один бин уходит под пропуски
+
+    codeToBin.resize(featureCount);
+    binCounts.resize(featureCount);
+    numeric.resize(featureCount);
+
+    for (size_t f = 0; f < featureCount; ++f) {
+        size_t cardinality = data.getCardinality(f);
+        // Частоты с кратностями строк: сжатый набор режется так же, как исходный
+        std::vector<size_t> frequency(cardinality, 0);
+        const auto& column = data.getColumn(f);
+        for (size_t row = 0; row < column.size(); ++row) {
+            if (column[row] != EncodedDataset::kMissing) frequency[column[row]] += data.getWeight(row);
+        }
+
+        auto& mapping = codeToBin[f];
+        mapping.assign(cardinality, 0);
+        numeric[f] = data.isNumeric(f);
+
+        if (cardinality <= valueBins) {
+            // Бин на каждое значение
+            for (size_t code = 0; code < cardinality; ++code) {
+                mapping[code] = static_cast<std::uint8_t>(code);
+            }
+            binCounts[f] = cardinality + 1;
+        } else if (numeric[f]) {
+            // Коды упорядочены по числу: режем по квантилям накопленной частоты
+            size_t total = std::accumulate(frequency.begin(), frequency.end(), size_t(0));
+            double perBin = static_cast<double>(total) / valueBins;
+            size_t bin = 0, accumulated = 0;
+            for (size_t code = 0; code < cardinality; ++code) {
+                mapping[code] = static_cast<std::uint8_t>(bin);
+                accumulated += frequency[code];
+                if (bin + 1 < valueBins && accumulated >= perBin * (bin + 1)) {
+                    bin++;
+                }
+            }
+            binCounts[f] = bin + 2;
+        } else {
+            // Самые частые значения получают свои бины, остальные — общий
+            std::vector<size_t> order(cardinality);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(),
+                [&](size_t a, size_t b) { return frequency[a] > frequency[b]; });
+            std::uint8_t otherBin = static_cast<std::uint8_t>(valueBins - 1);
+            for (size_t rank = 0; rank < cardinality; ++rank) {
+                mapping[order[rank]] = rank < otherBin ? static_cast<std::uint8_t>(rank) : otherBin;
+            }
+            binCounts[f] = valueBins + 1;
+        }
+    }
+
+    quantize(data);
+}
+
+BinnedDataset::BinnedDataset(const EncodedDataset& data, const BinnedDataset& mapper)
+    : codeToBin(mapper.codeToBin),
+      binCounts(mapper.binCounts),
+      numeric(mapper.numeric) {
+    quantize(data);
+}
+
+void BinnedDataset::quantize(const EncodedDataset& data) {
+    rowCount = data.getRowCount();
+    columns.assign(codeToBin.size(), std::vector<std::uint8_t>());
+
+    parallelFor(codeToBin.size(), 0, [&](size_t f) {
+        const auto& source = data.getColumn(f);
+        const auto& mapping = codeToBin[f];
+        std::uint8_t missingBin = getMissingBin(f);
+        auto& column = columns[f];
+        column.resize(rowCount);
+        for (size_t row = 0; row < rowCount; ++row) {
+            auto code = source[row];
+            column[row] = code < mapping.size() ? mapping[code] : missingBin;
+        }
+    });
+}
@@ -1,213 +1,287 @@
 #include "CART.h"
+#include "Parallel.h"
+#include "Profiler.h"
 #include <iomanip>
 #include <cmath>
 #include <map>
 #include <algorithm>
 
-double CARTTree::giniIndex(const std::vector<DataExample>& examples) const {
-    if (examples.empty()) return 0.0;
-    
-    std::map<std::string, int> classCounts;
-    for (const auto& ex : examples) {
-        classCounts[ex.target]++;
+namespace {
+
+// Ячейка гистограммы: суммы градиентов и гессианов строк, попавших в бин
+struct HistogramBin {
+    double gradient = 0.0;
+    double hessian = 0.0;
+    std::uint32_t count = 0;
+};
+
+// Гистограммы всех признаков узла лежат подряд в одном массиве
+struct NodeHistogram {
+    std::vector<HistogramBin> bins;
+};
+
+// Лист, ожидающий разбиения: отрезок общего массива индексов строк
+struct GrowingLeaf {
+    size_t begin = 0;
+    size_t end = 0;
+    int node = 0;
+    int depth = 0;
+    double gradient = 0.0;
+    double hessian = 0.0;
+    NodeHistogram histogram;
+
+    // Лучшее разбиение листа
+    double gain = 0.0;
+    int feature = -1;
+    std::bitset<BinnedDataset::kMaxBins> leftBins;
+};
+
+// Признаков × строк, начиная с которого гистограмма строится параллельно
+const size_t kParallelHistogramWork = 1 << 16;
+
+class HistogramTreeGrower {
+public:
+    HistogramTreeGrower(const BinnedDataset& data,
+                        const std::vector<float>& gradients,
+                        const std::vector<float>& hessians,
+                        const GradientTreeParams& params)
+        : data(data), gradients(gradients), hessians(hessians), params(params) {
+        offsets.resize(data.getFeatureCount() + 1, 0);
+        for (size_t f = 0; f < data.getFeatureCount(); ++f) {
+            offsets[f + 1] = offsets[f] + data.getBinCount(f);
+        }
+        // Строки с нулевым гессианом (вес 0, например без класса) не участвуют
+        // ни в гистограммах, ни в счете строк листа
+        rows.reserve(data.getRowCount());
+        for (std::uint32_t row = 0; row < data.getRowCount(); ++row) {
+            if (hessians[row] > 0.0f) rows.push_back(row);
+        }
     }
-    
-    double gini = 1.0;
-    for (const auto& [className, count] : classCounts) {
-        double probability = static_cast<double>(count) / examples.size();
-        gini -= probability * probability;
+
+    double leafValue(double gradient, double hessian) const {
+        return -gradient / (hessian + params.lambda) * params.learningRate;
     }
-    
-    return gini;
-}
 
-double CARTTree::giniGain(const std::vector<DataExample>& examples,
-                         const std::string& feature) const {
-    double parentGini = giniIndex(examples);
-    
-    std::map<std::string, std::vector<DataExample>> subsets;
-    for (const auto& ex : examples) {
-        subsets[ex.features.at(feature)].push_back(ex);
+    void buildHistogram(GrowingLeaf& leaf) const {
+        ProfileScope scope(ProfilePhase::Counting);
+        leaf.histogram.bins.assign(offsets.back(), HistogramBin());
+        size_t featureCount = data.getFeatureCount();
+        size_t work = (leaf.end - leaf.begin) * featureCount;
+        unsigned threads = work >= kParallelHistogramWork ? params.threadCount : 1;
+
+        parallelFor(featureCount, threads, [&](size_t f) {
+            const std::uint8_t* column = data.getColumn(f).data();
+            HistogramBin* bins = leaf.histogram.bins.data() + offsets[f];
+            for (size_t i = leaf.begin; i < leaf.end; ++i) {
+                std::uint32_t row = rows[i];
+                HistogramBin& bin = bins[column[row]];
+                bin.gradient += gradients[row];
+                bin.hessian += hessians[row];
+                bin.count++;
+            }
+        });
     }
-    
-    double weightedGini = 0.0;
-    for (const auto& [value, subset] : subsets) {
-        double weight = static_cast<double>(subset.size()) / examples.size();
-        weightedGini += weight * giniIndex(subset);
+
+    // Трюк вычитания: гистограмма соседа = гистограмма родителя − гистограмма потомка
+    static void subtractHistogram(NodeHistogram& parent, const NodeHistogram& child) {
+        ProfileScope scope(ProfilePhase::Counting);
+        for (size_t i = 0; i < parent.bins.size(); ++i) {
+            parent.bins[i].gradient -= child.bins[i].gradient;
+            parent.bins[i].hessian -= child.bins[i].hessian;
+            parent.bins[i].count -= child.bins[i].count;
+        }
     }
-    
-    return parentGini - weightedGini;
-}
 
-double CARTTree::calculateImpurity(const std::vector<DataExample>& examples) const {
-    return giniIndex(examples);
-}
+    double score(double gradient, double hessian) const {
+        return gradient * gradient / (hessian + params.lambda);
+    }
 
-std::pair<std::string, double> CARTTree::findBestSplit(
-    const std::vector<DataExample>& examples,
-    const std::vector<std::string>& availableFeatures) const {
-    
-    if (examples.empty() || availableFeatures.empty()) {
-        return {"", 0.0};
+    bool admissible(double hessian, std::uint32_t count) const {
+        return count >= static_cast<std::uint32_t>(params.minDataInLeaf) &&
+               hessian >= params.minSumHessian;
     }
-    
-    std::string bestFeature;
-    double bestGiniGain = -1.0;
-    
-    for (const auto& feature : availableFeatures) {
-        double gain = giniGain(examples, feature);
-        if (gain > bestGiniGain && gain >= minImpurityDecrease) {
-            bestGiniGain = gain;
-            bestFeature = feature;
+
+    void findBestSplit(GrowingLeaf& leaf) const {
+        ProfileScope scope(ProfilePhase::Impurity);
+        leaf.gain = 0.0;
+        leaf.feature = -1;
+        if (params.maxDepth >= 0 && leaf.depth >= params.maxDepth) return;
+
+        std::uint32_t total = static_cast<std::uint32_t>(leaf.end - leaf.begin);
+        double parentScore = score(leaf.gradient, leaf.hessian);
+
+        for (size_t f = 0; f < data.getFeatureCount(); ++f) {
+            const HistogramBin* bins = leaf.histogram.bins.data() + offsets[f];
+            size_t binCount = data.getBinCount(f);
+
+            // Порядок просмотра бинов: числовые — по возрастанию (пропуски справа),
+            // категориальные — по отношению градиента к гессиану
+            std::vector<std::uint8_t> order;
+            order.reserve(binCount);
+            for (size_t b = 0; b < binCount; ++b) {
+                if (bins[b].count == 0) continue;
+                if (data.isNumeric(f) && b == data.getMissingBin(f)) continue;
+                order.push_back(static_cast<std::uint8_t>(b));
+            }
+            if (!data.isNumeric(f)) {
+                std::sort(order.begin(), order.end(), [&](std::uint8_t a, std::uint8_t b) {
+                    return bins[a].gradient / (bins[a].hessian + params.lambda) <
+                           bins[b].gradient / (bins[b].hessian + params.lambda);
+                });
+            }
+
+            double leftGradient = 0.0, leftHessian = 0.0;
+            std::uint32_t leftCount = 0;
+            for (size_t i = 0; i + 1 < order.size(); ++i) {
+                const HistogramBin& bin = bins[order[i]];
+                leftGradient += bin.gradient;
+                leftHessian += bin.hessian;
+                leftCount += bin.count;
+
+                double rightGradient = leaf.gradient - leftGradient;
+                double rightHessian = leaf.hessian - leftHessian;
+                std::uint32_t rightCount = total - leftCount;
+                if (!admissible(leftHessian, leftCount) || !admissible(rightHessian, rightCount)) {
+                    continue;
+                }
+
+                double gain = score(leftGradient, leftHessian) +
+                              score(rightGradient, rightHessian) - parentScore;
+                if (gain > leaf.gain && gain > params.minSplitGain) {
+                    leaf.gain = gain;
+                    leaf.feature = static_cast<int>(f);
+                    leaf.leftBins.reset();
+                    for (size_t j = 0; j <= i; ++j) leaf.leftBins.set(order[j]);
+                }
+            }
         }
     }
-    
-    return {bestFeature, bestGiniGain};
-}
 
-std::shared_ptr<TreeNode> CARTTree::buildTreeRecursive(
-    const std::vector<DataExample>& examples,
-    const std::vector<std::string>& availableFeatures,
-    int depth) {
+    const BinnedDataset& data;
+    const std::vector<float>& gradients;
+    const std::vector<float>& hessians;
+    const GradientTreeParams& params;
+    std::vector<size_t> offsets;
+    std::vector<std::uint32_t> rows;
+};
+
+} // namespace
+
+void CARTTree::fitGradientHistogram(const BinnedDataset& data,
+                                    const std::vector<float>& gradients,
+                                    const std::vector<float>& hessians,
+                                    const GradientTreeParams& params,
+                                    std::vector<double>& rowOutputs) {
+    isClassification = false;
+    regressionNodes.clear();
+    rowOutputs.assign(data.getRowCount(), 0.0);
+    if (data.getRowCount() == 0) return;
     
-    auto node = std::make_shared<TreeNode>();
-    node->samples = examples.size();
+    HistogramTreeGrower grower(data, gradients, hessians, params);
     
-    if (examples.empty()) {
-        node->isLeaf = true;
-        node->decision = "Unknown";
-        return node;
+    std::vector<GrowingLeaf> leaves(1);
+    GrowingLeaf& rootLeaf = leaves[0];
+    rootLeaf.end = grower.rows.size();
+    for (std::uint32_t row : grower.rows) {
+        rootLeaf.gradient += gradients[row];
+        rootLeaf.hessian += hessians[row];
     }
-    
-    // Проверка на однородность
-    bool allSameClass = true;
-    std::string firstClass = examples[0].target;
-    for (size_t i = 1; i < examples.size(); ++i) {
-        if (examples[i].target != firstClass) {
-            allSameClass = false;
-            break;
-        }
+    regressionNodes.emplace_back();
+    Profiler::addNode(0);
+    {
+        ProfileScope search(ProfilePhase::SplitSearch);
+        grower.buildHistogram(rootLeaf);
+        grower.findBestSplit(rootLeaf);
     }
     
-    if (allSameClass || availableFeatures.empty() || depth >= maxDepth || 
-        examples.size() < minSamplesSplit) {
-        node->isLeaf = true;
-        
-        // Определяем большинство класса
-        std::map<std::string, int> classCounts;
-        for (const auto& ex : examples) {
-            classCounts[ex.target]++;
-        }
-        
-        std::string majorityClass;
-        int maxCount = -1;
-        for (const auto& [className, count] : classCounts) {
-            if (count > maxCount) {
-                maxCount = count;
-                majorityClass = className;
+    // Рост «лучший лист первым» до исчерпания бюджета листьев
+    while (static_cast<int>(leaves.size()) < params.maxLeaves) {
+        size_t best = leaves.size();
+        for (size_t i = 0; i < leaves.size(); ++i) {
+            if (leaves[i].feature >= 0 && (best == leaves.size() || leaves[i].gain > leaves[best].gain)) {
+                best = i;
             }
         }
+        if (best == leaves.size()) break;
         
-        node->decision = majorityClass;
-        node->confidence = static_cast<double>(maxCount) / examples.size();
-        return node;
-    }
-    
-    // Находим лучший признак для разделения
-    auto [bestFeature, bestGain] = findBestSplit(examples, availableFeatures);
-    
-    if (bestFeature.empty()) {
-        node->isLeaf = true;
-        
-        std::map<std::string, int> classCounts;
-        for (const auto& ex : examples) {
-            classCounts[ex.target]++;
+        GrowingLeaf parent = std::move(leaves[best]);
+        const std::uint8_t* column = data.getColumn(parent.feature).data();
+        GrowingLeaf left, right;
+        {
+            ProfileScope scope(ProfilePhase::Partition);
+            auto middle = std::partition(grower.rows.begin() + parent.begin, grower.rows.begin() + parent.end,
+                [&](std::uint32_t row) { return parent.leftBins.test(column[row]); });
+            size_t split = middle - grower.rows.begin();
+            
+            left.begin = parent.begin;
+            left.end = split;
+            right.begin = split;
+            right.end = parent.end;
+            left.depth = right.depth = parent.depth + 1;
+            for (size_t i = left.begin; i < left.end; ++i) {
+                left.gradient += gradients[grower.rows[i]];
+                left.hessian += hessians[grower.rows[i]];
+            }
+            right.gradient = parent.gradient - left.gradient;
+            right.hessian = parent.hessian - left.hessian;
         }
         
-        std::string majorityClass;
-        int maxCount = -1;
-        for (const auto& [className, count] : classCounts) {
-            if (count > maxCount) {
-                maxCount = count;
-                majorityClass = className;
-            }
+        left.node = static_cast<int>(regressionNodes.size());
+        right.node = left.node + 1;
+        {
+            ProfileScope scope(ProfilePhase::NodeAllocation);
+            regressionNodes.resize(regressionNodes.size() + 2);
         }
+        RegressionNode& node = regressionNodes[parent.node];
+        node.feature = parent.feature;
+        node.leftBins = parent.leftBins;
+        node.left = left.node;
+        node.right = right.node;
+        regressionNodes[left.node].depth = left.depth;
+        regressionNodes[right.node].depth = right.depth;
+        Profiler::addNode(left.depth);
+        Profiler::addNode(right.depth);
         
-        node->decision = majorityClass;
-        return node;
-    }
-    
-    node->isLeaf = false;
-    node->feature = bestFeature;
-    
-    // Для CART создаем бинарные разбиения
-    // Упрощенная версия: используем все значения признака как отдельные ветки
-    std::map<std::string, std::vector<DataExample>> subsets;
-    for (const auto& ex : examples) {
-        std::string value = ex.features.at(bestFeature);
-        subsets[value].push_back(ex);
-    }
-    
-    // Новый список признаков (без использованного)
-    std::vector<std::string> newFeatures;
-    for (const auto& feature : availableFeatures) {
-        if (feature != bestFeature) {
-            newFeatures.push_back(feature);
+        {
+            ProfileScope search(ProfilePhase::SplitSearch);
+            // Гистограмма строится только для меньшего потомка
+            GrowingLeaf& smaller = left.end - left.begin <= right.end - right.begin ? left : right;
+            GrowingLeaf& larger = &smaller == &left ? right : left;
+            grower.buildHistogram(smaller);
+            HistogramTreeGrower::subtractHistogram(parent.histogram, smaller.histogram);
+            larger.histogram = std::move(parent.histogram);
+            
+            grower.findBestSplit(left);
+            grower.findBestSplit(right);
         }
+        leaves[best] = std::move(left);
+        leaves.push_back(std::move(right));
     }
     
-    // Рекурсивное построение поддеревьев
-    for (const auto& [value, subset] : subsets) {
-        if (subset.size() < minSamplesSplit) {
-            // Если слишком мало примеров, создаем лист
-            auto leafNode = std::make_shared<TreeNode>();
-            leafNode->isLeaf = true;
-            
-            // Используем большинство класс родителя
-            std::map<std::string, int> parentClassCounts;
-            for (const auto& ex : examples) {
-                parentClassCounts[ex.target]++;
-            }
-            
-            std::string majorityClass;
-            int maxCount = -1;
-            for (const auto& [className, count] : parentClassCounts) {
-                if (count > maxCount) {
-                    maxCount = count;
-                    majorityClass = className;
-                }
-            }
-            
-            leafNode->decision = majorityClass;
-            leafNode->samples = subset.size();
-            node->children[value] = leafNode;
-        } else {
-            node->children[value] = buildTreeRecursive(subset, newFeatures, depth + 1);
+    // Значения листьев и выход дерева для каждой строки
+    for (const auto& leaf : leaves) {
+        double value = grower.leafValue(leaf.gradient, leaf.hessian);
+        regressionNodes[leaf.node].value = value;
+        for (size_t i = leaf.begin; i < leaf.end; ++i) {
+            rowOutputs[grower.rows[i]] = value;
         }
     }
-    
-    return node;
 }
 
-void CARTTree::train(const Dataset& dataset) {
-    features = dataset.getFeatureNames();
-    targetName = dataset.getTargetName();
-    root = buildTreeRecursive(dataset.getExamples(), features, 0);
+double CARTTree::predictRegression(const BinnedDataset& data, size_t row) const {
+    if (regressionNodes.empty()) return 0.0;
+    int index = 0;
+    while (regressionNodes[index].feature >= 0) {
+        const RegressionNode& node = regressionNodes[index];
+        index = node.leftBins.test(data.getColumn(node.feature)[row]) ? node.left : node.right;
+    }
+    return regressionNodes[index].value;
 }
 
-std::string CARTTree::predict(const DataExample& example) const {
-    std::shared_ptr<TreeNode> currentNode = root;
-    
-    while (currentNode && !currentNode->isLeaf) {
-        std::string featureValue = example.features.at(currentNode->feature);
-        
-        if (currentNode->children.find(featureValue) == currentNode->children.end()) {
-            // Значение не найдено, возвращаем Unknown
-            return "Unknown";
-        }
-        
-        currentNode = currentNode->children.at(featureValue);
+int CARTTree::getRegressionDepth() const {
+    int depth = 0;
+    for (const auto& node : regressionNodes) {
+        depth = std::max(depth, node.depth);
     }
-    
-    return currentNode ? currentNode->decision : "Unknown";
-}
\ No newline at end of file
+    return depth;
+}
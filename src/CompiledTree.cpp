@@ -0,0 +1,69 @@
+#include "CompiledTree.h"
+
+CompiledTree::CompiledTree(const DecisionTree& tree, const EncodedDataset& schema)
+    : classCount(schema.getClassCount()) {
+    if (tree.getRoot()) {
+        compileNode(*tree.getRoot(), schema);
+    }
+}
+
+int32_t CompiledTree::compileNode(const TreeNode& node, const EncodedDataset& schema) {
+    int32_t index = static_cast<int32_t>(nodes.size());
+    nodes.emplace_back();
+
+    // Внутренние узлы тоже получают класс большинства (если он известен) —
+    // он нужен для усечения дерева по глубине
+    nodes[index].classCode = schema.encodeClass(node.decision);
+    
+    // Доли классов: из распределения узла, а у деревьев, обученных по строкам
+    // (без распределения), — вся масса на классе решения
+    probabilities.resize(probabilities.size() + classCount, 0.0);
+    double* shares = probabilities.data() + static_cast<size_t>(index) * classCount;
+    double total = 0.0;
+    for (double count : node.classCounts) total += count;
+    if (node.classCounts.size() == classCount && total > 0.0) {
+        for (size_t c = 0; c < classCount; ++c) shares[c] = node.classCounts[c] / total;
+    } else if (nodes[index].classCode < classCount) {
+        shares[nodes[index].classCode] = 1.0;
+    }
+    
+    int feature = node.isLeaf ? -1 : schema.findFeature(node.feature);
+    if (feature < 0) {
+        return index;
+    }
+
+    uint32_t childCount = static_cast<uint32_t>(schema.getCardinality(feature));
+    uint32_t firstChild = static_cast<uint32_t>(children.size());
+    nodes[index].feature = feature;
+    nodes[index].firstChild = firstChild;
+    nodes[index].childCount = childCount;
+    children.resize(children.size() + childCount, -1);
+
+    // Один и тот же потомок может висеть на нескольких значениях
+    std::map<const TreeNode*, int32_t> compiled;
+    for (const auto& [value, child] : node.children) {
+        Code code = schema.encodeValue(feature, value);
+        if (code == EncodedDataset::kMissing || !child) continue;
+
+        auto it = compiled.find(child.get());
+        int32_t childIndex = it != compiled.end() ? it->second : compileNode(*child, schema);
+        compiled[child.get()] = childIndex;
+        children[firstChild + code] = childIndex;
+    }
+    return index;
+}
+
+void CompiledTree::predictBatch(const EncodedDataset& data, size_t begin, size_t end,
+                                Code* out) const {
+    for (size_t row = begin; row < end; ++row) {
+        out[row - begin] = predictRow(data, row);
+    }
+}
+
+std::vector<double> CompiledTree::predictProba(const EncodedDataset& data) const {
+    std::vector<double> result(data.getRowCount() * classCount);
+    for (size_t row = 0; row < data.getRowCount(); ++row) {
+        predictProbaRow(data, row, result.data() + row * classCount);
+    }
+    return result;
+}
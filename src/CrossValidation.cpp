@@ -0,0 +1,215 @@
+#include "CrossValidation.h"
+#include "CompiledTree.h"
+#include "Metrics.h"
+#include "Parallel.h"
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// Среднее и стандартное отклонение (выборочное) набора значений
+std::pair<double, double> meanAndStd(const std::vector<double>& values) {
+    if (values.empty()) return {0.0, 0.0};
+    double mean = 0.0;
+    for (double value : values) mean += value;
+    mean /= values.size();
+    if (values.size() < 2) return {mean, 0.0};
+
+    double variance = 0.0;
+    for (double value : values) variance += (value - mean) * (value - mean);
+    return {mean, std::sqrt(variance / (values.size() - 1))};
+}
+
+// Средние и отклонения метрик по результатам фолдов одного алгоритма;
+// метрики по классам — средние по фолдам, примеров — во всех отложенных частях
+AlgorithmResult summarizeFolds(const std::string& name, const AlgorithmResult* foldResults, int folds) {
+    std::vector<double> accuracy, precision, recall, f1, microF1, logLoss, auc, time, depth, nodes;
+    for (int fold = 0; fold < folds; ++fold) {
+        const AlgorithmResult& result = foldResults[fold];
+        accuracy.push_back(result.accuracy);
+        precision.push_back(result.precision);
+        recall.push_back(result.recall);
+        f1.push_back(result.f1Score);
+        microF1.push_back(result.microF1);
+        // Фолды без определенного значения (NaN) не усредняются
+        if (!std::isnan(result.logLoss)) logLoss.push_back(result.logLoss);
+        if (!std::isnan(result.auc)) auc.push_back(result.auc);
+        time.push_back(result.trainingTime);
+        depth.push_back(result.treeDepth);
+        nodes.push_back(result.nodeCount);
+    }
+
+    AlgorithmResult result;
+    result.algorithmName = name;
+    result.folds = folds;
+    std::tie(result.accuracy, result.accuracyStd) = meanAndStd(accuracy);
+    std::tie(result.precision, result.precisionStd) = meanAndStd(precision);
+    std::tie(result.recall, result.recallStd) = meanAndStd(recall);
+    std::tie(result.f1Score, result.f1ScoreStd) = meanAndStd(f1);
+    std::tie(result.trainingTime, result.trainingTimeStd) = meanAndStd(time);
+    result.microF1 = meanAndStd(microF1).first;
+    if (!logLoss.empty()) result.logLoss = meanAndStd(logLoss).first;
+    if (!auc.empty()) result.auc = meanAndStd(auc).first;
+    result.treeDepth = static_cast<int>(std::lround(meanAndStd(depth).first));
+    result.nodeCount = static_cast<int>(std::lround(meanAndStd(nodes).first));
+
+    size_t classCount = folds > 0 ? foldResults[0].perClass.size() : 0;
+    result.perClass.resize(classCount);
+    for (size_t c = 0; c < classCount; ++c) {
+        std::vector<double> classPrecision, classRecall, classF1, classAuc;
+        for (int fold = 0; fold < folds; ++fold) {
+            const ClassMetrics& metrics = foldResults[fold].perClass[c];
+            classPrecision.push_back(metrics.precision);
+            classRecall.push_back(metrics.recall);
+            classF1.push_back(metrics.f1Score);
+            if (!std::isnan(metrics.auc)) classAuc.push_back(metrics.auc);
+            result.perClass[c].support += metrics.support;
+        }
+        result.perClass[c].precision = meanAndStd(classPrecision).first;
+        result.perClass[c].recall = meanAndStd(classRecall).first;
+        result.perClass[c].f1Score = meanAndStd(classF1).first;
+        if (!classAuc.empty()) result.perClass[c].auc = meanAndStd(classAuc).first;
+    }
+    return result;
+}
+
+// Метрики фолда по предсказаниям для отложенных строк
+void setFoldMetrics(AlgorithmResult& result, const ClassificationMetrics& metrics) {
+    result.accuracy = metrics.accuracy;
+    result.precision = metrics.macroPrecision;
+    result.recall = metrics.macroRecall;
+    result.f1Score = metrics.macroF1;
+    result.microF1 = metrics.microF1;
+    result.logLoss = metrics.logLoss;
+    result.auc = metrics.macroAuc;
+    result.perClass = metrics.perClass;
+}
+
+} // namespace
+
+CrossValidation::CrossValidation(int folds, std::uint32_t seed)
+    : folds(std::max(2, folds)), seed(seed) {}
+
+std::vector<std::vector<std::uint32_t>> CrossValidation::stratifiedFolds(
+    const EncodedDataset& data, int folds, std::uint32_t seed) {
+
+    // Строки каждого класса перемешиваются и раздаются фолдам по кругу;
+    // счетчик продолжается между классами, чтобы размеры фолдов не расходились
+    std::vector<std::vector<std::uint32_t>> byClass(data.getClassCount());
+    const auto& targets = data.getTargets();
+    for (size_t row = 0; row < targets.size(); ++row) {
+        if (targets[row] < byClass.size()) byClass[targets[row]].push_back(static_cast<std::uint32_t>(row));
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<std::vector<std::uint32_t>> result(folds);
+    size_t next = 0;
+    for (auto& rows : byClass) {
+        std::shuffle(rows.begin(), rows.end(), rng);
+        for (auto row : rows) {
+            result[next++ % folds].push_back(row);
+        }
+    }
+    for (auto& fold : result) {
+        std::sort(fold.begin(), fold.end());
+    }
+    return result;
+}
+
+std::vector<AlgorithmResult> CrossValidation::evaluate(
+    const EncodedDataset& data,
+    const std::vector<std::pair<std::string, DecisionTreeFactory>>& algorithms) const {
+
+    auto testFolds = stratifiedFolds(data, folds, seed);
+    const auto& targets = data.getTargets();
+    size_t classCount = data.getClassCount();
+
+    // Результат каждого фолда каждого алгоритма
+    std::vector<AlgorithmResult> foldResults(algorithms.size() * folds);
+
+    parallelFor(foldResults.size(), threadCount, [&](size_t task) {
+        size_t algorithm = task / folds;
+        const auto& testRows = testFolds[task % folds];
+
+        // Обучающая часть — все строки, кроме отложенных
+        std::vector<std::uint32_t> weights(data.getRowCount());
+        for (size_t row = 0; row < weights.size(); ++row) weights[row] = data.getWeight(row);
+        for (auto row : testRows) weights[row] = 0;
+
+        auto tree = algorithms[algorithm].second();
+        auto start = std::chrono::steady_clock::now();
+        tree->trainEncoded(data, weights);
+        auto end = std::chrono::steady_clock::now();
+
+        // Отложенные строки фолда собираются в плотные массивы для MetricsEngine
+        CompiledTree compiled(*tree, data);
+        std::vector<EncodedDataset::Code> actual(testRows.size()), predicted(testRows.size());
+        std::vector<double> probabilities(testRows.size() * classCount);
+        std::vector<std::uint32_t> testWeights;
+        if (!data.getWeights().empty()) testWeights.resize(testRows.size());
+        for (size_t i = 0; i < testRows.size(); ++i) {
+            actual[i] = targets[testRows[i]];
+            if (!testWeights.empty()) testWeights[i] = data.getWeight(testRows[i]);
+            predicted[i] = compiled.predictRow(data, testRows[i]);
+            compiled.predictProbaRow(data, testRows[i], probabilities.data() + i * classCount);
+        }
+        ClassificationMetrics metrics = MetricsEngine::evaluate(actual, predicted, classCount,
+                                                                probabilities, 1, testWeights);
+
+        AlgorithmResult& result = foldResults[task];
+        setFoldMetrics(result, metrics);
+        result.trainingTime = std::chrono::duration<double>(end - start).count();
+        result.treeDepth = tree->getTreeDepth(tree->getRoot());
+        result.nodeCount = tree->countNodes(tree->getRoot());
+    });
+
+    // Сводка по фолдам
+    std::vector<AlgorithmResult> summary;
+    for (size_t algorithm = 0; algorithm < algorithms.size(); ++algorithm) {
+        summary.push_back(summarizeFolds(algorithms[algorithm].first, foldResults.data() + algorithm * folds, folds));
+        summary.back().classNames = data.getClassNames();
+    }
+    return summary;
+}
+
+std::vector<AlgorithmResult> CrossValidation::evaluateModels(
+    const EncodedDataset& data,
+    const std::vector<std::pair<std::string, FoldModel>>& models) const {
+
+    auto testFolds = stratifiedFolds(data, folds, seed);
+    size_t classCount = data.getClassCount();
+
+    // Обучающие части фолдов — дополнения отложенных строк
+    std::vector<std::vector<std::uint32_t>> trainFolds(folds);
+    for (int fold = 0; fold < folds; ++fold) {
+        std::vector<bool> held(data.getRowCount(), false);
+        for (auto row : testFolds[fold]) held[row] = true;
+        for (size_t row = 0; row < held.size(); ++row) {
+            if (!held[row]) trainFolds[fold].push_back(static_cast<std::uint32_t>(row));
+        }
+    }
+
+    std::vector<AlgorithmResult> summary;
+    std::vector<AlgorithmResult> foldResults(folds);
+    for (const auto& [name, model] : models) {
+        for (int fold = 0; fold < folds; ++fold) {
+            EncodedDataset train = data.selectRows(trainFolds[fold]);
+            EncodedDataset test = data.selectRows(testFolds[fold]);
+            FoldPredictions predictions = model(train, test);
+            bool withProbabilities = predictions.probabilities.size() == test.getRowCount() * classCount;
+            ClassificationMetrics metrics = MetricsEngine::evaluate(
+                test.getTargets(), predictions.classes, classCount,
+                withProbabilities ? predictions.probabilities : std::vector<double>(),
+                threadCount, test.getWeights());
+
+            AlgorithmResult& result = foldResults[fold];
+            result = AlgorithmResult();
+            setFoldMetrics(result, metrics);
+            result.trainingTime = predictions.trainingTime;
+        }
+        summary.push_back(summarizeFolds(name, foldResults.data(), folds));
+        summary.back().classNames = data.getClassNames();
+    }
+    return summary;
+}
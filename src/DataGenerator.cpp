@@ -0,0 +1,211 @@
+#include "DataGenerator.h"
+#include "Parallel.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+constexpr size_t kBlockRows = 1 << 16;
+
+// Зерно блока строк: перемешивание общего зерна с номером блока (splitmix64)
+std::uint64_t blockSeed(std::uint32_t seed, size_t block) {
+    std::uint64_t z = (static_cast<std::uint64_t>(seed) << 32) + block + 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Имена категориальных значений с ведущими нулями, чтобы
+// лексикографический порядок словаря совпадал с порядком кодов
+std::string categoryName(size_t value, size_t cardinality) {
+    std::string digits = std::to_string(value);
+    size_t width = std::to_string(cardinality > 0 ? cardinality - 1 : 0).size();
+    return "v" + std::string(width - digits.size(), '0') + digits;
+}
+
+} // namespace
+
+GeneratorSchema GeneratorSchema::makeDefault(size_t categorical, size_t numericCount,
+                                             size_t cardinality) {
+    GeneratorSchema schema;
+    for (size_t i = 0; i < categorical; ++i) {
+        schema.features.push_back({"Категория_" + std::to_string(i + 1), cardinality, false});
+    }
+    for (size_t i = 0; i < numericCount; ++i) {
+        schema.features.push_back({"Число_" + std::to_string(i + 1), cardinality * 4, true});
+    }
+    return schema;
+}
+
+DataGenerator::DataGenerator(GeneratorSchema generatorSchema, std::uint32_t seed)
+    : schema(std::move(generatorSchema)), seed(seed) {
+    // Словари в том же виде, что строит EncodedDataset из строк:
+    // классы по алфавиту, числовые значения по возрастанию
+    std::vector<double> weights = schema.classWeights;
+    weights.resize(schema.classNames.size(), weights.empty() ? 1.0 : 0.0);
+    std::vector<size_t> order(schema.classNames.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return schema.classNames[a] < schema.classNames[b];
+    });
+
+    double total = 0.0;
+    for (size_t index : order) {
+        prototype.classNames.push_back(schema.classNames[index]);
+        total += std::max(0.0, weights[index]);
+        cumulativeWeights.push_back(total);
+    }
+    if (total <= 0.0) {
+        for (size_t c = 0; c < cumulativeWeights.size(); ++c) cumulativeWeights[c] = c + 1.0;
+    }
+
+    prototype.targetName = schema.targetName;
+    for (const auto& feature : schema.features) {
+        size_t cardinality = std::max<size_t>(1, feature.cardinality);
+        std::vector<std::string> values;
+        for (size_t v = 0; v < cardinality; ++v) {
+            values.push_back(feature.numeric ? std::to_string(v * 10) : categoryName(v, cardinality));
+        }
+        prototype.featureNames.push_back(feature.name);
+        prototype.valueNames.push_back(std::move(values));
+        prototype.numeric.push_back(feature.numeric);
+    }
+    prototype.columns.assign(schema.features.size(), {});
+
+    std::mt19937 rng(seed);
+    plantNode(0, rng);
+}
+
+EncodedDataset::Code DataGenerator::drawClass(std::mt19937& rng) const {
+    if (cumulativeWeights.empty()) return EncodedDataset::kMissing;
+    std::uniform_real_distribution<double> pick(0.0, cumulativeWeights.back());
+    double point = pick(rng);
+    size_t cls = std::upper_bound(cumulativeWeights.begin(), cumulativeWeights.end(), point)
+                 - cumulativeWeights.begin();
+    return static_cast<EncodedDataset::Code>(std::min(cls, cumulativeWeights.size() - 1));
+}
+
+int DataGenerator::plantNode(int depth, std::mt19937& rng) {
+    int index = static_cast<int>(tree.size());
+    tree.emplace_back();
+
+    // Признаки с одним значением разбить нельзя
+    std::vector<size_t> splittable;
+    for (size_t f = 0; f < prototype.featureNames.size(); ++f) {
+        if (prototype.valueNames[f].size() > 1) splittable.push_back(f);
+    }
+    if (depth >= schema.treeDepth || splittable.empty()) {
+        tree[index].label = drawClass(rng);
+        return index;
+    }
+
+    size_t feature = splittable[std::uniform_int_distribution<size_t>(0, splittable.size() - 1)(rng)];
+    size_t cardinality = prototype.valueNames[feature].size();
+    std::vector<bool> left(cardinality, false);
+    if (prototype.numeric[feature]) {
+        // Порог: влево — значения не больше threshold
+        size_t threshold = std::uniform_int_distribution<size_t>(0, cardinality - 2)(rng);
+        for (size_t v = 0; v <= threshold; ++v) left[v] = true;
+    } else {
+        // Случайное непустое собственное подмножество значений
+        size_t leftCount = 0;
+        for (size_t v = 0; v < cardinality; ++v) {
+            left[v] = std::bernoulli_distribution(0.5)(rng);
+            if (left[v]) leftCount++;
+        }
+        if (leftCount == 0 || leftCount == cardinality) left[0] = !left[0];
+    }
+
+    tree[index].feature = static_cast<int>(feature);
+    tree[index].leftValues = std::move(left);
+    int leftChild = plantNode(depth + 1, rng);
+    int rightChild = plantNode(depth + 1, rng);
+    tree[index].left = leftChild;
+    tree[index].right = rightChild;
+    return index;
+}
+
+EncodedDataset::Code DataGenerator::plantedClass(const EncodedDataset& data, size_t row) const {
+    int index = 0;
+    while (tree[index].feature >= 0) {
+        const PlantedNode& node = tree[index];
+        EncodedDataset::Code value = data.getColumn(node.feature)[row];
+        bool isLeft = value < node.leftValues.size() && node.leftValues[value];
+        index = isLeft ? node.left : node.right;
+    }
+    return tree[index].label;
+}
+
+EncodedDataset DataGenerator::generate(size_t rows, unsigned threadCount) const {
+    EncodedDataset data = prototype;
+    for (auto& column : data.columns) column.resize(rows);
+    data.targets.resize(rows);
+
+    size_t featureCount = data.featureNames.size();
+    size_t blocks = (rows + kBlockRows - 1) / kBlockRows;
+    parallelFor(blocks, threadCount, [&](size_t block) {
+        size_t begin = block * kBlockRows;
+        size_t end = std::min(rows, begin + kBlockRows);
+        std::mt19937 rng(static_cast<std::uint32_t>(blockSeed(seed, block)));
+        std::bernoulli_distribution isNoise(schema.noise);
+
+        // Признаки — по столбцам (последовательная запись в память)
+        for (size_t f = 0; f < featureCount; ++f) {
+            std::uniform_int_distribution<EncodedDataset::Code> value(
+                0, static_cast<EncodedDataset::Code>(data.valueNames[f].size() - 1));
+            EncodedDataset::Code* column = data.columns[f].data();
+            for (size_t row = begin; row < end; ++row) column[row] = value(rng);
+        }
+        for (size_t row = begin; row < end; ++row) {
+            data.targets[row] = isNoise(rng) ? drawClass(rng) : plantedClass(data, row);
+        }
+    });
+    return data;
+}
+
+bool DataGenerator::writeCSV(const EncodedDataset& data, const std::string& filename,
+                             unsigned threadCount) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Ошибка открытия файла: " << filename << std::endl;
+        return false;
+    }
+
+    for (size_t f = 0; f < data.getFeatureCount(); ++f) file << data.getFeatureNames()[f] << ",";
+    file << data.getTargetName() << "\n";
+
+    // Группы блоков форматируются параллельно, затем пишутся по порядку,
+    // чтобы в памяти одновременно было ограниченное число строк
+    size_t rows = data.getRowCount();
+    size_t blocks = (rows + kBlockRows - 1) / kBlockRows;
+    size_t group = std::max<size_t>(1, (threadCount == 0 ? defaultThreadCount() : threadCount) * 2);
+    std::vector<std::string> text(group);
+    for (size_t first = 0; first < blocks; first += group) {
+        size_t count = std::min(group, blocks - first);
+        parallelFor(count, threadCount, [&](size_t i) {
+            size_t begin = (first + i) * kBlockRows;
+            size_t end = std::min(rows, begin + kBlockRows);
+            std::string& out = text[i];
+            out.clear();
+            for (size_t row = begin; row < end; ++row) {
+                for (size_t f = 0; f < data.getFeatureCount(); ++f) {
+                    EncodedDataset::Code code = data.getColumn(f)[row];
+                    if (code < data.getCardinality(f)) out += data.getValueNames(f)[code];
+                    out += ',';
+                }
+                out += data.decodeClass(data.getTargets()[row]);
+                out += '\n';
+            }
+        });
+        for (size_t i = 0; i < count; ++i) file << text[i];
+    }
+
+    if (!file) {
+        std::cerr << "Ошибка записи файла: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
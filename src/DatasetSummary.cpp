@@ -0,0 +1,106 @@
+#include "DatasetSummary.h"
+#include "Parallel.h"
+#include <unordered_map>
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+// Примеров в блоке параллельного прохода
+constexpr size_t kSummaryBlock = 65536;
+
+// Частичные счетчики блока: пара «значение, класс» кодируется одной
+// строкой с разделителем, чтобы классы не были нужны заранее
+struct BlockCounts {
+    vector<unordered_map<string, size_t>> pairs;   // по признаку
+    vector<size_t> missing;
+    unordered_map<string, size_t> targets;
+    size_t rows = 0;
+};
+
+const char kSeparator = '\x1f';
+
+} // namespace
+
+DatasetSummary DatasetSummary::compute(const Dataset& dataset, unsigned threadCount) {
+    const auto& examples = dataset.getExamples();
+    const auto& featureNames = dataset.getFeatureNames();
+    size_t featureCount = featureNames.size();
+
+    size_t blockCount = (examples.size() + kSummaryBlock - 1) / kSummaryBlock;
+    vector<BlockCounts> blocks(blockCount);
+    parallelFor(blockCount, threadCount, [&](size_t block) {
+        BlockCounts& counts = blocks[block];
+        counts.pairs.resize(featureCount);
+        counts.missing.assign(featureCount, 0);
+        size_t begin = block * kSummaryBlock;
+        size_t end = min(examples.size(), begin + kSummaryBlock);
+        string key;
+        for (size_t i = begin; i < end; ++i) {
+            const DataExample& example = examples[i];
+            // Пример с кратностью w считается как w одинаковых строк
+            size_t weight = static_cast<size_t>(max(example.weight, 0));
+            counts.rows += weight;
+            counts.targets[example.target] += weight;
+            for (size_t f = 0; f < featureCount; ++f) {
+                auto it = example.features.find(featureNames[f]);
+                if (it == example.features.end() || it->second.empty()) {
+                    counts.missing[f] += weight;
+                    continue;
+                }
+                key.assign(it->second);
+                key += kSeparator;
+                key += example.target;
+                counts.pairs[f][key] += weight;
+            }
+        }
+    });
+
+    // Объединение блоков
+    DatasetSummary summary;
+    summary.targetName = dataset.getTargetName();
+
+    unordered_map<string, size_t> targets;
+    for (const auto& block : blocks) {
+        summary.rows += block.rows;
+        for (const auto& [name, count] : block.targets) targets[name] += count;
+    }
+    for (const auto& entry : targets) summary.classNames.push_back(entry.first);
+    sort(summary.classNames.begin(), summary.classNames.end());
+    unordered_map<string, size_t> classIndex;
+    for (size_t c = 0; c < summary.classNames.size(); ++c) {
+        classIndex[summary.classNames[c]] = c;
+        summary.classCounts.push_back(targets[summary.classNames[c]]);
+    }
+
+    summary.features.resize(featureCount);
+    for (size_t f = 0; f < featureCount; ++f) {
+        FeatureSummary& feature = summary.features[f];
+        feature.name = featureNames[f];
+        unordered_map<string, size_t> valueIndex;
+        for (const auto& block : blocks) {
+            feature.missing += block.missing[f];
+            for (const auto& [key, count] : block.pairs[f]) {
+                size_t split = key.rfind(kSeparator);
+                string value = key.substr(0, split);
+                auto it = valueIndex.find(value);
+                if (it == valueIndex.end()) {
+                    it = valueIndex.emplace(value, feature.values.size()).first;
+                    ValueSummary entry;
+                    entry.value = value;
+                    entry.classCounts.assign(summary.classNames.size(), 0);
+                    feature.values.push_back(move(entry));
+                }
+                ValueSummary& entry = feature.values[it->second];
+                entry.count += count;
+                entry.classCounts[classIndex[key.substr(split + 1)]] += count;
+            }
+        }
+        sort(feature.values.begin(), feature.values.end(),
+             [](const ValueSummary& a, const ValueSummary& b) {
+                 return a.count != b.count ? a.count > b.count : a.value < b.value;
+             });
+    }
+    return summary;
+}
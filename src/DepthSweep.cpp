@@ -0,0 +1,51 @@
+#include "DepthSweep.h"
+#include "Parallel.h"
+#include <algorithm>
+
+namespace {
+
+// Строк в одном блоке параллельного прохода
+const size_t kSweepBlock = 8192;
+
+} // namespace
+
+std::vector<double> DepthSweep::evaluate(const CompiledTree& tree,
+                                         const EncodedDataset& validation,
+                                         int maxDepth,
+                                         unsigned threadCount) {
+    size_t levels = static_cast<size_t>(std::max(0, maxDepth)) + 1;
+    size_t rowCount = validation.getRowCount();
+    std::vector<double> accuracy(levels, 0.0);
+    if (rowCount == 0) return accuracy;
+
+    size_t blocks = (rowCount + kSweepBlock - 1) / kSweepBlock;
+    std::vector<std::vector<std::uint64_t>> blockCorrect(blocks, std::vector<std::uint64_t>(levels, 0));
+    const auto& targets = validation.getTargets();
+
+    parallelFor(blocks, threadCount, [&](size_t block) {
+        size_t begin = block * kSweepBlock;
+        size_t end = std::min(rowCount, begin + kSweepBlock);
+        std::vector<EncodedDataset::Code> byDepth(levels);
+        auto& correct = blockCorrect[block];
+        for (size_t row = begin; row < end; ++row) {
+            tree.predictByDepth(validation, row, maxDepth, byDepth.data());
+            for (size_t d = 0; d < levels; ++d) {
+                if (byDepth[d] == targets[row] && byDepth[d] != EncodedDataset::kMissing) {
+                    correct[d] += validation.getWeight(row);
+                }
+            }
+        }
+    });
+
+    for (const auto& correct : blockCorrect) {
+        for (size_t d = 0; d < levels; ++d) accuracy[d] += correct[d];
+    }
+    double totalWeight = static_cast<double>(validation.getTotalWeight());
+    for (auto& value : accuracy) value /= totalWeight;
+    return accuracy;
+}
+
+int DepthSweep::bestDepth(const std::vector<double>& accuracy) {
+    if (accuracy.empty()) return 0;
+    return static_cast<int>(std::max_element(accuracy.begin(), accuracy.end()) - accuracy.begin());
+}
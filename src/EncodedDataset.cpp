@@ -0,0 +1,407 @@
+#include "EncodedDataset.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+bool parseNumber(const std::string& text, double& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end == text.c_str() + text.size();
+}
+
+// Словарь значений: строки в лексикографическом порядке (как ключи std::map
+// в строковых деревьях), для числовых признаков — по возрастанию числа
+std::vector<std::string> buildDictionary(std::vector<std::string> values, bool& isNumeric) {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+
+    isNumeric = !values.empty();
+    std::vector<std::pair<double, std::string>> parsed;
+    parsed.reserve(values.size());
+    for (const auto& value : values) {
+        double number;
+        if (!parseNumber(value, number)) {
+            isNumeric = false;
+            break;
+        }
+        parsed.emplace_back(number, value);
+    }
+
+    if (isNumeric) {
+        std::sort(parsed.begin(), parsed.end());
+        for (size_t i = 0; i < parsed.size(); ++i) {
+            values[i] = parsed[i].second;
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+EncodedDataset::EncodedDataset(const Dataset& dataset)
+    : EncodedDataset(dataset.getExamples(), dataset.getFeatureNames(), dataset.getTargetName()) {}
+
+EncodedDataset::EncodedDataset(const std::vector<DataExample>& examples,
+                               const std::vector<std::string>& features,
+                               const std::string& targetName)
+    : featureNames(features), targetName(targetName) {
+    size_t count = examples.size();
+    valueNames.resize(featureNames.size());
+    numeric.resize(featureNames.size());
+    columns.assign(featureNames.size(), std::vector<Code>(count, kMissing));
+    targets.assign(count, kMissing);
+
+    // Один проход по столбцу: коды в порядке первого появления через
+    // хеш-таблицу, затем словарь упорядочивается и коды перенумеровываются
+    std::unordered_map<std::string, Code> index;
+    auto codeOf = [&index](const std::string& value) {
+        return index.try_emplace(value, static_cast<Code>(index.size())).first->second;
+    };
+    auto renumber = [&index](std::vector<Code>& codes, const std::vector<std::string>& dictionary) {
+        std::vector<Code> remap(dictionary.size());
+        for (size_t code = 0; code < dictionary.size(); ++code) {
+            remap[index.at(dictionary[code])] = static_cast<Code>(code);
+        }
+        for (auto& code : codes) {
+            if (code != kMissing) code = remap[code];
+        }
+    };
+    auto firstAppearance = [&index]() {
+        std::vector<std::string> values(index.size());
+        for (const auto& [value, code] : index) values[code] = value;
+        return values;
+    };
+
+    for (size_t f = 0; f < featureNames.size(); ++f) {
+        index.clear();
+        std::vector<Code>& column = columns[f];
+        for (size_t row = 0; row < count; ++row) {
+            auto it = examples[row].features.find(featureNames[f]);
+            if (it != examples[row].features.end()) column[row] = codeOf(it->second);
+        }
+        bool isNumericFeature = false;
+        valueNames[f] = buildDictionary(firstAppearance(), isNumericFeature);
+        numeric[f] = isNumericFeature;
+        renumber(column, valueNames[f]);
+    }
+
+    index.clear();
+    for (size_t row = 0; row < count; ++row) targets[row] = codeOf(examples[row].target);
+    classNames = firstAppearance();
+    std::sort(classNames.begin(), classNames.end());
+    renumber(targets, classNames);
+
+    for (size_t row = 0; row < count; ++row) {
+        int weight = examples[row].weight;
+        if (weight != 1 && weights.empty()) weights.assign(count, 1);
+        if (!weights.empty()) weights[row] = static_cast<std::uint32_t>(std::max(weight, 0));
+    }
+}
+
+EncodedDataset::EncodedDataset(const Dataset& dataset, const EncodedDataset& schema)
+    : featureNames(schema.featureNames),
+      targetName(schema.targetName),
+      valueNames(schema.valueNames),
+      numeric(schema.numeric),
+      classNames(schema.classNames) {
+    encodeRows(dataset.getExamples());
+}
+
+void EncodedDataset::encodeRows(const std::vector<DataExample>& examples) {
+    columns.assign(featureNames.size(), std::vector<Code>(examples.size(), kMissing));
+    targets.assign(examples.size(), kMissing);
+    weights.clear();
+
+    for (size_t row = 0; row < examples.size(); ++row) {
+        const auto& ex = examples[row];
+        for (size_t f = 0; f < featureNames.size(); ++f) {
+            auto it = ex.features.find(featureNames[f]);
+            if (it != ex.features.end()) {
+                columns[f][row] = encodeValue(f, it->second);
+            }
+        }
+        targets[row] = encodeClass(ex.target);
+        if (ex.weight != 1 && weights.empty()) weights.assign(examples.size(), 1);
+        if (!weights.empty()) weights[row] = static_cast<std::uint32_t>(std::max(ex.weight, 0));
+    }
+}
+
+int EncodedDataset::findFeature(const std::string& name) const {
+    auto it = std::find(featureNames.begin(), featureNames.end(), name);
+    return it == featureNames.end() ? -1 : static_cast<int>(it - featureNames.begin());
+}
+
+EncodedDataset::Code EncodedDataset::encodeValue(size_t feature, const std::string& value) const {
+    const auto& dictionary = valueNames[feature];
+    if (numeric[feature]) {
+        // Числовой словарь отсортирован по числу, ищем линейно только при промахе
+        double number;
+        if (parseNumber(value, number)) {
+            auto it = std::lower_bound(dictionary.begin(), dictionary.end(), number,
+                [](const std::string& a, double b) { return std::strtod(a.c_str(), nullptr) < b; });
+            if (it != dictionary.end() && *it == value) {
+                return static_cast<Code>(it - dictionary.begin());
+            }
+        }
+        auto it = std::find(dictionary.begin(), dictionary.end(), value);
+        return it == dictionary.end() ? kMissing : static_cast<Code>(it - dictionary.begin());
+    }
+
+    auto it = std::lower_bound(dictionary.begin(), dictionary.end(), value);
+    if (it == dictionary.end() || *it != value) return kMissing;
+    return static_cast<Code>(it - dictionary.begin());
+}
+
+EncodedDataset::Code EncodedDataset::encodeClass(const std::string& className) const {
+    auto it = std::lower_bound(classNames.begin(), classNames.end(), className);
+    if (it == classNames.end() || *it != className) return kMissing;
+    return static_cast<Code>(it - classNames.begin());
+}
+
+const std::string& EncodedDataset::decodeClass(Code code) const {
+    static const std::string unknown = "Unknown";
+    return code < classNames.size() ? classNames[code] : unknown;
+}
+
+std::uint64_t EncodedDataset::fingerprint() const {
+    std::uint64_t hash = 1469598103934665603ull;
+    auto mixByte = [&hash](unsigned char byte) {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    };
+    auto mixCode = [&mixByte](Code code) {
+        for (int byte = 0; byte < 4; ++byte) mixByte(static_cast<unsigned char>(code >> (byte * 8)));
+    };
+    auto mixText = [&mixByte, &mixCode](const std::string& text) {
+        mixCode(static_cast<Code>(text.size()));
+        for (char c : text) mixByte(static_cast<unsigned char>(c));
+    };
+
+    mixText(targetName);
+    for (const auto& name : classNames) mixText(name);
+    for (size_t f = 0; f < featureNames.size(); ++f) {
+        mixText(featureNames[f]);
+        for (const auto& value : valueNames[f]) mixText(value);
+        for (Code code : columns[f]) mixCode(code);
+    }
+    for (Code code : targets) mixCode(code);
+    for (std::uint32_t weight : weights) mixCode(weight);
+    return hash;
+}
+
+std::uint64_t EncodedDataset::getTotalWeight() const {
+    if (weights.empty()) return targets.size();
+    std::uint64_t total = 0;
+    for (std::uint32_t weight : weights) total += weight;
+    return total;
+}
+
+EncodedDataset EncodedDataset::selectRows(const std::vector<std::uint32_t>& rows) const {
+    EncodedDataset subset;
+    subset.featureNames = featureNames;
+    subset.targetName = targetName;
+    subset.valueNames = valueNames;
+    subset.numeric = numeric;
+    subset.classNames = classNames;
+    subset.columns.resize(columns.size());
+    for (size_t f = 0; f < columns.size(); ++f) {
+        const std::vector<Code>& column = columns[f];
+        subset.columns[f].reserve(rows.size());
+        for (std::uint32_t row : rows) subset.columns[f].push_back(column[row]);
+    }
+    subset.targets.reserve(rows.size());
+    for (std::uint32_t row : rows) subset.targets.push_back(targets[row]);
+    if (!weights.empty()) {
+        subset.weights.reserve(rows.size());
+        for (std::uint32_t row : rows) subset.weights.push_back(weights[row]);
+    }
+    return subset;
+}
+
+EncodedDataset EncodedDataset::compressDuplicates() const {
+    // Ключ строки — ее коды подряд (признаки, затем класс)
+    size_t featureCount = columns.size();
+    std::unordered_map<std::string, std::uint32_t> index;
+    std::vector<std::uint32_t> firstRows;
+    std::vector<std::uint32_t> merged;
+    std::string key((featureCount + 1) * sizeof(Code), '\0');
+    for (size_t row = 0; row < targets.size(); ++row) {
+        for (size_t f = 0; f < featureCount; ++f) {
+            std::memcpy(&key[f * sizeof(Code)], &columns[f][row], sizeof(Code));
+        }
+        std::memcpy(&key[featureCount * sizeof(Code)], &targets[row], sizeof(Code));
+        auto [it, inserted] = index.try_emplace(key, static_cast<std::uint32_t>(firstRows.size()));
+        if (inserted) {
+            firstRows.push_back(static_cast<std::uint32_t>(row));
+            merged.push_back(getWeight(row));
+        } else {
+            merged[it->second] += getWeight(row);
+        }
+    }
+
+    // Без повторов кратности не нужны: набор остается прежним
+    if (firstRows.size() == targets.size()) return *this;
+    EncodedDataset compressed = selectRows(firstRows);
+    compressed.weights = std::move(merged);
+    return compressed;
+}
+
+Dataset EncodedDataset::decode(size_t maxRows) const {
+    Dataset dataset;
+    dataset.setSchema(featureNames, targetName);
+    size_t rowCount = getRowCount();
+    size_t count = std::min(rowCount, maxRows);
+    for (size_t i = 0; i < count; ++i) {
+        size_t row = count == rowCount ? i : i * rowCount / count;
+        DataExample example;
+        example.id = static_cast<int>(row + 1);
+        for (size_t f = 0; f < featureNames.size(); ++f) {
+            Code code = columns[f][row];
+            if (code < valueNames[f].size()) example.features[featureNames[f]] = valueNames[f][code];
+        }
+        example.target = decodeClass(targets[row]);
+        example.weight = static_cast<int>(getWeight(row));
+        dataset.addExample(example);
+    }
+    return dataset;
+}
+
+namespace {
+
+const char kBinaryMagic[4] = {'E', 'N', 'C', 'D'};
+// Версия 2 добавляет кратности строк после столбца классов
+const std::uint32_t kBinaryVersion = 2;
+
+void writeU64(std::ofstream& out, std::uint64_t value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeString(std::ofstream& out, const std::string& text) {
+    writeU64(out, text.size());
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+bool readU64(std::ifstream& in, std::uint64_t& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+bool readString(std::ifstream& in, std::string& text) {
+    std::uint64_t size = 0;
+    if (!readU64(in, size) || size > (1u << 20)) return false;
+    text.resize(size);
+    return static_cast<bool>(in.read(&text[0], static_cast<std::streamsize>(size)));
+}
+
+} // namespace
+
+bool EncodedDataset::saveBinary(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Ошибка открытия файла: " << filename << std::endl;
+        return false;
+    }
+
+    out.write(kBinaryMagic, sizeof(kBinaryMagic));
+    out.write(reinterpret_cast<const char*>(&kBinaryVersion), sizeof(kBinaryVersion));
+    writeU64(out, featureNames.size());
+    writeU64(out, targets.size());
+    writeString(out, targetName);
+    for (size_t f = 0; f < featureNames.size(); ++f) {
+        writeString(out, featureNames[f]);
+        writeU64(out, numeric[f] ? 1 : 0);
+        writeU64(out, valueNames[f].size());
+        for (const auto& value : valueNames[f]) writeString(out, value);
+    }
+    writeU64(out, classNames.size());
+    for (const auto& className : classNames) writeString(out, className);
+
+    for (const auto& column : columns) {
+        out.write(reinterpret_cast<const char*>(column.data()),
+                  static_cast<std::streamsize>(column.size() * sizeof(Code)));
+    }
+    out.write(reinterpret_cast<const char*>(targets.data()),
+              static_cast<std::streamsize>(targets.size() * sizeof(Code)));
+    writeU64(out, weights.empty() ? 0 : 1);
+    out.write(reinterpret_cast<const char*>(weights.data()),
+              static_cast<std::streamsize>(weights.size() * sizeof(std::uint32_t)));
+
+    if (!out) {
+        std::cerr << "Ошибка записи файла: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool EncodedDataset::loadBinary(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Ошибка открытия файла: " << filename << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    std::uint32_t version = 0;
+    std::uint64_t featureCount = 0, rowCount = 0;
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, kBinaryMagic) ||
+        !in.read(reinterpret_cast<char*>(&version), sizeof(version)) || version < 1 || version > kBinaryVersion ||
+        !readU64(in, featureCount) || !readU64(in, rowCount) || !readString(in, targetName)) {
+        std::cerr << "Неверный формат файла: " << filename << std::endl;
+        return false;
+    }
+
+    featureNames.assign(featureCount, "");
+    numeric.assign(featureCount, false);
+    valueNames.assign(featureCount, {});
+    for (size_t f = 0; f < featureCount; ++f) {
+        std::uint64_t isNumericFeature = 0, valueCount = 0;
+        if (!readString(in, featureNames[f]) || !readU64(in, isNumericFeature) || !readU64(in, valueCount)) {
+            std::cerr << "Неверный формат файла: " << filename << std::endl;
+            return false;
+        }
+        numeric[f] = isNumericFeature != 0;
+        valueNames[f].resize(valueCount);
+        for (auto& value : valueNames[f]) {
+            if (!readString(in, value)) {
+                std::cerr << "Неверный формат файла: " << filename << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::uint64_t classCount = 0;
+    if (!readU64(in, classCount)) {
+        std::cerr << "Неверный формат файла: " << filename << std::endl;
+        return false;
+    }
+    classNames.resize(classCount);
+    for (auto& className : classNames) {
+        if (!readString(in, className)) {
+            std::cerr << "Неверный формат файла: " << filename << std::endl;
+            return false;
+        }
+    }
+
+    columns.assign(featureCount, std::vector<Code>(rowCount));
+    targets.resize(rowCount);
+    for (auto& column : columns) {
+        in.read(reinterpret_cast<char*>(column.data()), static_cast<std::streamsize>(rowCount * sizeof(Code)));
+    }
+    in.read(reinterpret_cast<char*>(targets.data()), static_cast<std::streamsize>(rowCount * sizeof(Code)));
+    weights.clear();
+    std::uint64_t hasWeights = 0;
+    if (version >= 2 && readU64(in, hasWeights) && hasWeights != 0) {
+        weights.resize(rowCount);
+        in.read(reinterpret_cast<char*>(weights.data()), static_cast<std::streamsize>(rowCount * sizeof(std::uint32_t)));
+    }
+    if (!in) {
+        std::cerr << "Файл обрезан: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,307 @@
+#include "ExperimentManifest.h"
+#include "DataGenerator.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item = trim(item);
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+bool parseDouble(const std::string& text, double& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtod(text.c_str(), &end);
+    return errno == 0 && *end == '\0';
+}
+
+bool parseUnsigned(const std::string& text, unsigned long long& value) {
+    if (text.empty() || text[0] == '-') return false;
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoull(text.c_str(), &end, 10);
+    return errno == 0 && *end == '\0';
+}
+
+size_t fileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file.is_open() ? static_cast<size_t>(file.tellg()) : 0;
+}
+
+} // namespace
+
+size_t DatasetSpec::estimateBytes() const {
+    if (source == "generate") {
+        size_t columns = GeneratorSchema::makeDefault().features.size() + 1;
+        return rows * columns * sizeof(std::uint32_t);
+    }
+    // CSV кодируется через строковый Dataset (строка — словарь признаков),
+    // поэтому на время загрузки занимает в разы больше файла
+    if (source == "csv") return fileSize(path) * 8;
+    if (source == "binary") return fileSize(path);
+    return size_t(64) << 10;
+}
+
+std::string ExperimentJob::label() const {
+    std::string text = algorithm;
+    for (const auto& [name, value] : parameters) text += " " + name + "=" + value;
+    return text + " seed=" + std::to_string(seed);
+}
+
+const std::vector<std::string>& ExperimentManifest::parameterNames(const std::string& algorithm) {
+    static const std::map<std::string, std::vector<std::string>> names = {
+        {"ID3", {"max_depth"}},
+        {"C4.5", {"max_depth", "min_samples_split", "min_gain_ratio"}},
+        {"CART", {"max_depth", "min_samples_split", "min_impurity_decrease"}},
+        {"CHAID", {"max_depth", "significance_level"}},
+        {"RandomForest", {"trees", "max_features", "max_depth", "min_samples_split"}},
+        {"ExtraTrees", {"trees", "max_features", "max_depth", "min_samples_split"}},
+        {"GradientBoosting", {"rounds", "learning_rate", "max_leaves", "max_depth", "min_data_in_leaf"}}
+    };
+    static const std::vector<std::string> unknown;
+    auto it = names.find(algorithm);
+    return it != names.end() ? it->second : unknown;
+}
+
+bool ExperimentManifest::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Ошибка открытия манифеста: " << filename << std::endl;
+        return false;
+    }
+    return parse(file, filename);
+}
+
+bool ExperimentManifest::parse(std::istream& input, const std::string& sourceName) {
+    settings = BatchSettings();
+    datasets.clear();
+    experiments.clear();
+
+    enum class Section { None, Batch, Dataset, Experiment } section = Section::None;
+    std::string line;
+    int lineNumber = 0;
+    auto fail = [&](const std::string& message) {
+        std::cerr << sourceName << ":" << lineNumber << ": " << message << std::endl;
+        return false;
+    };
+
+    while (std::getline(input, line)) {
+        lineNumber++;
+        size_t comment = line.find_first_of("#;");
+        if (comment != std::string::npos) line.erase(comment);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        if (line.front() == '[') {
+            if (line.back() != ']') return fail("незакрытый заголовок секции");
+            std::string header = trim(line.substr(1, line.size() - 2));
+            size_t space = header.find(' ');
+            std::string kind = header.substr(0, space);
+            std::string name = space == std::string::npos ? "" : trim(header.substr(space + 1));
+            if (kind == "batch") {
+                section = Section::Batch;
+            } else if (kind == "dataset" || kind == "experiment") {
+                if (name.empty()) return fail("у секции " + kind + " нет имени");
+                if (kind == "dataset") {
+                    if (findDataset(name) >= 0) return fail("набор " + name + " объявлен повторно");
+                    section = Section::Dataset;
+                    datasets.emplace_back();
+                    datasets.back().name = name;
+                } else {
+                    section = Section::Experiment;
+                    experiments.emplace_back();
+                    experiments.back().name = name;
+                }
+            } else {
+                return fail("неизвестная секция: " + kind);
+            }
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) return fail("ожидалось «ключ = значение»");
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        unsigned long long number = 0;
+        double real = 0.0;
+
+        if (section == Section::Batch) {
+            if (key == "workers") {
+                if (!parseUnsigned(value, number)) return fail("workers — целое число");
+                settings.workers = static_cast<unsigned>(number);
+            } else if (key == "memory_limit_mb") {
+                if (!parseUnsigned(value, number)) return fail("memory_limit_mb — целое число");
+                settings.memoryLimit = static_cast<size_t>(number) << 20;
+            } else if (key == "output") {
+                settings.outputDirectory = value;
+            } else if (key == "reports") {
+                settings.reports = value == "yes" || value == "true" || value == "1";
+            } else {
+                return fail("неизвестный ключ секции batch: " + key);
+            }
+        } else if (section == Section::Dataset) {
+            DatasetSpec& dataset = datasets.back();
+            if (key == "source") {
+                if (value != "builtin" && value != "generate" && value != "csv" && value != "binary") {
+                    return fail("source — builtin, generate, csv или binary");
+                }
+                dataset.source = value;
+            } else if (key == "path") {
+                dataset.path = value;
+            } else if (key == "features") {
+                dataset.features = splitList(value);
+            } else if (key == "target") {
+                dataset.target = value;
+            } else if (key == "rows") {
+                if (!parseUnsigned(value, number)) return fail("rows — целое число");
+                dataset.rows = static_cast<size_t>(number);
+            } else if (key == "seed") {
+                if (!parseUnsigned(value, number)) return fail("seed — целое число");
+                dataset.seed = static_cast<std::uint32_t>(number);
+            } else if (key == "test_share") {
+                if (!parseDouble(value, real) || real <= 0.0 || real >= 1.0) {
+                    return fail("test_share — число от 0 до 1");
+                }
+                dataset.testShare = real;
+            } else if (key == "compress") {
+                dataset.compress = value == "yes" || value == "true" || value == "1";
+            } else {
+                return fail("неизвестный ключ набора данных: " + key);
+            }
+        } else if (section == Section::Experiment) {
+            ExperimentSpec& experiment = experiments.back();
+            std::vector<std::string> values = splitList(value);
+            if (values.empty()) return fail("пустой список значений: " + key);
+            if (key == "datasets") {
+                experiment.datasets = values;
+            } else if (key == "algorithms") {
+                experiment.algorithms = values;
+            } else if (key == "seeds") {
+                experiment.seeds.clear();
+                for (const auto& item : values) {
+                    if (!parseUnsigned(item, number)) return fail("seeds — целые числа");
+                    experiment.seeds.push_back(static_cast<std::uint32_t>(number));
+                }
+            } else {
+                for (const auto& item : values) {
+                    if (!parseDouble(item, real)) return fail("значение параметра " + key + " не число: " + item);
+                }
+                experiment.parameters[key] = values;
+            }
+        } else {
+            return fail("ключ вне секции: " + key);
+        }
+    }
+
+    return validate(sourceName);
+}
+
+bool ExperimentManifest::validate(const std::string& sourceName) const {
+    auto fail = [&](const std::string& message) {
+        std::cerr << sourceName << ": " << message << std::endl;
+        return false;
+    };
+
+    for (const auto& dataset : datasets) {
+        if ((dataset.source == "csv" || dataset.source == "binary") && dataset.path.empty()) {
+            return fail("у набора " + dataset.name + " не задан path");
+        }
+        if (dataset.source == "generate" && dataset.rows == 0) {
+            return fail("у набора " + dataset.name + " не задано rows");
+        }
+    }
+    if (experiments.empty()) return fail("нет ни одной секции experiment");
+
+    for (const auto& experiment : experiments) {
+        if (experiment.datasets.empty() || experiment.algorithms.empty()) {
+            return fail("в эксперименте " + experiment.name + " нужны datasets и algorithms");
+        }
+        for (const auto& name : experiment.datasets) {
+            if (findDataset(name) < 0) return fail("неизвестный набор данных: " + name);
+        }
+        std::set<std::string> used;
+        for (const auto& algorithm : experiment.algorithms) {
+            const auto& names = parameterNames(algorithm);
+            if (names.empty()) return fail("неизвестный алгоритм: " + algorithm);
+            used.insert(names.begin(), names.end());
+        }
+        for (const auto& [name, values] : experiment.parameters) {
+            if (!used.count(name)) {
+                return fail("параметр " + name + " не используется алгоритмами эксперимента " + experiment.name);
+            }
+        }
+    }
+    return true;
+}
+
+int ExperimentManifest::findDataset(const std::string& name) const {
+    for (size_t i = 0; i < datasets.size(); ++i) {
+        if (datasets[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+std::vector<ExperimentJob> ExperimentManifest::expandJobs() const {
+    std::vector<ExperimentJob> jobs;
+    for (const auto& experiment : experiments) {
+        for (const auto& datasetName : experiment.datasets) {
+            size_t dataset = static_cast<size_t>(findDataset(datasetName));
+            for (const auto& algorithm : experiment.algorithms) {
+                // Значения только используемых алгоритмом параметров
+                std::vector<std::pair<std::string, const std::vector<std::string>*>> axes;
+                for (const auto& name : parameterNames(algorithm)) {
+                    auto it = experiment.parameters.find(name);
+                    if (it != experiment.parameters.end()) axes.emplace_back(name, &it->second);
+                }
+
+                // Перебор декартова произведения «одометром» по индексам значений
+                std::vector<size_t> position(axes.size(), 0);
+                while (true) {
+                    for (std::uint32_t seed : experiment.seeds) {
+                        ExperimentJob job;
+                        job.experiment = experiment.name;
+                        job.dataset = dataset;
+                        job.algorithm = algorithm;
+                        job.seed = seed;
+                        for (size_t a = 0; a < axes.size(); ++a) {
+                            job.parameters.emplace_back(axes[a].first, (*axes[a].second)[position[a]]);
+                        }
+                        jobs.push_back(job);
+                    }
+                    size_t axis = 0;
+                    while (axis < axes.size() && ++position[axis] == axes[axis].second->size()) {
+                        position[axis++] = 0;
+                    }
+                    if (axis == axes.size()) break;
+                }
+            }
+        }
+    }
+
+    // Задания одного набора подряд: набор выгружается после последнего из них
+    std::stable_sort(jobs.begin(), jobs.end(),
+        [](const ExperimentJob& a, const ExperimentJob& b) { return a.dataset < b.dataset; });
+    for (size_t i = 0; i < jobs.size(); ++i) jobs[i].id = i + 1;
+    return jobs;
+}
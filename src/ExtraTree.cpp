@@ -0,0 +1,67 @@
+#include "ExtraTree.h"
+
+namespace {
+
+// Вытягивание случайного разбиения по таблице значений признака:
+// ordered — порог между наименьшим и наибольшим встретившимся значением,
+// иначе — случайное непустое собственное подмножество встретившихся значений
+std::vector<bool> drawLeftValues(const std::vector<bool>& observed, bool ordered,
+                                 std::mt19937& rng) {
+    std::vector<size_t> present;
+    for (size_t v = 0; v < observed.size(); ++v) {
+        if (observed[v]) present.push_back(v);
+    }
+    std::vector<bool> left(observed.size(), false);
+    if (present.size() < 2) return {};
+
+    if (ordered) {
+        std::uniform_int_distribution<size_t> pick(0, present.size() - 2);
+        size_t threshold = present[pick(rng)];
+        for (size_t v = 0; v <= threshold; ++v) left[v] = true;
+        return left;
+    }
+
+    std::bernoulli_distribution coin(0.5);
+    size_t leftCount = 0;
+    for (size_t v : present) {
+        left[v] = coin(rng);
+        if (left[v]) leftCount++;
+    }
+    // Обе ветви должны быть непустыми
+    if (leftCount == 0 || leftCount == present.size()) {
+        std::uniform_int_distribution<size_t> pick(0, present.size() - 1);
+        size_t flip = present[pick(rng)];
+        left[flip] = !left[flip];
+    }
+    return left;
+}
+
+} // namespace
+
+SplitCandidate ExtraSplitCriterion::evaluate(const ContingencyTable& table, std::mt19937& rng) const {
+    SplitCandidate candidate;
+
+    std::vector<bool> observed(table.values);
+    for (size_t v = 0; v < table.values; ++v) observed[v] = table.valueTotals[v] > 0.0;
+    std::vector<bool> left = drawLeftValues(observed, table.ordered, rng);
+    if (left.empty()) return candidate;
+
+    // Прирост Джини для бинарного разбиения из той же таблицы подсчета
+    std::vector<double> leftCounts(table.classes, 0.0), rightCounts(table.classes, 0.0);
+    double leftTotal = 0.0;
+    for (size_t v = 0; v < table.values; ++v) {
+        std::vector<double>& side = left[v] ? leftCounts : rightCounts;
+        for (size_t c = 0; c < table.classes; ++c) side[c] += table.at(v, c);
+        if (left[v]) leftTotal += table.valueTotals[v];
+    }
+    double rightTotal = table.total - leftTotal;
+
+    double gain = giniOf(table.classTotals.data(), table.classes, table.total)
+                - leftTotal / table.total * giniOf(leftCounts.data(), table.classes, leftTotal)
+                - rightTotal / table.total * giniOf(rightCounts.data(), table.classes, rightTotal);
+    if (gain > 0.0) {
+        candidate.score = gain;
+        candidate.leftValues = std::move(left);
+    }
+    return candidate;
+}
@@ -0,0 +1,176 @@
+#include "GradientBoosting.h"
+#include "Parallel.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// Строк в одном блоке параллельной обработки
+const size_t kRowBlock = 16384;
+
+template <typename Fn>
+void forRowBlocks(size_t rowCount, unsigned threads, Fn&& fn) {
+    size_t blocks = (rowCount + kRowBlock - 1) / kRowBlock;
+    parallelFor(blocks, threads, [&](size_t block) {
+        size_t begin = block * kRowBlock;
+        fn(begin, std::min(rowCount, begin + kRowBlock));
+    });
+}
+
+} // namespace
+
+void GradientBoosting::train(const EncodedDataset& data) {
+    size_t rowCount = data.getRowCount();
+    classCount = data.getClassCount();
+    outputCount = classCount <= 2 ? 1 : classCount;
+    trees.clear();
+    if (rowCount == 0 || classCount < 2) return;
+
+    binMapper = BinnedDataset(data, maxBins);
+    const auto& targets = data.getTargets();
+
+    // Начальные оценки — логарифмы априорных частот классов; строки
+    // с неизвестным классом (kMissing) в обучении не участвуют
+    std::vector<double> prior(classCount, 0.0);
+    for (size_t row = 0; row < rowCount; ++row) {
+        if (targets[row] < classCount) prior[targets[row]] += data.getWeight(row);
+    }
+    double totalWeight = 0.0;
+    for (double classWeight : prior) totalWeight += classWeight;
+    if (totalWeight == 0.0) return;
+    baseScores.assign(outputCount, 0.0);
+    if (outputCount == 1) {
+        double p = std::min(std::max(prior[1] / totalWeight, 1e-6), 1.0 - 1e-6);
+        baseScores[0] = std::log(p / (1.0 - p));
+    } else {
+        for (size_t k = 0; k < classCount; ++k) {
+            baseScores[k] = std::log(std::max(prior[k] / totalWeight, 1e-6));
+        }
+    }
+
+    // Оценки хранятся по строкам: scores[row * outputCount + k]
+    std::vector<double> scores(rowCount * outputCount);
+    for (size_t row = 0; row < rowCount; ++row) {
+        std::copy(baseScores.begin(), baseScores.end(), scores.begin() + row * outputCount);
+    }
+
+    std::vector<std::vector<float>> gradients(outputCount, std::vector<float>(rowCount));
+    std::vector<std::vector<float>> hessians(outputCount, std::vector<float>(rowCount));
+    std::vector<double> rowOutputs;
+    trees.reserve(static_cast<size_t>(rounds) * outputCount);
+
+    for (int round = 0; round < rounds; ++round) {
+        // Градиенты и гессианы функции потерь по текущим оценкам; у строки
+        // сжатого набора они умножены на кратность (суммы в гистограммах те же,
+        // что без сжатия; minDataInLeaf считается по различным строкам),
+        // у строки без класса — нулевые
+        forRowBlocks(rowCount, threadCount, [&](size_t begin, size_t end) {
+            std::vector<double> probabilities(outputCount);
+            for (size_t row = begin; row < end; ++row) {
+                const double* rowScores = scores.data() + row * outputCount;
+                auto target = targets[row];
+                double weight = target < classCount ? data.getWeight(row) : 0.0;
+                if (outputCount == 1) {
+                    double p = 1.0 / (1.0 + std::exp(-rowScores[0]));
+                    gradients[0][row] = static_cast<float>(weight * (p - (target == 1 ? 1.0 : 0.0)));
+                    hessians[0][row] = static_cast<float>(weight * std::max(p * (1.0 - p), 1e-16));
+                    continue;
+                }
+                double maxScore = *std::max_element(rowScores, rowScores + outputCount);
+                double sum = 0.0;
+                for (size_t k = 0; k < outputCount; ++k) {
+                    probabilities[k] = std::exp(rowScores[k] - maxScore);
+                    sum += probabilities[k];
+                }
+                for (size_t k = 0; k < outputCount; ++k) {
+                    double p = probabilities[k] / sum;
+                    gradients[k][row] = static_cast<float>(weight * (p - (target == k ? 1.0 : 0.0)));
+                    hessians[k][row] = static_cast<float>(weight * std::max(p * (1.0 - p), 1e-16));
+                }
+            }
+        });
+
+        for (size_t k = 0; k < outputCount; ++k) {
+            trees.emplace_back();
+            trees.back().fitGradientHistogram(binMapper, gradients[k], hessians[k], treeParams, rowOutputs);
+            for (size_t row = 0; row < rowCount; ++row) {
+                scores[row * outputCount + k] += rowOutputs[row];
+            }
+        }
+    }
+}
+
+std::vector<double> GradientBoosting::predictRaw(const EncodedDataset& data) const {
+    size_t rowCount = data.getRowCount();
+    std::vector<double> scores(rowCount * outputCount);
+    if (rowCount == 0 || outputCount == 0) return scores;
+
+    BinnedDataset binned(data, binMapper);
+    forRowBlocks(rowCount, threadCount, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row) {
+            std::copy(baseScores.begin(), baseScores.end(), scores.begin() + row * outputCount);
+        }
+        for (size_t t = 0; t < trees.size(); ++t) {
+            size_t k = t % outputCount;
+            for (size_t row = begin; row < end; ++row) {
+                scores[row * outputCount + k] += trees[t].predictRegression(binned, row);
+            }
+        }
+    });
+    return scores;
+}
+
+std::vector<EncodedDataset::Code> GradientBoosting::predictBatch(const EncodedDataset& data) const {
+    std::vector<EncodedDataset::Code> predictions(data.getRowCount(), EncodedDataset::kMissing);
+    if (outputCount == 0) return predictions;
+
+    auto scores = predictRaw(data);
+    for (size_t row = 0; row < predictions.size(); ++row) {
+        const double* rowScores = scores.data() + row * outputCount;
+        if (outputCount == 1) {
+            predictions[row] = rowScores[0] > 0.0 ? 1 : 0;
+        } else {
+            predictions[row] = static_cast<EncodedDataset::Code>(
+                std::max_element(rowScores, rowScores + outputCount) - rowScores);
+        }
+    }
+    return predictions;
+}
+
+std::vector<double> GradientBoosting::predictProba(const EncodedDataset& data) const {
+    std::vector<double> probabilities(data.getRowCount() * classCount, 0.0);
+    if (outputCount == 0 || classCount < 2) return probabilities;
+
+    auto scores = predictRaw(data);
+    for (size_t row = 0; row < data.getRowCount(); ++row) {
+        const double* rowScores = scores.data() + row * outputCount;
+        double* out = probabilities.data() + row * classCount;
+        if (outputCount == 1) {
+            out[1] = 1.0 / (1.0 + std::exp(-rowScores[0]));
+            out[0] = 1.0 - out[1];
+        } else {
+            double maxScore = *std::max_element(rowScores, rowScores + outputCount);
+            double sum = 0.0;
+            for (size_t k = 0; k < outputCount; ++k) {
+                out[k] = std::exp(rowScores[k] - maxScore);
+                sum += out[k];
+            }
+            for (size_t k = 0; k < outputCount; ++k) out[k] /= sum;
+        }
+    }
+    return probabilities;
+}
+
+double GradientBoosting::evaluate(const EncodedDataset& testSet) const {
+    if (testSet.getRowCount() == 0) return 0.0;
+
+    auto predictions = predictBatch(testSet);
+    const auto& targets = testSet.getTargets();
+    std::uint64_t correct = 0, labelled = 0;
+    for (size_t row = 0; row < predictions.size(); ++row) {
+        if (targets[row] >= classCount) continue;
+        labelled += testSet.getWeight(row);
+        if (predictions[row] == targets[row]) correct += testSet.getWeight(row);
+    }
+    return labelled > 0 ? static_cast<double>(correct) / labelled : 0.0;
+}
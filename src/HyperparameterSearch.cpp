@@ -0,0 +1,187 @@
+#include "HyperparameterSearch.h"
+#include "CrossValidation.h"
+#include "CompiledTree.h"
+#include "SplitStatsCache.h"
+#include "Parallel.h"
+#include "ID3.h"
+#include "C45.h"
+#include "CART.h"
+#include "CHAID.h"
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+std::unique_ptr<DecisionTree> TuningConfig::makeTree() const {
+    if (algorithm == "ID3") {
+        auto tree = std::make_unique<ID3Tree>();
+        tree->setMaxDepth(maxDepth);
+        return tree;
+    }
+    if (algorithm == "C4.5") {
+        auto tree = std::make_unique<C45Tree>();
+        tree->setMaxDepth(maxDepth);
+        tree->setMinSamplesSplit(minSamplesSplit);
+        tree->setMinGainRatio(minGainRatio);
+        return tree;
+    }
+    if (algorithm == "CART") {
+        auto tree = std::make_unique<CARTTree>();
+        tree->setMaxDepth(maxDepth);
+        tree->setMinSamplesSplit(minSamplesSplit);
+        tree->setMinImpurityDecrease(minImpurityDecrease);
+        return tree;
+    }
+    if (algorithm == "CHAID") {
+        auto tree = std::make_unique<CHAIDTree>();
+        tree->setMaxDepth(maxDepth);
+        tree->setSignificanceLevel(significanceLevel);
+        return tree;
+    }
+    return nullptr;
+}
+
+std::string TuningConfig::toString() const {
+    std::ostringstream out;
+    out << algorithm << " maxDepth=" << maxDepth;
+    if (algorithm == "C4.5" || algorithm == "CART") out << " minSamplesSplit=" << minSamplesSplit;
+    if (algorithm == "C4.5") out << " minGainRatio=" << minGainRatio;
+    if (algorithm == "CART") out << " minImpurityDecrease=" << minImpurityDecrease;
+    if (algorithm == "CHAID") out << " significanceLevel=" << significanceLevel;
+    return out.str();
+}
+
+HyperparameterSearch::HyperparameterSearch(int folds, std::uint32_t seed)
+    : folds(std::max(2, folds)), seed(seed) {}
+
+std::vector<TuningConfig> HyperparameterSearch::gridConfigs(const std::string& algorithm,
+                                                            const ParameterGrid& grid) {
+    // Неиспользуемые алгоритмом параметры не размножают сетку
+    bool usesMinSamples = algorithm == "C4.5" || algorithm == "CART";
+    std::vector<int> minSamples = usesMinSamples ? grid.minSamplesSplits : std::vector<int>{2};
+    std::vector<double> significance = algorithm == "CHAID" ? grid.significanceLevels
+                                                            : std::vector<double>{0.05};
+    std::vector<double> gainRatios = algorithm == "C4.5" ? grid.minGainRatios
+                                                         : std::vector<double>{0.01};
+    std::vector<double> decreases = algorithm == "CART" ? grid.minImpurityDecreases
+                                                        : std::vector<double>{0.0};
+
+    std::vector<TuningConfig> configs;
+    for (int depth : grid.maxDepths)
+        for (int samples : minSamples)
+            for (double alpha : significance)
+                for (double ratio : gainRatios)
+                    for (double decrease : decreases) {
+                        TuningConfig config;
+                        config.algorithm = algorithm;
+                        config.maxDepth = depth;
+                        config.minSamplesSplit = samples;
+                        config.significanceLevel = alpha;
+                        config.minGainRatio = ratio;
+                        config.minImpurityDecrease = decrease;
+                        configs.push_back(config);
+                    }
+    return configs;
+}
+
+std::vector<TuningConfig> HyperparameterSearch::randomConfigs(const std::string& algorithm,
+                                                              const ParameterGrid& grid,
+                                                              size_t count, std::uint32_t seed) {
+    std::vector<TuningConfig> configs = gridConfigs(algorithm, grid);
+    std::mt19937 rng(seed);
+    std::shuffle(configs.begin(), configs.end(), rng);
+    if (configs.size() > count) configs.resize(count);
+    return configs;
+}
+
+std::vector<TuningResult> HyperparameterSearch::evaluate(const EncodedDataset& data,
+                                                         const std::vector<TuningConfig>& configs) {
+    auto testFolds = CrossValidation::stratifiedFolds(data, folds, seed);
+    const auto& targets = data.getTargets();
+
+    // Веса обучающей части и кэш узлов — по одному на фолд
+    std::vector<std::vector<std::uint32_t>> foldWeights(folds);
+    std::vector<std::unique_ptr<SplitStatsCache>> caches(folds);
+    for (int fold = 0; fold < folds; ++fold) {
+        foldWeights[fold].resize(data.getRowCount());
+        for (size_t row = 0; row < data.getRowCount(); ++row) foldWeights[fold][row] = data.getWeight(row);
+        for (auto row : testFolds[fold]) foldWeights[fold][row] = 0;
+        if (cacheEnabled) {
+            caches[fold] = std::make_unique<SplitStatsCache>(data, foldWeights[fold], maxCacheEntries);
+        }
+    }
+
+    // Глубокие конфигурации первыми: они заполняют кэш узлами, которые
+    // затем целиком переиспользуют более мелкие деревья того же фолда
+    std::vector<size_t> order(configs.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return configs[a].maxDepth > configs[b].maxDepth;
+    });
+
+    std::vector<double> accuracy(configs.size() * folds, 0.0);
+    std::vector<double> time(configs.size() * folds, 0.0);
+    std::vector<int> nodes(configs.size() * folds, 0);
+
+    parallelFor(accuracy.size(), threadCount, [&](size_t task) {
+        size_t config = order[task % configs.size()];
+        size_t fold = task / configs.size();
+        size_t slot = config * folds + fold;
+
+        auto tree = configs[config].makeTree();
+        if (!tree) return;
+        EncodedTrainOptions options;
+        options.cache = caches[fold].get();
+
+        auto start = std::chrono::steady_clock::now();
+        tree->trainEncoded(data, foldWeights[fold], options);
+        auto end = std::chrono::steady_clock::now();
+
+        CompiledTree compiled(*tree, data);
+        const auto& testRows = testFolds[fold];
+        std::uint64_t correct = 0, total = 0;
+        for (auto row : testRows) {
+            if (compiled.predictRow(data, row) == targets[row]) correct += data.getWeight(row);
+            total += data.getWeight(row);
+        }
+        accuracy[slot] = total == 0 ? 0.0 : static_cast<double>(correct) / total;
+        time[slot] = std::chrono::duration<double>(end - start).count();
+        nodes[slot] = tree->countNodes(tree->getRoot());
+    });
+
+    cacheHits = 0;
+    cacheMisses = 0;
+    for (const auto& cache : caches) {
+        if (!cache) continue;
+        cacheHits += cache->getHitCount();
+        cacheMisses += cache->getMissCount();
+    }
+
+    std::vector<TuningResult> results;
+    for (size_t config = 0; config < configs.size(); ++config) {
+        TuningResult result;
+        result.config = configs[config];
+        double nodeSum = 0.0;
+        for (int fold = 0; fold < folds; ++fold) {
+            size_t slot = config * folds + fold;
+            result.accuracy += accuracy[slot];
+            result.trainingTime += time[slot];
+            nodeSum += nodes[slot];
+        }
+        result.accuracy /= folds;
+        for (int fold = 0; fold < folds; ++fold) {
+            double diff = accuracy[config * folds + fold] - result.accuracy;
+            result.accuracyStd += diff * diff;
+        }
+        result.accuracyStd = std::sqrt(result.accuracyStd / (folds - 1));
+        result.nodeCount = static_cast<int>(std::lround(nodeSum / folds));
+        results.push_back(result);
+    }
+
+    // При равной точности предпочтительнее меньшее дерево
+    std::stable_sort(results.begin(), results.end(), [](const TuningResult& a, const TuningResult& b) {
+        if (a.accuracy != b.accuracy) return a.accuracy > b.accuracy;
+        return a.nodeCount < b.nodeCount;
+    });
+    return results;
+}
@@ -0,0 +1,121 @@
+#include "LatencyBenchmark.h"
+#include "CompiledTree.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+namespace {
+
+// Результат, который оптимизатор не может выбросить
+volatile size_t sink = 0;
+
+uint64_t elapsedNs(Clock::time_point start, Clock::time_point end) {
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+}
+
+// Минимальная стоимость пары чтений часов
+uint64_t clockOverhead() {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 1000; ++i) {
+        auto start = Clock::now();
+        auto end = Clock::now();
+        best = min(best, elapsedNs(start, end));
+    }
+    return best;
+}
+
+} // namespace
+
+LatencyBenchmark::LatencyBenchmark(size_t decisions, vector<size_t> batchSizes)
+    : decisions(max<size_t>(decisions, 1)), batchSizes(move(batchSizes)) {}
+
+LatencyDistribution LatencyBenchmark::summarize(const string& path, size_t batchSize,
+                                                const LatencyHistogram& histogram,
+                                                double seconds, uint64_t decisions) {
+    LatencyDistribution result;
+    result.path = path;
+    result.batchSize = batchSize;
+    result.samples = histogram.getCount();
+    result.p50 = static_cast<double>(histogram.valueAtPercentile(50.0));
+    result.p90 = static_cast<double>(histogram.valueAtPercentile(90.0));
+    result.p99 = static_cast<double>(histogram.valueAtPercentile(99.0));
+    result.p999 = static_cast<double>(histogram.valueAtPercentile(99.9));
+    result.max = static_cast<double>(histogram.getMax());
+    result.mean = histogram.getMean();
+    result.rowsPerSecond = seconds > 0.0 ? decisions / seconds : 0.0;
+    return result;
+}
+
+vector<LatencyDistribution> LatencyBenchmark::measure(const DecisionTree& tree,
+                                                      const Dataset& rows,
+                                                      const EncodedDataset& schema) const {
+    vector<LatencyDistribution> results;
+    const auto& examples = rows.getExamples();
+    if (examples.empty()) return results;
+
+    EncodedDataset encoded(rows, schema);
+    CompiledTree compiled(tree, schema);
+    size_t rowCount = encoded.getRowCount();
+    uint64_t overhead = clockOverhead();
+    LatencyHistogram histogram;
+
+    auto timed = [&](auto&& call) {
+        auto start = Clock::now();
+        call();
+        uint64_t ns = elapsedNs(start, Clock::now());
+        histogram.record(ns > overhead ? ns - overhead : 0);
+    };
+
+    // Строковый путь: predict по DataExample
+    {
+        histogram.reset();
+        auto start = Clock::now();
+        for (size_t i = 0; i < decisions; ++i) {
+            const DataExample& example = examples[i % examples.size()];
+            timed([&]() { sink = sink + tree.predict(example).size(); });
+        }
+        double seconds = chrono::duration<double>(Clock::now() - start).count();
+        results.push_back(summarize("predict", 1, histogram, seconds, decisions));
+    }
+
+    // Скомпилированное дерево, по одной строке
+    {
+        histogram.reset();
+        auto start = Clock::now();
+        for (size_t i = 0; i < decisions; ++i) {
+            size_t row = i % rowCount;
+            timed([&]() { sink = sink + compiled.predictRow(encoded, row); });
+        }
+        double seconds = chrono::duration<double>(Clock::now() - start).count();
+        results.push_back(summarize("compiled", 1, histogram, seconds, decisions));
+    }
+
+    // Пакеты фиксированного размера: поток строк идет по кругу,
+    // пакет длиннее выборки проходит ее несколькими отрезками
+    for (size_t batchSize : batchSizes) {
+        if (batchSize == 0) continue;
+        histogram.reset();
+        vector<EncodedDataset::Code> out(batchSize);
+        size_t batches = max<size_t>(1, decisions / batchSize);
+        size_t cursor = 0;
+        auto start = Clock::now();
+        for (size_t b = 0; b < batches; ++b) {
+            timed([&]() {
+                size_t done = 0;
+                while (done < batchSize) {
+                    size_t end = min(rowCount, cursor + (batchSize - done));
+                    compiled.predictBatch(encoded, cursor, end, out.data() + done);
+                    done += end - cursor;
+                    cursor = end == rowCount ? 0 : end;
+                }
+                sink = sink + out[batchSize / 2];
+            });
+        }
+        double seconds = chrono::duration<double>(Clock::now() - start).count();
+        results.push_back(summarize("batch " + to_string(batchSize), batchSize, histogram,
+                                    seconds, static_cast<uint64_t>(batches) * batchSize));
+    }
+    return results;
+}
@@ -0,0 +1,81 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+int highestBit(std::uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) bit++;
+    return bit;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram(int precisionBits)
+    : precisionBits(std::max(2, std::min(precisionBits, 16))) {
+    exactLimit = std::uint64_t(1) << this->precisionBits;
+    halfRange = exactLimit / 2;
+    counts.assign(exactLimit, 0);
+}
+
+size_t LatencyHistogram::indexOf(std::uint64_t value) const {
+    if (value < exactLimit) return static_cast<size_t>(value);
+    // Сдвиг оставляет precisionBits значащих битов: value >> shift ∈ [halfRange, exactLimit)
+    int shift = highestBit(value) - (precisionBits - 1);
+    std::uint64_t sub = (value >> shift) - halfRange;
+    return static_cast<size_t>(exactLimit + (shift - 1) * halfRange + sub);
+}
+
+std::uint64_t LatencyHistogram::upperBoundOf(size_t index) const {
+    if (index < exactLimit) return index;
+    std::uint64_t offset = index - exactLimit;
+    int shift = static_cast<int>(offset / halfRange) + 1;
+    std::uint64_t sub = offset % halfRange + halfRange;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t nanoseconds) {
+    size_t index = indexOf(nanoseconds);
+    if (index >= counts.size()) counts.resize(index + 1, 0);
+    counts[index]++;
+    if (count == 0 || nanoseconds < minValue) minValue = nanoseconds;
+    maxValue = std::max(maxValue, nanoseconds);
+    count++;
+    sum += nanoseconds;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.count == 0) return;
+    if (other.precisionBits != precisionBits) {
+        // Разная точность — перенос по верхним границам ячеек
+        for (size_t i = 0; i < other.counts.size(); ++i) {
+            for (std::uint64_t n = 0; n < other.counts[i]; ++n) record(other.upperBoundOf(i));
+        }
+        return;
+    }
+    if (other.counts.size() > counts.size()) counts.resize(other.counts.size(), 0);
+    for (size_t i = 0; i < other.counts.size(); ++i) counts[i] += other.counts[i];
+    minValue = count == 0 ? other.minValue : std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    count += other.count;
+    sum += other.sum;
+}
+
+void LatencyHistogram::reset() {
+    counts.assign(exactLimit, 0);
+    count = sum = minValue = maxValue = 0;
+}
+
+std::uint64_t LatencyHistogram::valueAtPercentile(double percentile) const {
+    if (count == 0) return 0;
+    double clamped = std::max(0.0, std::min(percentile, 100.0));
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * count));
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(upperBoundOf(i), maxValue);
+    }
+    return maxValue;
+}
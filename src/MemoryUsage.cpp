@@ -0,0 +1,147 @@
+#include "MemoryUsage.h"
+#include <unordered_set>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// Служебная часть узла красно-черного дерева std::map (цвет и три указателя)
+constexpr size_t kMapNodeOverhead = 4 * sizeof(void*);
+
+// Блок управления shared_ptr, размещенный make_shared вместе с объектом
+constexpr size_t kSharedControlBlock = 2 * sizeof(void*);
+
+size_t heapBytes(const string& text) {
+    static const size_t inlineCapacity = string().capacity();
+    return text.capacity() > inlineCapacity ? text.capacity() + 1 : 0;
+}
+
+template <typename T>
+size_t vectorBytes(const vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+
+size_t stringsBytes(const vector<string>& values) {
+    size_t bytes = 0;
+    for (const auto& value : values) bytes += heapBytes(value);
+    return bytes;
+}
+
+template <typename Map>
+size_t mapNodeBytes(const Map& map) {
+    return map.size() * (kMapNodeOverhead + sizeof(typename Map::value_type));
+}
+
+void addNode(const TreeNode& node, MemoryBreakdown& usage,
+             unordered_set<const TreeNode*>& visited) {
+    if (!visited.insert(&node).second) return;
+    usage.nodes += sizeof(TreeNode) + kSharedControlBlock;
+    usage.strings += heapBytes(node.feature) + heapBytes(node.decision);
+    usage.children += mapNodeBytes(node.children);
+    usage.statistics += vectorBytes(node.classCounts);
+    for (const auto& [value, child] : node.children) {
+        usage.strings += heapBytes(value);
+        if (child) addNode(*child, usage, visited);
+    }
+}
+
+} // namespace
+
+MemoryBreakdown MemoryUsage::ofDataset(const Dataset& dataset) {
+    MemoryBreakdown usage;
+    const auto& examples = dataset.getExamples();
+    usage.nodes += vectorBytes(examples);
+    for (const auto& example : examples) {
+        usage.strings += heapBytes(example.target);
+        usage.children += mapNodeBytes(example.features);
+        for (const auto& [name, value] : example.features) {
+            usage.strings += heapBytes(name) + heapBytes(value);
+        }
+    }
+    usage.statistics += vectorBytes(dataset.getFeatureNames());
+    usage.strings += stringsBytes(dataset.getFeatureNames());
+
+    // Значения признаков по столбцам (копия всех ячеек)
+    const auto& featureValues = dataset.getFeatureValues();
+    usage.children += mapNodeBytes(featureValues);
+    for (const auto& [name, values] : featureValues) {
+        usage.strings += heapBytes(name) + stringsBytes(values);
+        usage.statistics += vectorBytes(values);
+    }
+    return usage;
+}
+
+MemoryBreakdown MemoryUsage::ofEncoded(const EncodedDataset& data) {
+    MemoryBreakdown usage;
+    for (size_t f = 0; f < data.getFeatureCount(); ++f) {
+        usage.statistics += vectorBytes(data.getColumn(f)) + vectorBytes(data.getValueNames(f));
+        usage.strings += heapBytes(data.getFeatureNames()[f]) + stringsBytes(data.getValueNames(f));
+    }
+    usage.statistics += vectorBytes(data.getTargets()) + vectorBytes(data.getWeights()) +
+                        vectorBytes(data.getClassNames());
+    usage.strings += stringsBytes(data.getClassNames());
+    return usage;
+}
+
+MemoryBreakdown MemoryUsage::ofTree(const DecisionTree& tree) {
+    MemoryBreakdown usage;
+    if (tree.getRoot()) {
+        unordered_set<const TreeNode*> visited;
+        addNode(*tree.getRoot(), usage, visited);
+    }
+    return usage;
+}
+
+size_t MemoryUsage::currentResidentBytes() {
+#if defined(__linux__)
+    ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    if (statm >> pages >> resident) {
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+size_t MemoryUsage::peakResidentBytes() {
+#if defined(__linux__)
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return static_cast<size_t>(atoll(line.c_str() + 6)) * 1024;
+        }
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+    return 0;
+}
+
+string MemoryUsage::formatBytes(size_t bytes) {
+    stringstream ss;
+    if (bytes < 1024) {
+        ss << bytes << " Б";
+    } else if (bytes < 1024 * 1024) {
+        ss << fixed << setprecision(1) << bytes / 1024.0 << " КБ";
+    } else {
+        ss << fixed << setprecision(2) << bytes / (1024.0 * 1024.0) << " МБ";
+    }
+    return ss.str();
+}
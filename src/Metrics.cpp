@@ -0,0 +1,194 @@
+#include "Metrics.h"
+#include "Parallel.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kBlockRows = 1 << 16;
+constexpr double kMinProbability = 1e-15;
+
+// Частичные итоги блока строк
+struct PartialCounts {
+    std::vector<std::uint64_t> confusion;
+    std::uint64_t rows = 0;            // с учетом кратностей
+    double logLoss = 0.0;
+    std::uint64_t logLossRows = 0;
+    // classCount × kAucBins: строки класса и строки остальных классов
+    // по интервалам вероятности этого класса
+    std::vector<std::uint64_t> positives;
+    std::vector<std::uint64_t> negatives;
+};
+
+double safeRatio(double numerator, double denominator) {
+    return denominator > 0.0 ? numerator / denominator : 0.0;
+}
+
+double f1Of(double precision, double recall) {
+    return precision + recall > 0.0 ? 2.0 * precision * recall / (precision + recall) : 0.0;
+}
+
+// Площадь под ROC-кривой по гистограммам: пары (положительный, отрицательный),
+// где положительный в более высоком интервале, плюс половина пар одного интервала
+double aucOf(const std::uint64_t* positives, const std::uint64_t* negatives, size_t bins) {
+    double positiveTotal = 0.0, negativeTotal = 0.0;
+    for (size_t b = 0; b < bins; ++b) {
+        positiveTotal += positives[b];
+        negativeTotal += negatives[b];
+    }
+    if (positiveTotal == 0.0 || negativeTotal == 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double pairs = 0.0, negativesBelow = 0.0;
+    for (size_t b = 0; b < bins; ++b) {
+        pairs += positives[b] * (negativesBelow + 0.5 * negatives[b]);
+        negativesBelow += negatives[b];
+    }
+    return pairs / (positiveTotal * negativeTotal);
+}
+
+} // namespace
+
+ClassificationMetrics MetricsEngine::evaluate(const Code* actual,
+                                              const Code* predicted,
+                                              size_t rows,
+                                              size_t classCount,
+                                              const double* probabilities,
+                                              unsigned threads,
+                                              const std::uint32_t* weights) {
+    const size_t stride = classCount + 1;
+    const size_t blocks = (rows + kBlockRows - 1) / kBlockRows;
+    std::vector<PartialCounts> partials(blocks);
+
+    parallelFor(blocks, threads, [&](size_t block) {
+        size_t begin = block * kBlockRows;
+        size_t end = std::min(rows, begin + kBlockRows);
+        PartialCounts& part = partials[block];
+        part.confusion.assign(stride * stride, 0);
+
+        // Неизвестные коды сводятся к последнему индексу без ветвлений
+        std::uint64_t* confusion = part.confusion.data();
+        if (weights) {
+            for (size_t row = begin; row < end; ++row) {
+                size_t a = std::min<size_t>(actual[row], classCount);
+                size_t p = std::min<size_t>(predicted[row], classCount);
+                confusion[a * stride + p] += weights[row];
+                part.rows += weights[row];
+            }
+        } else {
+            for (size_t row = begin; row < end; ++row) {
+                size_t a = std::min<size_t>(actual[row], classCount);
+                size_t p = std::min<size_t>(predicted[row], classCount);
+                confusion[a * stride + p]++;
+            }
+            part.rows = end - begin;
+        }
+
+        if (!probabilities) return;
+        part.positives.assign(classCount * kAucBins, 0);
+        part.negatives.assign(classCount * kAucBins, 0);
+        for (size_t row = begin; row < end; ++row) {
+            Code a = actual[row];
+            if (a >= classCount) continue;
+            std::uint32_t weight = weights ? weights[row] : 1;
+            const double* rowProbabilities = probabilities + row * classCount;
+            part.logLoss -= weight * std::log(std::max(rowProbabilities[a], kMinProbability));
+            part.logLossRows += weight;
+            for (size_t c = 0; c < classCount; ++c) {
+                double p = std::clamp(rowProbabilities[c], 0.0, 1.0);
+                size_t bin = std::min(kAucBins - 1, static_cast<size_t>(p * kAucBins));
+                (c == a ? part.positives : part.negatives)[c * kAucBins + bin] += weight;
+            }
+        }
+    });
+
+    // Сложение частичных итогов в порядке блоков (результат детерминирован)
+    ClassificationMetrics metrics;
+    metrics.classCount = classCount;
+    metrics.confusion.assign(stride * stride, 0);
+    std::vector<std::uint64_t> positives, negatives;
+    if (probabilities) {
+        positives.assign(classCount * kAucBins, 0);
+        negatives.assign(classCount * kAucBins, 0);
+    }
+    double logLoss = 0.0;
+    std::uint64_t logLossRows = 0;
+    for (const auto& part : partials) {
+        for (size_t i = 0; i < part.confusion.size(); ++i) metrics.confusion[i] += part.confusion[i];
+        for (size_t i = 0; i < part.positives.size(); ++i) {
+            positives[i] += part.positives[i];
+            negatives[i] += part.negatives[i];
+        }
+        logLoss += part.logLoss;
+        logLossRows += part.logLossRows;
+        metrics.total += part.rows;
+    }
+
+    // Метрики из матрицы ошибок; неизвестный предсказанный класс — всегда ошибка
+    std::uint64_t correct = 0, predictedKnown = 0, actualKnown = 0;
+    metrics.perClass.resize(classCount);
+    size_t presentClasses = 0;
+    for (size_t c = 0; c < classCount; ++c) {
+        std::uint64_t truePositives = metrics.at(c, c);
+        std::uint64_t predictedTotal = 0, actualTotal = 0;
+        for (size_t other = 0; other < stride; ++other) {
+            predictedTotal += metrics.at(other, c);
+            actualTotal += metrics.at(c, other);
+        }
+        correct += truePositives;
+        predictedKnown += predictedTotal;
+        actualKnown += actualTotal;
+
+        ClassMetrics& cls = metrics.perClass[c];
+        cls.support = actualTotal;
+        cls.precision = safeRatio(truePositives, predictedTotal);
+        cls.recall = safeRatio(truePositives, actualTotal);
+        cls.f1Score = f1Of(cls.precision, cls.recall);
+        if (probabilities) {
+            cls.auc = aucOf(positives.data() + c * kAucBins, negatives.data() + c * kAucBins, kAucBins);
+        }
+
+        // Макроусреднение — по классам, встретившимся в выборке или в предсказаниях
+        if (actualTotal == 0 && predictedTotal == 0) continue;
+        presentClasses++;
+        metrics.macroPrecision += cls.precision;
+        metrics.macroRecall += cls.recall;
+        metrics.macroF1 += cls.f1Score;
+    }
+    metrics.macroPrecision = safeRatio(metrics.macroPrecision, presentClasses);
+    metrics.macroRecall = safeRatio(metrics.macroRecall, presentClasses);
+    metrics.macroF1 = safeRatio(metrics.macroF1, presentClasses);
+
+    metrics.accuracy = safeRatio(correct, metrics.total);
+    metrics.microPrecision = safeRatio(correct, predictedKnown);
+    metrics.microRecall = safeRatio(correct, actualKnown);
+    metrics.microF1 = f1Of(metrics.microPrecision, metrics.microRecall);
+
+    if (probabilities) {
+        if (logLossRows > 0) metrics.logLoss = logLoss / logLossRows;
+        double aucSum = 0.0;
+        size_t aucClasses = 0;
+        for (const auto& cls : metrics.perClass) {
+            if (std::isnan(cls.auc)) continue;
+            aucSum += cls.auc;
+            aucClasses++;
+        }
+        if (aucClasses > 0) metrics.macroAuc = aucSum / aucClasses;
+    }
+    return metrics;
+}
+
+ClassificationMetrics MetricsEngine::evaluate(const std::vector<Code>& actual,
+                                              const std::vector<Code>& predicted,
+                                              size_t classCount,
+                                              const std::vector<double>& probabilities,
+                                              unsigned threads,
+                                              const std::vector<std::uint32_t>& weights) {
+    size_t rows = std::min(actual.size(), predicted.size());
+    bool withProbabilities = probabilities.size() >= rows * classCount && !probabilities.empty();
+    bool withWeights = weights.size() >= rows && !weights.empty();
+    return evaluate(actual.data(), predicted.data(), rows, classCount,
+                    withProbabilities ? probabilities.data() : nullptr, threads,
+                    withWeights ? weights.data() : nullptr);
+}
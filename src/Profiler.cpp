@@ -0,0 +1,145 @@
+#include "Profiler.h"
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+// Счетчики одного потока. Пишет только поток-владелец (load + store без
+// атомарного сложения), читает collect() после завершения обучения
+struct ThreadCounters {
+    std::array<std::atomic<std::uint64_t>, kProfilePhaseCount> calls{};
+    std::array<std::atomic<std::uint64_t>, kProfilePhaseCount> nanoseconds{};
+    std::atomic<std::uint64_t> nodes{0};
+    std::atomic<int> maxDepth{0};
+
+    ThreadCounters();
+    ~ThreadCounters();
+
+    void addTo(ProfileSnapshot& snapshot) const {
+        for (size_t p = 0; p < kProfilePhaseCount; ++p) {
+            snapshot.phases[p].calls += calls[p].load(std::memory_order_relaxed);
+            snapshot.phases[p].nanoseconds += nanoseconds[p].load(std::memory_order_relaxed);
+        }
+        snapshot.nodes += nodes.load(std::memory_order_relaxed);
+        snapshot.maxDepth = std::max(snapshot.maxDepth, maxDepth.load(std::memory_order_relaxed));
+    }
+
+    void clear() {
+        for (size_t p = 0; p < kProfilePhaseCount; ++p) {
+            calls[p].store(0, std::memory_order_relaxed);
+            nanoseconds[p].store(0, std::memory_order_relaxed);
+        }
+        nodes.store(0, std::memory_order_relaxed);
+        maxDepth.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Живые потоки и итог завершившихся
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadCounters*> live;
+    ProfileSnapshot retired;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+ThreadCounters::ThreadCounters() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.live.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    addTo(reg.retired);
+    reg.live.erase(std::remove(reg.live.begin(), reg.live.end(), this), reg.live.end());
+}
+
+ThreadCounters& localCounters() {
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+void bump(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // namespace
+
+const char* ProfileSnapshot::phaseName(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::Counting: return "Подсчет статистики";
+        case ProfilePhase::Impurity: return "Оценка критерия";
+        case ProfilePhase::SplitSearch: return "Поиск разбиения";
+        case ProfilePhase::Partition: return "Разбиение строк";
+        case ProfilePhase::NodeAllocation: return "Создание узлов";
+    }
+    return "";
+}
+
+void Profiler::add(ProfilePhase phase, std::uint64_t nanoseconds) {
+    ThreadCounters& counters = localCounters();
+    size_t index = static_cast<size_t>(phase);
+    bump(counters.calls[index], 1);
+    bump(counters.nanoseconds[index], nanoseconds);
+}
+
+void Profiler::addNode(int depth) {
+    if (!isEnabled()) return;
+    ThreadCounters& counters = localCounters();
+    bump(counters.nodes, 1);
+    if (depth > counters.maxDepth.load(std::memory_order_relaxed)) {
+        counters.maxDepth.store(depth, std::memory_order_relaxed);
+    }
+}
+
+ProfileSnapshot Profiler::collect() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    ProfileSnapshot snapshot = reg.retired;
+    for (const ThreadCounters* counters : reg.live) counters->addTo(snapshot);
+    return snapshot;
+}
+
+void Profiler::reset() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.retired = ProfileSnapshot();
+    for (ThreadCounters* counters : reg.live) counters->clear();
+}
+
+ProfileSnapshot Profiler::collectThread() {
+    ProfileSnapshot snapshot;
+    localCounters().addTo(snapshot);
+    return snapshot;
+}
+
+void Profiler::resetThread() {
+    localCounters().clear();
+}
+
+double Profiler::threadCpuSeconds() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+std::string Profiler::formatSeconds(double seconds) {
+    std::stringstream ss;
+    if (seconds < 1e-3) {
+        ss << std::fixed << std::setprecision(1) << seconds * 1e6 << " мкс";
+    } else if (seconds < 1.0) {
+        ss << std::fixed << std::setprecision(2) << seconds * 1e3 << " мс";
+    } else {
+        ss << std::fixed << std::setprecision(3) << seconds << " с";
+    }
+    return ss.str();
+}
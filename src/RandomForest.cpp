@@ -0,0 +1,167 @@
+#include "RandomForest.h"
+#include "Parallel.h"
+#include <cmath>
+#include <map>
+
+namespace {
+
+// Строк в одном блоке пакетного предсказания: голоса блока помещаются в кэш
+const size_t kPredictBlock = 4096;
+
+std::vector<const TreeNode*> collectRoots(const std::vector<std::unique_ptr<DecisionTree>>& trees) {
+    std::vector<const TreeNode*> roots;
+    roots.reserve(trees.size());
+    for (const auto& tree : trees) roots.push_back(tree->getRoot().get());
+    return roots;
+}
+
+} // namespace
+
+RandomForest::RandomForest(TreeFactory factory) : factory(std::move(factory)) {}
+
+void RandomForest::train(const EncodedDataset& data) {
+    size_t rowCount = data.getRowCount();
+    classCount = data.getClassCount();
+
+    EncodedTrainOptions baseOptions;
+    baseOptions.maxFeatures = maxFeatures > 0
+        ? maxFeatures
+        : std::max(1, static_cast<int>(std::sqrt(static_cast<double>(data.getFeatureCount()))));
+
+    trees.clear();
+    compiledTrees.clear();
+    if (rowCount == 0 || treeCount <= 0) return;
+    trees.resize(treeCount);
+    compiledTrees.resize(treeCount);
+
+    parallelFor(static_cast<size_t>(treeCount), threadCount, [&](size_t t) {
+        // Зерно зависит только от номера дерева: результат не зависит
+        // от распределения деревьев по потокам
+        std::mt19937 rng(seed + static_cast<std::uint32_t>(t) * 7919u);
+
+        std::vector<std::uint32_t> counts;
+        if (bootstrap && data.getWeights().empty()) {
+            counts.assign(rowCount, 0);
+            std::uniform_int_distribution<size_t> pick(0, rowCount - 1);
+            for (size_t i = 0; i < rowCount; ++i) {
+                counts[pick(rng)]++;
+            }
+        } else if (bootstrap) {
+            // Сжатый набор: та же полиномиальная выборка из всех исходных
+            // строк, но по строке за шаг — число выборов строки биномиально
+            // при оставшемся числе выборов и доле ее кратности в остатке
+            counts.assign(rowCount, 0);
+            std::uint64_t remainingDraws = data.getTotalWeight();
+            std::uint64_t remainingWeight = remainingDraws;
+            for (size_t i = 0; i < rowCount && remainingDraws > 0; ++i) {
+                std::uint32_t weight = data.getWeight(i);
+                if (weight == 0) continue;
+                double share = static_cast<double>(weight) / remainingWeight;
+                std::binomial_distribution<std::uint64_t> draw(remainingDraws, std::min(1.0, share));
+                std::uint64_t picked = draw(rng);
+                counts[i] = static_cast<std::uint32_t>(picked);
+                remainingDraws -= picked;
+                remainingWeight -= weight;
+            }
+        }
+
+        EncodedTrainOptions options = baseOptions;
+        options.seed = static_cast<std::uint32_t>(rng());
+
+        auto tree = factory();
+        tree->trainEncoded(data, counts, options);
+        compiledTrees[t] = CompiledTree(*tree, data);
+        trees[t] = std::move(tree);
+    });
+}
+
+std::vector<EncodedDataset::Code> RandomForest::predictBatch(const EncodedDataset& data) const {
+    size_t rowCount = data.getRowCount();
+    std::vector<EncodedDataset::Code> predictions(rowCount, EncodedDataset::kMissing);
+    if (compiledTrees.empty() || classCount == 0) return predictions;
+
+    size_t blocks = (rowCount + kPredictBlock - 1) / kPredictBlock;
+    parallelFor(blocks, threadCount, [&](size_t block) {
+        size_t begin = block * kPredictBlock;
+        size_t end = std::min(rowCount, begin + kPredictBlock);
+        std::vector<std::uint32_t> votes((end - begin) * classCount, 0);
+
+        for (const auto& tree : compiledTrees) {
+            for (size_t row = begin; row < end; ++row) {
+                EncodedDataset::Code cls = tree.predictRow(data, row);
+                if (cls < classCount) votes[(row - begin) * classCount + cls]++;
+            }
+        }
+
+        for (size_t row = begin; row < end; ++row) {
+            const std::uint32_t* rowVotes = votes.data() + (row - begin) * classCount;
+            size_t best = 0;
+            for (size_t c = 1; c < classCount; ++c) {
+                if (rowVotes[c] > rowVotes[best]) best = c;
+            }
+            if (rowVotes[best] > 0) predictions[row] = static_cast<EncodedDataset::Code>(best);
+        }
+    });
+
+    return predictions;
+}
+
+std::vector<double> RandomForest::predictProba(const EncodedDataset& data) const {
+    size_t rowCount = data.getRowCount();
+    std::vector<double> shares(rowCount * classCount, 0.0);
+    if (compiledTrees.empty() || classCount == 0) return shares;
+
+    double weight = 1.0 / compiledTrees.size();
+    size_t blocks = (rowCount + kPredictBlock - 1) / kPredictBlock;
+    parallelFor(blocks, threadCount, [&](size_t block) {
+        size_t begin = block * kPredictBlock;
+        size_t end = std::min(rowCount, begin + kPredictBlock);
+        for (const auto& tree : compiledTrees) {
+            for (size_t row = begin; row < end; ++row) {
+                EncodedDataset::Code cls = tree.predictRow(data, row);
+                if (cls < classCount) shares[row * classCount + cls] += weight;
+            }
+        }
+    });
+    return shares;
+}
+
+std::string RandomForest::predict(const DataExample& example) const {
+    std::map<std::string, int> votes;
+    for (const auto& tree : trees) {
+        std::string prediction = tree->predict(example);
+        if (prediction != "Unknown") votes[prediction]++;
+    }
+
+    std::string majorityClass = "Unknown";
+    int maxCount = 0;
+    for (const auto& [className, count] : votes) {
+        if (count > maxCount) {
+            maxCount = count;
+            majorityClass = className;
+        }
+    }
+    return majorityClass;
+}
+
+double RandomForest::evaluate(const EncodedDataset& testSet) const {
+    if (testSet.getRowCount() == 0) return 0.0;
+
+    auto predictions = predictBatch(testSet);
+    const auto& targets = testSet.getTargets();
+    std::uint64_t correct = 0;
+    for (size_t row = 0; row < predictions.size(); ++row) {
+        if (predictions[row] != EncodedDataset::kMissing && predictions[row] == targets[row]) {
+            correct += testSet.getWeight(row);
+        }
+    }
+    return static_cast<double>(correct) / testSet.getTotalWeight();
+}
+
+bool RandomForest::saveToDot(const std::string& filename, const ExportOptions& options) const {
+    return TreeExporter(options).writeDot(collectRoots(trees), filename);
+}
+
+bool RandomForest::saveToJSON(const std::string& filename, const ExportOptions& options) const {
+    return TreeExporter(options).writeJSON(collectRoots(trees), filename);
+}
@@ -1,17 +1,566 @@
 #include "ReportGenerator.h"
+#include "ReportStream.h"
+#include "Parallel.h"
+#include "ReportScript.h"
 #include <fstream>
+#include <filesystem>
 #include <iomanip>
 #include <algorithm>
 #include <sstream>
+#include <cmath>
+#include <unordered_map>
 
 using namespace std;
 
+namespace {
+
+// Значение метрики; для результатов кросс-валидации — «среднее ± отклонение»
+string formatMetric(double mean, double stddev, int folds, int precision) {
+    stringstream ss;
+    ss << fixed << setprecision(precision) << mean;
+    if (folds > 1) {
+        ss << " ± " << fixed << setprecision(precision) << stddev;
+    }
+    return ss.str();
+}
+
+// Время обучения с единицей по величине; для кросс-валидации — «среднее ± отклонение»
+string formatDuration(double mean, double stddev, int folds) {
+    string text = Profiler::formatSeconds(mean);
+    if (folds > 1) text += " ± " + Profiler::formatSeconds(stddev);
+    return text;
+}
+
+// Результаты основного протокола оценки — с наибольшим числом фолдов:
+// средние кросс-валидации не сравниваются с одним разбиением
+vector<const AlgorithmResult*> comparableResults(const vector<AlgorithmResult>& results) {
+    int maxFolds = 0;
+    for (const auto& result : results) maxFolds = max(maxFolds, result.folds);
+    vector<const AlgorithmResult*> comparable;
+    for (const auto& result : results) {
+        if (result.folds == maxFolds) comparable.push_back(&result);
+    }
+    return comparable;
+}
+
+// Лучший по точности среди сравнимых результатов (первый при равенстве)
+const AlgorithmResult& bestByAccuracy(const vector<AlgorithmResult>& results) {
+    auto comparable = comparableResults(results);
+    return **max_element(comparable.begin(), comparable.end(),
+        [](const AlgorithmResult* a, const AlgorithmResult* b) {
+            return a->accuracy < b->accuracy;
+        });
+}
+
+// Необязательная метрика: NaN — прочерк
+string formatOptional(double value, int precision) {
+    if (std::isnan(value)) return "—";
+    stringstream ss;
+    ss << fixed << setprecision(precision) << value;
+    return ss.str();
+}
+
+// Время фазы в миллисекундах и число замеров
+string formatPhase(const PhaseStats& stats) {
+    stringstream ss;
+    ss << fixed << setprecision(3) << stats.nanoseconds / 1e6 << " мс / " << stats.calls;
+    return ss.str();
+}
+
+// Замер RSS; 0 — не измерялся (модель обучалась одновременно с другими)
+string formatResident(size_t bytes) {
+    return bytes > 0 ? MemoryUsage::formatBytes(bytes) : "—";
+}
+
+// Выделения фазы: число и объем
+string formatAllocations(const AllocationStats& stats) {
+    return to_string(stats.count) + " / " + MemoryUsage::formatBytes(static_cast<size_t>(stats.bytes));
+}
+
+// Выделений на единицу (узел, строку); прочерк — делить не на что
+string formatPerUnit(std::uint64_t count, size_t units) {
+    if (units == 0) return "—";
+    stringstream ss;
+    ss << fixed << setprecision(2) << static_cast<double>(count) / units;
+    return ss.str();
+}
+
+// Экранирование значений данных для HTML
+string htmlEscape(const string& text) {
+    string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '<': result += "&lt;"; break;
+            case '>': result += "&gt;"; break;
+            case '&': result += "&amp;"; break;
+            case '\'': result += "&#39;"; break;
+            default: result += c;
+        }
+    }
+    return result;
+}
+
+// Описания известных признаков предметной области (прочие — без описания)
+string featureDescription(const string& feature) {
+    static const map<string, string> descriptions = {
+        {"Ставка", "Процентная ставка по кредиту"},
+        {"Срок_рассмотрения", "Время рассмотрения заявки"},
+        {"Требования_к_залогу", "Требуемое обеспечение"},
+        {"Репутация_банка", "Репутация банка на рынке"}
+    };
+    auto it = descriptions.find(feature);
+    return it != descriptions.end() ? it->second : "—";
+}
+
+// Доля в процентах с одним знаком
+string formatShare(size_t count, size_t total) {
+    stringstream ss;
+    ss << fixed << setprecision(1) << (total ? 100.0 * count / total : 0.0) << "%";
+    return ss.str();
+}
+
+// Значений признака в сводной таблице; остальные — одной строкой «прочие»
+constexpr size_t kSummaryValues = 20;
+
+// Заголовок и строки таблицы примеров (признаки — по схеме набора)
+void writeTableHeader(ostream& out, const Dataset& dataset) {
+    out << "<table class='data-table'>\n<tr><th>№</th>";
+    for (const auto& feature : dataset.getFeatureNames()) out << "<th>" << htmlEscape(feature) << "</th>";
+    out << "<th>" << htmlEscape(dataset.getTargetName()) << "</th></tr>\n";
+}
+
+void writeExampleRow(ostream& out, const Dataset& dataset, const DataExample& example) {
+    out << "<tr><td>" << example.id << "</td>";
+    for (const auto& feature : dataset.getFeatureNames()) {
+        auto it = example.features.find(feature);
+        out << "<td>" << (it != example.features.end() ? htmlEscape(it->second) : "—") << "</td>";
+    }
+    out << "<td><strong>" << htmlEscape(example.target) << "</strong></td></tr>\n";
+}
+
+// Каталог страниц строк: «<отчет без расширения>_rows»
+string pageDirectory(const string& reportFilename) {
+    size_t dot = reportFilename.rfind('.');
+    size_t slash = reportFilename.rfind('/');
+    string stem = dot != string::npos && (slash == string::npos || dot > slash)
+        ? reportFilename.substr(0, dot) : reportFilename;
+    return stem + "_rows";
+}
+
+string pageName(size_t page) {
+    stringstream ss;
+    ss << "rows_" << setw(5) << setfill('0') << page + 1 << ".html";
+    return ss.str();
+}
+
+const ProfilePhase kReportPhases[] = {
+    ProfilePhase::SplitSearch, ProfilePhase::Counting, ProfilePhase::Impurity,
+    ProfilePhase::Partition, ProfilePhase::NodeAllocation
+};
+
+// Ссылки на SVG деревьев из отчета в output/reports (пути — от output/)
+string writeTreeImages(const vector<AlgorithmResult>& results) {
+    stringstream html;
+    bool any = false;
+    for (const auto& result : results) {
+        if (result.svgFilePath.empty()) continue;
+        string path = result.svgFilePath;
+        if (path.rfind("output/", 0) == 0) path = "../" + path.substr(7);
+        if (!any) html << "    <div style='display:flex;flex-wrap:wrap;gap:20px;'>\n";
+        any = true;
+        html << "        <div style='border:1px solid #ddd;padding:10px;border-radius:5px;'>\n"
+             << "            <h3>" << htmlEscape(result.algorithmName) << "</h3>\n"
+             << "            <a href='" << htmlEscape(path) << "'><img src='" << htmlEscape(path)
+             << "' style='max-width:480px;max-height:360px;' alt='" << htmlEscape(result.algorithmName) << "'></a>\n"
+             << "        </div>\n";
+    }
+    if (any) html << "    </div>\n";
+    else html << "    <p>Изображения деревьев не построены.</p>\n";
+    return html.str();
+}
+
+// Все строки страницами в отдельных файлах рядом с отчетом (страницы
+// пишутся параллельно) и ссылка на первую страницу
+void writeRowPages(ostream& out, const Dataset& dataset, const string& reportFilename,
+                   const ReportOptions& options) {
+    const auto& examples = dataset.getExamples();
+    if (options.pageRows == 0) return;
+    string directory = pageDirectory(reportFilename);
+    error_code error;
+    filesystem::create_directories(directory, error);
+    if (error) {
+        cerr << "Ошибка создания каталога страниц строк " << directory << ": " << error.message() << endl;
+        return;
+    }
+    size_t pages = (examples.size() + options.pageRows - 1) / options.pageRows;
+    vector<char> written(pages, 0);
+    parallelFor(pages, options.threadCount, [&](size_t page) {
+        ReportStream pageFile(directory + "/" + pageName(page));
+        if (!pageFile.is_open()) return;
+        size_t begin = page * options.pageRows;
+        size_t end = min(examples.size(), begin + options.pageRows);
+        pageFile << "<!DOCTYPE html>\n<html>\n<head>\n<meta charset='UTF-8'>\n"
+                 << "<title>Строки " << begin + 1 << "–" << end << "</title>\n</head>\n<body>\n";
+        pageFile << "<p>";
+        if (page > 0) pageFile << "<a href='" << pageName(page - 1) << "'>← назад</a> ";
+        pageFile << "Страница " << page + 1 << " из " << pages;
+        if (page + 1 < pages) pageFile << " <a href='" << pageName(page + 1) << "'>вперед →</a>";
+        pageFile << "</p>\n";
+        writeTableHeader(pageFile, dataset);
+        for (size_t i = begin; i < end; ++i) writeExampleRow(pageFile, dataset, examples[i]);
+        pageFile << "</table>\n</body>\n</html>\n";
+        written[page] = pageFile.good() ? 1 : 0;
+    });
+    
+    size_t failed = static_cast<size_t>(count(written.begin(), written.end(), 0));
+    if (failed > 0) {
+        cerr << "Не записано страниц строк: " << failed << " (" << directory << ")" << endl;
+    }
+    string relative = directory.substr(directory.rfind('/') == string::npos ? 0 : directory.rfind('/') + 1);
+    out << "<p>Все строки: " << pages << " страниц по " << options.pageRows << " строк — <a href='"
+        << relative << "/" << pageName(0) << "'>открыть первую</a>.</p>\n";
+}
+
+// Словарь строк блока: индекс значения по первому появлению
+class StringTable {
+public:
+    std::uint32_t add(const string& value) {
+        auto [it, inserted] = index.try_emplace(value, static_cast<std::uint32_t>(values.size()));
+        if (inserted) values.push_back(value);
+        return it->second;
+    }
+    const vector<string>& getValues() const { return values; }
+
+private:
+    unordered_map<string, std::uint32_t> index;
+    vector<string> values;
+};
+
+// Строки набора по столбцам: словарь значений и коды (типизированный
+// массив) на столбец; большой набор — равномерной выборкой, как в writeRowView
+string rowsBlob(const Dataset& dataset, const ReportOptions& options) {
+    const auto& examples = dataset.getExamples();
+    const auto& features = dataset.getFeatureNames();
+    size_t shown = examples.size() <= options.inlineRowLimit ? examples.size()
+                                                             : min(options.sampleRows, examples.size());
+    
+    vector<StringTable> dictionaries(features.size() + 1);
+    vector<vector<std::uint32_t>> codes(features.size() + 1, vector<std::uint32_t>(shown));
+    vector<std::uint32_t> ids(shown);
+    for (size_t row = 0; row < shown; ++row) {
+        const DataExample& example = examples[shown == examples.size() ? row : row * examples.size() / shown];
+        ids[row] = static_cast<std::uint32_t>(example.id);
+        for (size_t f = 0; f < features.size(); ++f) {
+            auto it = example.features.find(features[f]);
+            codes[f][row] = dictionaries[f].add(it != example.features.end() ? it->second : "—");
+        }
+        codes[features.size()][row] = dictionaries[features.size()].add(example.target);
+    }
+    
+    vector<string> columns = features;
+    columns.push_back(dataset.getTargetName());
+    stringstream json;
+    json << "{\"total\":" << examples.size() << ",\"columns\":" << ReportScript::strings(columns)
+         << ",\"ids\":" << ReportScript::unsignedArray(ids) << ",\"dictionaries\":[";
+    for (size_t c = 0; c < dictionaries.size(); ++c) {
+        json << (c ? "," : "") << ReportScript::strings(dictionaries[c].getValues());
+    }
+    json << "],\"codes\":[";
+    for (size_t c = 0; c < codes.size(); ++c) {
+        json << (c ? "," : "") << ReportScript::unsignedArray(codes[c]);
+    }
+    json << "]}";
+    return json.str();
+}
+
+// Результаты по столбцам: числа — для графиков, память — готовым текстом
+string resultsBlob(const vector<AlgorithmResult>& results) {
+    vector<string> names, memory, peak;
+    vector<double> accuracy, accuracyStd, f1, f1Std, time, timeStd, folds, nodes;
+    for (const auto& result : results) {
+        names.push_back(result.algorithmName);
+        accuracy.push_back(result.accuracy);
+        accuracyStd.push_back(result.accuracyStd);
+        f1.push_back(result.f1Score);
+        f1Std.push_back(result.f1ScoreStd);
+        time.push_back(result.trainingTime);
+        timeStd.push_back(result.trainingTimeStd);
+        folds.push_back(result.folds);
+        nodes.push_back(result.nodeCount);
+        memory.push_back(MemoryUsage::formatBytes(result.modelMemory.total()));
+        peak.push_back(formatResident(result.peakResident));
+    }
+    return "{\"names\":" + ReportScript::strings(names) +
+           ",\"accuracy\":" + ReportScript::numbers(accuracy) +
+           ",\"accuracyStd\":" + ReportScript::numbers(accuracyStd) +
+           ",\"f1\":" + ReportScript::numbers(f1) +
+           ",\"f1Std\":" + ReportScript::numbers(f1Std) +
+           ",\"time\":" + ReportScript::numbers(time) +
+           ",\"timeStd\":" + ReportScript::numbers(timeStd) +
+           ",\"folds\":" + ReportScript::numbers(folds) +
+           ",\"nodes\":" + ReportScript::numbers(nodes) +
+           ",\"memory\":" + ReportScript::strings(memory) +
+           ",\"peak\":" + ReportScript::strings(peak) + "}";
+}
+
+// Кривые ускорения: линия на пару «алгоритм, размер набора»
+string scalingBlob(const vector<ScalingPoint>& scaling) {
+    unsigned minThreads = scaling.front().threads, maxThreads = scaling.front().threads;
+    for (const auto& point : scaling) {
+        minThreads = min(minThreads, point.threads);
+        maxThreads = max(maxThreads, point.threads);
+    }
+    stringstream json;
+    json << "{\"minThreads\":" << minThreads << ",\"maxThreads\":" << maxThreads << ",\"series\":[";
+    for (size_t i = 0; i < scaling.size();) {
+        size_t j = i;
+        while (j < scaling.size() && scaling[j].algorithm == scaling[i].algorithm &&
+               scaling[j].rows == scaling[i].rows) j++;
+        vector<double> threads, train, score;
+        for (size_t k = i; k < j; ++k) {
+            threads.push_back(scaling[k].threads);
+            train.push_back(scaling[k].trainingSpeedup);
+            score.push_back(scaling[k].scoringSpeedup);
+        }
+        json << (i ? "," : "") << "{\"name\":"
+             << ReportScript::quote(scaling[i].algorithm + ", " + to_string(scaling[i].rows) + " строк")
+             << ",\"threads\":" << ReportScript::numbers(threads)
+             << ",\"train\":" << ReportScript::numbers(train)
+             << ",\"score\":" << ReportScript::numbers(score) << "}";
+        i = j;
+    }
+    json << "]}";
+    return json.str();
+}
+
+// Линии тренда: по линии на алгоритм, точки — запуски в порядке истории
+string historyBlob(const vector<HistoryRecord>& history) {
+    vector<string> names;
+    for (const auto& record : history) {
+        if (find(names.begin(), names.end(), record.name) == names.end()) names.push_back(record.name);
+    }
+    stringstream json;
+    json << "{\"series\":[";
+    for (size_t n = 0; n < names.size(); ++n) {
+        vector<string> runs, revisions;
+        vector<double> time, timeStd, memory;
+        for (const auto& record : history) {
+            if (record.name != names[n]) continue;
+            runs.push_back(record.run);
+            revisions.push_back(record.revision);
+            time.push_back(record.timeMean);
+            timeStd.push_back(record.timeStd);
+            memory.push_back(static_cast<double>(record.memoryBytes));
+        }
+        json << (n ? "," : "") << "{\"name\":" << ReportScript::quote(names[n])
+             << ",\"runs\":" << ReportScript::strings(runs)
+             << ",\"revisions\":" << ReportScript::strings(revisions)
+             << ",\"time\":" << ReportScript::numbers(time)
+             << ",\"timeStd\":" << ReportScript::numbers(timeStd)
+             << ",\"memory\":" << ReportScript::numbers(memory) << "}";
+    }
+    json << "]}";
+    return json.str();
+}
+
+// Время фаз обучения (мс): ряд на фазу, значения по алгоритмам
+string profileBlob(const vector<AlgorithmResult>& results) {
+    vector<string> phases, algorithms;
+    for (ProfilePhase phase : kReportPhases) phases.push_back(ProfileSnapshot::phaseName(phase));
+    vector<vector<double>> milliseconds(phases.size());
+    for (const auto& result : results) {
+        if (result.profile.empty()) continue;
+        algorithms.push_back(result.algorithmName);
+        size_t trace = 0;
+        for (ProfilePhase phase : kReportPhases) {
+            milliseconds[trace++].push_back(result.profile[phase].nanoseconds / 1e6);
+        }
+    }
+    stringstream json;
+    json << "{\"phases\":" << ReportScript::strings(phases)
+         << ",\"algorithms\":" << ReportScript::strings(algorithms) << ",\"ms\":[";
+    for (size_t p = 0; p < milliseconds.size(); ++p) {
+        json << (p ? "," : "") << ReportScript::numbers(milliseconds[p]);
+    }
+    json << "]}";
+    return json.str();
+}
+
+// Перцентили задержки по парам «алгоритм · путь»
+string latencyBlob(const vector<AlgorithmResult>& results) {
+    vector<string> algorithms, paths;
+    vector<double> p50, p90, p99, p999, maximum, rowsPerSecond;
+    for (const auto& result : results) {
+        for (const auto& latency : result.latency) {
+            algorithms.push_back(result.algorithmName);
+            paths.push_back(latency.path);
+            p50.push_back(latency.p50);
+            p90.push_back(latency.p90);
+            p99.push_back(latency.p99);
+            p999.push_back(latency.p999);
+            maximum.push_back(latency.max);
+            rowsPerSecond.push_back(latency.rowsPerSecond);
+        }
+    }
+    return "{\"algorithms\":" + ReportScript::strings(algorithms) +
+           ",\"paths\":" + ReportScript::strings(paths) +
+           ",\"p50\":" + ReportScript::numbers(p50) +
+           ",\"p90\":" + ReportScript::numbers(p90) +
+           ",\"p99\":" + ReportScript::numbers(p99) +
+           ",\"p999\":" + ReportScript::numbers(p999) +
+           ",\"max\":" + ReportScript::numbers(maximum) +
+           ",\"rps\":" + ReportScript::numbers(rowsPerSecond) + "}";
+}
+
+// Узлы дерева в прямом порядке обхода: столбцы — типизированные массивы,
+// тексты (признак, значение ветви, решение) — индексы общего словаря;
+// parent — номер родителя + 1 (0 у корня). Общий потомок бинарного
+// разбиения выводится один раз, ветвь — перечисление его значений;
+// nodeCount получает число выведенных узлов
+string treeBlob(const TreeNode& root, size_t& nodeCount) {
+    struct Frame {
+        const TreeNode* node;
+        std::uint32_t parent;
+        std::uint32_t depth;
+        std::uint32_t branch;
+    };
+    StringTable texts;
+    vector<std::uint32_t> parent, depth, feature, branch, decision, samples;
+    vector<Frame> stack = {{&root, 0, 0, texts.add("")}};
+    while (!stack.empty()) {
+        Frame frame = stack.back();
+        stack.pop_back();
+        auto id = static_cast<std::uint32_t>(parent.size());
+        parent.push_back(frame.parent);
+        depth.push_back(frame.depth);
+        branch.push_back(frame.branch);
+        feature.push_back(texts.add(frame.node->isLeaf ? "" : frame.node->feature));
+        decision.push_back(texts.add(frame.node->decision));
+        samples.push_back(static_cast<std::uint32_t>(max(frame.node->samples, 0)));
+        // Потомки в обратном порядке — в стеке первым окажется первый
+        auto children = DecisionTree::groupChildren(*frame.node);
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            if (it->second) stack.push_back({it->second.get(), id + 1, frame.depth + 1, texts.add(it->first)});
+        }
+    }
+    nodeCount = parent.size();
+    return "{\"count\":" + to_string(parent.size()) +
+           ",\"texts\":" + ReportScript::strings(texts.getValues()) +
+           ",\"parent\":" + ReportScript::unsignedArray(parent) +
+           ",\"depth\":" + ReportScript::unsignedArray(depth) +
+           ",\"feature\":" + ReportScript::unsignedArray(feature) +
+           ",\"branch\":" + ReportScript::unsignedArray(branch) +
+           ",\"decision\":" + ReportScript::unsignedArray(decision) +
+           ",\"samples\":" + ReportScript::unsignedArray(samples) + "}";
+}
+
+// Сценарий страницы: каждая секция строится из своего блока при показе
+const char* const kInteractiveScript = R"JS(
+            var results = DT.data('resultsData');
+            function withStd(mean, std, folds) {
+                return folds > 1 ? DT.format(mean) + ' ± ' + DT.format(std) : DT.format(mean);
+            }
+            DT.whenVisible('rowsTable', function (el) {
+                var rows = DT.data('rowsData');
+                var ids = DT.typed(rows.ids), codes = rows.codes.map(DT.typed);
+                DT.table(el, {columns: ['№'].concat(rows.columns), rowCount: ids.length, cell: function (r, c) {
+                    return c === 0 ? ids[r] : rows.dictionaries[c - 1][codes[c - 1][r]];
+                }});
+            });
+            DT.whenVisible('accuracyChart', function (el) {
+                DT.bar(el, {title: 'Сравнение точности алгоритмов', categories: results.names,
+                            xTitle: 'Алгоритм', yTitle: 'Значение', yRange: [0, 1], series: [
+                    {name: 'Точность', values: results.accuracy, errors: results.accuracyStd},
+                    {name: 'F1-Score', values: results.f1, errors: results.f1Std}]});
+            });
+            DT.whenVisible('resultsTable', function (el) {
+                DT.table(el, {columns: ['Алгоритм', 'Точность', 'F1-Score', 'Время (с)', 'Узлы', 'Память модели', 'Пик RSS процесса'],
+                              rowCount: results.names.length, cell: function (r, c) {
+                    var folds = results.folds[r];
+                    return [results.names[r], withStd(results.accuracy[r], results.accuracyStd[r], folds),
+                            withStd(results.f1[r], results.f1Std[r], folds), withStd(results.time[r], results.timeStd[r], folds),
+                            results.nodes[r], results.memory[r], results.peak[r]][c];
+                }});
+            });
+            function scalingSeries(key) {
+                var scaling = DT.data('scalingData');
+                var series = scaling.series.map(function (s) { return {name: s.name, x: s.threads, y: s[key]}; });
+                series.push({name: 'Идеальное', x: [scaling.minThreads, scaling.maxThreads],
+                             y: [1, scaling.maxThreads / scaling.minThreads], dash: true, color: '#7f8c8d'});
+                return series;
+            }
+            DT.whenVisible('scalingTrainChart', function (el) {
+                DT.line(el, {title: 'Ускорение обучения', xTitle: 'Потоков', yTitle: 'Ускорение', series: scalingSeries('train')});
+            });
+            DT.whenVisible('scalingScoreChart', function (el) {
+                DT.line(el, {title: 'Ускорение пакетного предсказания', xTitle: 'Потоков', yTitle: 'Ускорение',
+                             series: scalingSeries('score')});
+            });
+            function historySeries(key, errors) {
+                return DT.data('historyData').series.map(function (s) {
+                    return {name: s.name, x: s.runs, y: s[key], errors: errors ? s[errors] : null, text: s.revisions};
+                });
+            }
+            DT.whenVisible('historyTimeChart', function (el) {
+                DT.line(el, {title: 'Время обучения по запускам', xTitle: 'Запуск', yTitle: 'Секунды', category: true,
+                             series: historySeries('time', 'timeStd')});
+            });
+            DT.whenVisible('historyMemoryChart', function (el) {
+                DT.line(el, {title: 'Память модели по запускам', xTitle: 'Запуск', yTitle: 'Байт', category: true,
+                             series: historySeries('memory')});
+            });
+            DT.whenVisible('profileChart', function (el) {
+                var profile = DT.data('profileData');
+                DT.bar(el, {title: 'Время фаз обучения', categories: profile.algorithms, xTitle: 'Алгоритм', yTitle: 'мс',
+                            series: profile.phases.map(function (name, k) { return {name: name, values: profile.ms[k]}; })});
+            });
+            DT.whenVisible('latencyChart', function (el) {
+                var latency = DT.data('latencyData');
+                var labels = latency.algorithms.map(function (name, i) { return name + ' · ' + latency.paths[i]; });
+                DT.bar(el, {title: 'Задержка предсказания (нс на вызов)', categories: labels, yTitle: 'нс', log: true, series: [
+                    {name: 'p50', values: latency.p50}, {name: 'p99', values: latency.p99}, {name: 'p99.9', values: latency.p999}]});
+            });
+            DT.whenVisible('latencyTable', function (el) {
+                var latency = DT.data('latencyData');
+                var keys = ['p50', 'p90', 'p99', 'p999', 'max', 'rps'];
+                DT.table(el, {columns: ['Алгоритм', 'Путь', 'p50 (нс)', 'p90 (нс)', 'p99 (нс)', 'p99.9 (нс)', 'Макс. (нс)', 'Решений/с'],
+                              rowCount: latency.algorithms.length, cell: function (r, c) {
+                    if (c === 0) return latency.algorithms[r];
+                    if (c === 1) return latency.paths[r];
+                    var value = latency[keys[c - 2]][r];
+                    return value === null ? null : Math.round(value);
+                }});
+            });
+            function nodeTable(el, id) {
+                var tree = DT.data(id), texts = tree.texts;
+                var columns = ['parent', 'depth', 'feature', 'branch', 'decision', 'samples'].map(function (key) {
+                    return DT.typed(tree[key]);
+                });
+                DT.table(el, {columns: ['№', 'Родитель', 'Глубина', 'Ветвь', 'Признак', 'Решение', 'Примеров'],
+                              rowCount: tree.count, cell: function (r, c) {
+                    switch (c) {
+                        case 0: return r + 1;
+                        case 1: return columns[0][r] || '—';
+                        case 2: return columns[1][r];
+                        case 3: return texts[columns[3][r]] || '—';
+                        case 4: return texts[columns[2][r]] || 'лист';
+                        case 5: return texts[columns[4][r]] || '—';
+                        default: return columns[5][r];
+                    }
+                }});
+            }
+)JS";
+
+} // namespace
+
 void ReportGenerator::generateFullReport(
     const vector<AlgorithmResult>& results,
     const Dataset& dataset,
-    const string& filename) {
+    const string& filename,
+    const ReportOptions& options) {
     
-    ofstream reportFile(filename);
+    ReportStream reportFile(filename);
     if (!reportFile.is_open()) {
         cerr << "Ошибка открытия файла отчета: " << filename << endl;
         return;
@@ -57,25 +606,21 @@ void ReportGenerator::generateFullReport(
     
     // Раздел 1: Описание набора данных
     reportFile << "    <h2>1. Описание набора данных</h2>\n";
+    DatasetSummary summary = DatasetSummary::compute(dataset, options.threadCount);
     reportFile << "    <div class='dataset-info'>\n";
-    reportFile << "        <p><strong>Целевой атрибут:</strong> Решение по кредиту (Одобрить/Отказать)</p>\n";
-    reportFile << "        <p><strong>Количество примеров:</strong> " << dataset.getExamples().size() << "</p>\n";
-    reportFile << "        <p><strong>Количество признаков:</strong> " << dataset.getFeatureNames().size() << "</p>\n";
-    
-    reportFile << "        <h3>Описание признаков:</h3>\n";
-    reportFile << "        <table>\n";
-    reportFile << "            <tr><th>Признак</th><th>Значения</th><th>Описание</th></tr>\n";
-    reportFile << "            <tr><td>Ставка</td><td>Высокая, Средняя, Низкая</td><td>Процентная ставка по кредиту</td></tr>\n";
-    reportFile << "            <tr><td>Срок_рассмотрения</td><td>Длительный, Средний, Быстрый</td><td>Время рассмотрения заявки</td></tr>\n";
-    reportFile << "            <tr><td>Требования_к_залогу</td><td>Высокие, Средние, Низкие</td><td>Требуемое обеспечение</td></tr>\n";
-    reportFile << "            <tr><td>Репутация_банка</td><td>Хорошая, Средняя, Плохая</td><td>Репутация банка на рынке</td></tr>\n";
-    reportFile << "        </table>\n";
+    MemoryBreakdown datasetMemory = MemoryUsage::ofDataset(dataset);
+    reportFile << "        <p><strong>Память набора:</strong> " << MemoryUsage::formatBytes(datasetMemory.total())
+               << " (примеры " << MemoryUsage::formatBytes(datasetMemory.nodes)
+               << ", строки " << MemoryUsage::formatBytes(datasetMemory.strings)
+               << ", словари признаков " << MemoryUsage::formatBytes(datasetMemory.children)
+               << ", значения по столбцам " << MemoryUsage::formatBytes(datasetMemory.statistics) << ")</p>\n";
+    reportFile << generateDatasetDescription(summary);
     reportFile << "    </div>\n";
     
-    // Большая таблица с данными
-    reportFile << "    <h3>Полная таблица данных:</h3>\n";
+    // Строки набора: целиком, выборкой или страницами
+    reportFile << "    <h3>Данные:</h3>\n";
     reportFile << "    <div style='overflow-x: auto;'>\n";
-    reportFile << dataset.getDataTableHTML();
+    writeRowView(reportFile, dataset, filename, options);
     reportFile << "    </div>\n";
     
     // Раздел 2: Сравнительная таблица результатов
@@ -88,21 +633,27 @@ void ReportGenerator::generateFullReport(
         vector<string> bestAlgorithms;
         if (!results.empty()) {
             // Лучшая точность
-            auto bestAccuracy = max_element(results.begin(), results.end(),
-                [](const AlgorithmResult& a, const AlgorithmResult& b) {
-                    return a.accuracy < b.accuracy;
-                });
-            bestAlgorithms.push_back(bestAccuracy->algorithmName);
+            bestAlgorithms.push_back(bestByAccuracy(results).algorithmName);
         }
         
         reportFile << "    <div class='info-box'>\n";
         reportFile << "        <p><strong>Метрики качества:</strong></p>\n";
         reportFile << "        <ul>\n";
         reportFile << "            <li><strong>Точность (Accuracy)</strong> - доля правильных предсказаний</li>\n";
-        reportFile << "            <li><strong>Precision</strong> - точность предсказаний класса 'Одобрить'</li>\n";
-        reportFile << "            <li><strong>Recall</strong> - полнота предсказаний класса 'Одобрить'</li>\n";
-        reportFile << "            <li><strong>F1-Score</strong> - гармоническое среднее precision и recall</li>\n";
+        reportFile << "            <li><strong>Precision</strong> - точность предсказаний, среднее по классам (macro)</li>\n";
+        reportFile << "            <li><strong>Recall</strong> - полнота предсказаний, среднее по классам (macro)</li>\n";
+        reportFile << "            <li><strong>F1-Score</strong> - гармоническое среднее precision и recall, среднее по классам (macro)</li>\n";
+        reportFile << "            <li><strong>AUC</strong> - площадь под ROC-кривой, среднее по классам (каждый против остальных)</li>\n";
+        reportFile << "            <li><strong>Log-loss</strong> - средняя логарифмическая потеря по вероятностям классов</li>\n";
         reportFile << "        </ul>\n";
+        
+        int maxFolds = 1;
+        for (const auto& result : results) maxFolds = max(maxFolds, result.folds);
+        if (maxFolds > 1) {
+            reportFile << "        <p>Для алгоритмов, оцененных стратифицированной " << maxFolds
+                      << "-кратной кросс-валидацией, указаны среднее ± стандартное отклонение по фолдам. "
+                      << "Глубина дерева, число узлов и память — модели, обученной на обучающей выборке.</p>\n";
+        }
         reportFile << "    </div>\n";
         
         reportFile << "    <table>\n";
@@ -112,7 +663,9 @@ void ReportGenerator::generateFullReport(
         reportFile << "            <th>Precision</th>\n";
         reportFile << "            <th>Recall</th>\n";
         reportFile << "            <th>F1-Score</th>\n";
-        reportFile << "            <th>Время обучения (с)</th>\n";
+        reportFile << "            <th>AUC</th>\n";
+        reportFile << "            <th>Log-loss</th>\n";
+        reportFile << "            <th>Время обучения</th>\n";
         reportFile << "            <th>Глубина дерева</th>\n";
         reportFile << "            <th>Количество узлов</th>\n";
         reportFile << "        </tr>\n";
@@ -124,11 +677,13 @@ void ReportGenerator::generateFullReport(
             reportFile << "        <tr" << (isBest ? " class='best'" : "") << ">\n";
             reportFile << "            <td><strong>" << result.algorithmName << "</strong></td>\n";
             reportFile << "            <td class='metric-value'>" 
-                      << fixed << setprecision(4) << result.accuracy << "</td>\n";
-            reportFile << "            <td>" << fixed << setprecision(4) << result.precision << "</td>\n";
-            reportFile << "            <td>" << fixed << setprecision(4) << result.recall << "</td>\n";
-            reportFile << "            <td>" << fixed << setprecision(4) << result.f1Score << "</td>\n";
-            reportFile << "            <td>" << fixed << setprecision(3) << result.trainingTime << "</td>\n";
+                      << formatMetric(result.accuracy, result.accuracyStd, result.folds, 4) << "</td>\n";
+            reportFile << "            <td>" << formatMetric(result.precision, result.precisionStd, result.folds, 4) << "</td>\n";
+            reportFile << "            <td>" << formatMetric(result.recall, result.recallStd, result.folds, 4) << "</td>\n";
+            reportFile << "            <td>" << formatMetric(result.f1Score, result.f1ScoreStd, result.folds, 4) << "</td>\n";
+            reportFile << "            <td>" << formatOptional(result.auc, 4) << "</td>\n";
+            reportFile << "            <td>" << formatOptional(result.logLoss, 4) << "</td>\n";
+            reportFile << "            <td>" << formatDuration(result.trainingTime, result.trainingTimeStd, result.folds) << "</td>\n";
             reportFile << "            <td>" << result.treeDepth << "</td>\n";
             reportFile << "            <td>" << result.nodeCount << "</td>\n";
             reportFile << "        </tr>\n";
@@ -136,12 +691,115 @@ void ReportGenerator::generateFullReport(
         
         reportFile << "    </table>\n";
         
+        // Метрики по классам: на тестовой выборке или средние по фолдам
+        reportFile << "    <h3>Метрики по классам</h3>\n";
+        if (maxFolds > 1) {
+            reportFile << "    <p>Для алгоритмов с кросс-валидацией — средние по фолдам; "
+                       << "примеров — во всех отложенных частях.</p>\n";
+        }
+        reportFile << "    <table>\n";
+        reportFile << "        <tr><th>Алгоритм</th><th>Класс</th><th>Precision</th><th>Recall</th>"
+                   << "<th>F1-Score</th><th>AUC</th><th>Примеров</th></tr>\n";
+        for (const auto& result : results) {
+            for (size_t c = 0; c < result.perClass.size() && c < result.classNames.size(); ++c) {
+                const ClassMetrics& cls = result.perClass[c];
+                reportFile << "        <tr><td>" << result.algorithmName << "</td>"
+                           << "<td>" << result.classNames[c] << "</td>"
+                           << "<td>" << formatOptional(cls.precision, 4) << "</td>"
+                           << "<td>" << formatOptional(cls.recall, 4) << "</td>"
+                           << "<td>" << formatOptional(cls.f1Score, 4) << "</td>"
+                           << "<td>" << formatOptional(cls.auc, 4) << "</td>"
+                           << "<td>" << cls.support << "</td></tr>\n";
+            }
+        }
+        reportFile << "    </table>\n";
+        
+        // Профиль обучения по фазам
+        bool profiled = any_of(results.begin(), results.end(),
+            [](const AlgorithmResult& r) { return !r.profile.empty(); });
+        if (profiled) {
+            reportFile << "    <h3>Профиль обучения</h3>\n";
+            reportFile << "    <div class='info-box'>\n";
+            reportFile << "        <p>Суммарное время фазы по всем потокам и число замеров. "
+                       << "Поиск разбиения включает подсчет статистики и оценку критерия.</p>\n";
+            reportFile << "    </div>\n";
+            reportFile << "    <table>\n";
+            reportFile << "        <tr><th>Алгоритм</th><th>Узлов</th><th>Глубина рекурсии</th>";
+            for (ProfilePhase phase : kReportPhases) {
+                reportFile << "<th>" << ProfileSnapshot::phaseName(phase) << "</th>";
+            }
+            reportFile << "</tr>\n";
+            for (const auto& result : results) {
+                if (result.profile.empty()) continue;
+                reportFile << "        <tr><td>" << result.algorithmName << "</td>"
+                           << "<td>" << result.profile.nodes << "</td>"
+                           << "<td>" << result.profile.maxDepth << "</td>";
+                for (ProfilePhase phase : kReportPhases) {
+                    reportFile << "<td>" << formatPhase(result.profile[phase]) << "</td>";
+                }
+                reportFile << "</tr>\n";
+            }
+            reportFile << "    </table>\n";
+        }
+        
+        // Память моделей и процесса
+        reportFile << "    <h3>Память</h3>\n";
+        reportFile << "    <div class='info-box'>\n";
+        reportFile << "        <p>Оценка байтов, занятых моделью, по категориям (для ансамблей — сумма по деревьям) "
+                   << "и резидентная память процесса (RSS) вокруг обучения. RSS общий для процесса: "
+                   << "прирост и пик (наибольшее значение с начала работы после обучения и оценки модели) "
+                   << "приведены только для моделей, обучавшихся без других задач.</p>\n";
+        reportFile << "    </div>\n";
+        reportFile << "    <table>\n";
+        reportFile << "        <tr><th>Алгоритм</th><th>Узлы</th><th>Строки</th><th>Карты потомков</th>"
+                   << "<th>Статистика</th><th>Всего</th><th>Прирост RSS при обучении</th><th>Пик RSS процесса</th></tr>\n";
+        for (const auto& result : results) {
+            long long growth = static_cast<long long>(result.residentAfterTraining) -
+                               static_cast<long long>(result.residentBeforeTraining);
+            string growthText = result.residentAfterTraining == 0 ? "—"
+                : (growth < 0 ? "-" : "") + MemoryUsage::formatBytes(static_cast<size_t>(growth < 0 ? -growth : growth));
+            reportFile << "        <tr><td>" << result.algorithmName << "</td>"
+                       << "<td>" << MemoryUsage::formatBytes(result.modelMemory.nodes) << "</td>"
+                       << "<td>" << MemoryUsage::formatBytes(result.modelMemory.strings) << "</td>"
+                       << "<td>" << MemoryUsage::formatBytes(result.modelMemory.children) << "</td>"
+                       << "<td>" << MemoryUsage::formatBytes(result.modelMemory.statistics) << "</td>"
+                       << "<td>" << MemoryUsage::formatBytes(result.modelMemory.total()) << "</td>"
+                       << "<td>" << growthText << "</td>"
+                       << "<td>" << formatResident(result.peakResident) << "</td></tr>\n";
+        }
+        reportFile << "    </table>\n";
+        
+        // Выделения памяти по фазам (только в сборке с подсчетом)
+        if (AllocationCounter::isAvailable()) {
+            auto stats = [](const AlgorithmResult& r, AllocationPhase phase) {
+                return r.allocations[static_cast<size_t>(phase)];
+            };
+            reportFile << "    <h3>Выделения памяти</h3>\n";
+            reportFile << "    <div class='info-box'>\n";
+            reportFile << "        <p>Вызовы operator new и запрошенные байты по фазам. "
+                       << "Предсказание на строку — по тестовой выборке.</p>\n";
+            reportFile << "    </div>\n";
+            reportFile << "    <table>\n";
+            reportFile << "        <tr><th>Алгоритм</th><th>Обучение</th><th>На узел</th>"
+                       << "<th>Предсказание</th><th>На строку</th><th>Метрики</th><th>Экспорт DOT</th><th>Прочее</th></tr>\n";
+            for (const auto& result : results) {
+                reportFile << "        <tr><td>" << result.algorithmName << "</td>"
+                           << "<td>" << formatAllocations(stats(result, AllocationPhase::Train)) << "</td>"
+                           << "<td>" << formatPerUnit(stats(result, AllocationPhase::Train).count,
+                                                      static_cast<size_t>(max(result.nodeCount, 0))) << "</td>"
+                           << "<td>" << formatAllocations(stats(result, AllocationPhase::Predict)) << "</td>"
+                           << "<td>" << formatPerUnit(stats(result, AllocationPhase::Predict).count,
+                                                      result.predictedRows) << "</td>"
+                           << "<td>" << formatAllocations(stats(result, AllocationPhase::Evaluate)) << "</td>"
+                           << "<td>" << formatAllocations(stats(result, AllocationPhase::Export)) << "</td>"
+                           << "<td>" << formatAllocations(stats(result, AllocationPhase::Other)) << "</td></tr>\n";
+            }
+            reportFile << "    </table>\n";
+        }
+        
         // Выводы
         if (!results.empty()) {
-            auto bestResult = max_element(results.begin(), results.end(),
-                [](const AlgorithmResult& a, const AlgorithmResult& b) {
-                    return a.accuracy < b.accuracy;
-                });
+            const AlgorithmResult* bestResult = &bestByAccuracy(results);
             
             reportFile << "    <div class='conclusion'>\n";
             reportFile << "        <h3>Выводы:</h3>\n";
@@ -160,12 +818,13 @@ void ReportGenerator::generateFullReport(
                       << simplestTree->treeDepth << ")</p>\n";
             
             reportFile << "        <p><strong>Самое быстрое обучение:</strong> ";
-            auto fastest = min_element(results.begin(), results.end(),
-                [](const AlgorithmResult& a, const AlgorithmResult& b) {
-                    return a.trainingTime < b.trainingTime;
+            auto comparable = comparableResults(results);
+            const AlgorithmResult* fastest = *min_element(comparable.begin(), comparable.end(),
+                [](const AlgorithmResult* a, const AlgorithmResult* b) {
+                    return a->trainingTime < b->trainingTime;
                 });
-            reportFile << fastest->algorithmName << " (" << fixed << setprecision(3) 
-                      << fastest->trainingTime << " сек.)</p>\n";
+            reportFile << fastest->algorithmName << " ("
+                      << Profiler::formatSeconds(fastest->trainingTime) << ")</p>\n";
             reportFile << "    </div>\n";
         }
     }
@@ -176,25 +835,17 @@ void ReportGenerator::generateFullReport(
     
     // Раздел 4: Визуализация
     reportFile << "    <h2>4. Визуализация деревьев решений</h2>\n";
+    reportFile << writeTreeImages(results);
     reportFile << "    <div class='info-box'>\n";
-    reportFile << "        <p>Для генерации изображений деревьев используйте Graphviz:</p>\n";
+    reportFile << "        <p>Поддеревья глубже порога свернуты (пунктирный контур). "
+               << "Полное дерево можно построить из DOT файла через Graphviz:</p>\n";
     reportFile << "        <pre style='background-color: #f4f4f4; padding: 10px; border-radius: 5px; overflow-x: auto;'>\n";
-    if (!results.empty()) {
-        for (const auto& result : results) {
-            reportFile << "dot -Tpng " << result.dotFilePath << " -o " 
-                      << result.algorithmName << "_tree.png\n";
-        }
-    } else {
-        reportFile << "dot -Tpng output/trees/ID3_tree.dot -o ID3_tree.png\n";
-        reportFile << "dot -Tpng output/trees/C4.5_tree.dot -o C4.5_tree.png\n";
-        reportFile << "dot -Tpng output/trees/CART_tree.dot -o CART_tree.png\n";
-        reportFile << "dot -Tpng output/trees/CHAID_tree.dot -o CHAID_tree.png\n";
+    for (const auto& result : results) {
+        if (result.dotFilePath.empty()) continue;  // модели без DOT (бустинг)
+        reportFile << "dot -Tsvg " << result.dotFilePath << " -o " 
+                  << result.algorithmName << "_tree_full.svg\n";
     }
     reportFile << "        </pre>\n";
-    reportFile << "        <p>Или SVG для лучшего качества:</p>\n";
-    reportFile << "        <pre style='background-color: #f4f4f4; padding: 10px; border-radius: 5px;'>\n";
-    reportFile << "dot -Tsvg tree.dot -o tree.svg\n";
-    reportFile << "        </pre>\n";
     reportFile << "    </div>\n";
     
     // Раздел 5: Рекомендации
@@ -224,6 +875,96 @@ void ReportGenerator::generateFullReport(
     reportFile.close();
 }
 
+string ReportGenerator::generateDatasetDescription(const DatasetSummary& summary) {
+    stringstream ss;
+    
+    ss << "        <p><strong>Целевой атрибут:</strong> " << htmlEscape(summary.targetName) << " (";
+    for (size_t c = 0; c < summary.classNames.size(); ++c) {
+        ss << (c ? ", " : "") << htmlEscape(summary.classNames[c]) << ": " << summary.classCounts[c]
+           << " — " << formatShare(summary.classCounts[c], summary.rows);
+    }
+    ss << ")</p>\n";
+    ss << "        <p><strong>Количество примеров:</strong> " << summary.rows << "</p>\n";
+    ss << "        <p><strong>Количество признаков:</strong> " << summary.features.size() << "</p>\n";
+    
+    ss << "        <h3>Описание признаков:</h3>\n";
+    ss << "        <table>\n";
+    ss << "            <tr><th>Признак</th><th>Различных значений</th><th>Пропусков</th>"
+       << "<th>Частые значения</th><th>Описание</th></tr>\n";
+    for (const auto& feature : summary.features) {
+        ss << "            <tr><td>" << htmlEscape(feature.name) << "</td>"
+           << "<td>" << feature.values.size() << "</td>"
+           << "<td>" << feature.missing << "</td><td>";
+        for (size_t v = 0; v < feature.values.size() && v < 5; ++v) {
+            ss << (v ? ", " : "") << htmlEscape(feature.values[v].value);
+        }
+        if (feature.values.size() > 5) ss << ", …";
+        ss << "</td><td>" << featureDescription(feature.name) << "</td></tr>\n";
+    }
+    ss << "        </table>\n";
+    
+    // Распределение классов по значениям каждого признака
+    ss << "        <h3>Распределение по значениям признаков:</h3>\n";
+    for (const auto& feature : summary.features) {
+        ss << "        <table class='data-table'>\n";
+        ss << "            <tr><th>" << htmlEscape(feature.name) << "</th><th>Примеров</th><th>Доля</th>";
+        for (const auto& name : summary.classNames) ss << "<th>" << htmlEscape(name) << "</th>";
+        ss << "</tr>\n";
+        
+        ValueSummary rest;
+        rest.classCounts.assign(summary.classNames.size(), 0);
+        for (size_t v = 0; v < feature.values.size(); ++v) {
+            const ValueSummary& value = feature.values[v];
+            if (v >= kSummaryValues) {
+                rest.count += value.count;
+                for (size_t c = 0; c < rest.classCounts.size(); ++c) rest.classCounts[c] += value.classCounts[c];
+                continue;
+            }
+            ss << "            <tr><td>" << htmlEscape(value.value) << "</td><td>" << value.count
+               << "</td><td>" << formatShare(value.count, summary.rows) << "</td>";
+            for (size_t count : value.classCounts) ss << "<td>" << count << "</td>";
+            ss << "</tr>\n";
+        }
+        if (rest.count > 0) {
+            ss << "            <tr><td>прочие (" << feature.values.size() - kSummaryValues << ")</td><td>"
+               << rest.count << "</td><td>" << formatShare(rest.count, summary.rows) << "</td>";
+            for (size_t count : rest.classCounts) ss << "<td>" << count << "</td>";
+            ss << "</tr>\n";
+        }
+        ss << "        </table>\n";
+    }
+    
+    return ss.str();
+}
+
+void ReportGenerator::writeRowView(ostream& out, const Dataset& dataset,
+                                   const string& reportFilename, const ReportOptions& options) {
+    const auto& examples = dataset.getExamples();
+    
+    // Небольшой набор — целиком
+    if (examples.size() <= options.inlineRowLimit) {
+        writeTableHeader(out, dataset);
+        for (const auto& example : examples) writeExampleRow(out, dataset, example);
+        out << "</table>\n";
+        return;
+    }
+    
+    // Равномерная выборка строк
+    size_t sample = min(options.sampleRows, examples.size());
+    if (sample > 0) {
+        out << "<p>Показано " << sample << " из " << examples.size()
+            << " строк (равномерная выборка).</p>\n";
+        writeTableHeader(out, dataset);
+        for (size_t i = 0; i < sample; ++i) {
+            writeExampleRow(out, dataset, examples[i * examples.size() / sample]);
+        }
+        out << "</table>\n";
+    }
+    
+    // Все строки страницами в отдельных файлах
+    writeRowPages(out, dataset, reportFilename, options);
+}
+
 string ReportGenerator::generateAlgorithmsDescription() {
     stringstream ss;
     
@@ -269,107 +1010,119 @@ string ReportGenerator::generateAlgorithmsDescription() {
 void ReportGenerator::createInteractiveReport(
     const vector<AlgorithmResult>& results,
     const Dataset& dataset,
-    const string& filename) {
+    const string& filename,
+    const vector<ScalingPoint>& scaling,
+    const vector<HistoryRecord>& history,
+    const ReportOptions& options) {
+    
+    ReportStream htmlFile(filename);
+    if (!htmlFile.is_open()) {
+        cerr << "Ошибка открытия файла отчета: " << filename << endl;
+        return;
+    }
     
-    ofstream htmlFile(filename);
+    bool profiled = any_of(results.begin(), results.end(),
+        [](const AlgorithmResult& r) { return !r.profile.empty(); });
+    bool hasLatency = any_of(results.begin(), results.end(),
+        [](const AlgorithmResult& r) { return !r.latency.empty(); });
     
+    // Страница без внешних ресурсов: сценарий графиков встроен, данные
+    // секций — блоки JSON, которые разбираются при показе секции
     htmlFile << "<!DOCTYPE html>\n";
     htmlFile << "<html>\n";
     htmlFile << "<head>\n";
     htmlFile << "    <meta charset='UTF-8'>\n";
     htmlFile << "    <title>Интерактивный отчет - Сравнение алгоритмов</title>\n";
-    htmlFile << "    <script src='https://cdn.plot.ly/plotly-latest.min.js'></script>\n";
     htmlFile << "    <style>\n";
     htmlFile << "        body { font-family: Arial, sans-serif; margin: 40px; }\n";
     htmlFile << "        h1 { color: #2c3e50; text-align: center; }\n";
     htmlFile << "        .container { max-width: 1200px; margin: 0 auto; }\n";
-    htmlFile << "        .chart-container { margin: 30px 0; }\n";
+    htmlFile << "        .chart-container { margin: 30px 0; min-height: 400px; }\n";
     htmlFile << "        .data-table { width: 100%; border-collapse: collapse; margin: 20px 0; }\n";
     htmlFile << "        .data-table th, .data-table td { border: 1px solid #ddd; padding: 8px; }\n";
     htmlFile << "        .data-table th { background-color: #4CAF50; color: white; }\n";
+    htmlFile << "        details { margin: 10px 0; }\n";
+    htmlFile << "        summary { cursor: pointer; font-weight: bold; }\n";
     htmlFile << "    </style>\n";
+    htmlFile << "    <script>" << ReportScript::runtime() << "</script>\n";
     htmlFile << "</head>\n";
     htmlFile << "<body>\n";
     htmlFile << "    <div class='container'>\n";
     htmlFile << "        <h1>Интерактивный отчет: Выбор банка для кредита под бизнес</h1>\n";
     
+    // Строки — по тем же правилам, что и в writeRowView, таблица страницами
     htmlFile << "        <h2>Данные для анализа</h2>\n";
-    htmlFile << "        <div style='overflow-x: auto;'>\n";
-    htmlFile << dataset.getDataTableHTML();
-    htmlFile << "        </div>\n";
+    size_t rowCount = dataset.getExamples().size();
+    if (rowCount > options.inlineRowLimit) {
+        htmlFile << "        <p>Показано " << min(options.sampleRows, rowCount) << " из " << rowCount
+                 << " строк (равномерная выборка).</p>\n";
+    }
+    htmlFile << "        <div id='rowsTable' style='overflow-x: auto;'></div>\n";
+    if (rowCount > options.inlineRowLimit) {
+        writeRowPages(htmlFile, dataset, filename, options);
+    }
     
     htmlFile << "        <h2>Сравнение алгоритмов</h2>\n";
     htmlFile << "        <div id='accuracyChart' class='chart-container'></div>\n";
+    if (!scaling.empty()) {
+        htmlFile << "        <h2>Масштабирование по потокам</h2>\n";
+        htmlFile << "        <p>Ускорение относительно наименьшего числа потоков; пунктир — идеальное линейное.</p>\n";
+        htmlFile << "        <div id='scalingTrainChart' class='chart-container'></div>\n";
+        htmlFile << "        <div id='scalingScoreChart' class='chart-container'></div>\n";
+    }
+    if (!history.empty()) {
+        htmlFile << "        <h2>Тренд по запускам</h2>\n";
+        htmlFile << "        <p>История результатов на этом наборе данных: точка — запуск, подпись — ревизия.</p>\n";
+        htmlFile << "        <div id='historyTimeChart' class='chart-container'></div>\n";
+        htmlFile << "        <div id='historyMemoryChart' class='chart-container'></div>\n";
+    }
     
     htmlFile << "        <h2>Результаты</h2>\n";
-    if (!results.empty()) {
-        htmlFile << "        <table class='data-table'>\n";
-        htmlFile << "            <tr><th>Алгоритм</th><th>Точность</th><th>F1-Score</th><th>Время (с)</th><th>Узлы</th></tr>\n";
-        for (const auto& result : results) {
-            htmlFile << "            <tr>\n";
-            htmlFile << "                <td>" << result.algorithmName << "</td>\n";
-            htmlFile << "                <td>" << fixed << setprecision(4) << result.accuracy << "</td>\n";
-            htmlFile << "                <td>" << fixed << setprecision(4) << result.f1Score << "</td>\n";
-            htmlFile << "                <td>" << fixed << setprecision(3) << result.trainingTime << "</td>\n";
-            htmlFile << "                <td>" << result.nodeCount << "</td>\n";
-            htmlFile << "            </tr>\n";
-        }
-        htmlFile << "        </table>\n";
+    htmlFile << "        <div id='resultsTable'></div>\n";
+    
+    if (profiled) {
+        htmlFile << "        <h2>Профиль обучения</h2>\n";
+        htmlFile << "        <div id='profileChart' class='chart-container'></div>\n";
+    }
+    if (hasLatency) {
+        htmlFile << "        <h2>Задержка предсказания</h2>\n";
+        htmlFile << "        <div id='latencyChart' class='chart-container'></div>\n";
+        htmlFile << "        <div id='latencyTable'></div>\n";
     }
     
     htmlFile << "        <h2>Визуализация деревьев</h2>\n";
-    htmlFile << "        <p>Для просмотра деревьев сгенерируйте изображения:</p>\n";
-    htmlFile << "        <pre>\n";
-    htmlFile << "cd ~/sem13/build\n";
-    htmlFile << "dot -Tpng output/trees/ID3_tree.dot -o output/trees/ID3_tree.png\n";
-    htmlFile << "dot -Tpng output/trees/C4.5_tree.dot -o output/trees/C4.5_tree.png\n";
-    htmlFile << "dot -Tpng output/trees/CART_tree.dot -o output/trees/CART_tree.png\n";
-    htmlFile << "dot -Tpng output/trees/CHAID_tree.dot -o output/trees/CHAID_tree.png\n";
-    htmlFile << "        </pre>\n";
-    
-    // JavaScript для графиков
-    htmlFile << "        <script>\n";
-    htmlFile << "            // Данные для графика\n";
-    htmlFile << "            var algorithms = [];\n";
-    htmlFile << "            var accuracies = [];\n";
-    htmlFile << "            var f1Scores = [];\n";
-    
-    if (!results.empty()) {
-        for (const auto& result : results) {
-            htmlFile << "            algorithms.push('" << result.algorithmName << "');\n";
-            htmlFile << "            accuracies.push(" << result.accuracy << ");\n";
-            htmlFile << "            f1Scores.push(" << result.f1Score << ");\n";
-        }
+    htmlFile << writeTreeImages(results);
+    
+    // Узлы деревьев — самые большие блоки: таблица строится при раскрытии
+    // (у ансамблей — первое дерево, число узлов — его собственное)
+    vector<size_t> trees;
+    vector<string> treeBlobs;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].treeRoot) continue;
+        size_t blobNodes = 0;
+        treeBlobs.push_back(treeBlob(*results[i].treeRoot, blobNodes));
+        trees.push_back(i);
+        
+        if (trees.size() == 1) htmlFile << "        <h2>Узлы деревьев</h2>\n";
+        htmlFile << "        <details id='treeNodes" << i << "'><summary>" << htmlEscape(results[i].algorithmName)
+                 << " — " << blobNodes << " узлов</summary><div class='lazy-body'></div></details>\n";
+    }
+    
+    // Блоки данных
+    ReportScript::writeBlob(htmlFile, "rowsData", rowsBlob(dataset, options));
+    ReportScript::writeBlob(htmlFile, "resultsData", resultsBlob(results));
+    if (!scaling.empty()) ReportScript::writeBlob(htmlFile, "scalingData", scalingBlob(scaling));
+    if (!history.empty()) ReportScript::writeBlob(htmlFile, "historyData", historyBlob(history));
+    if (profiled) ReportScript::writeBlob(htmlFile, "profileData", profileBlob(results));
+    if (hasLatency) ReportScript::writeBlob(htmlFile, "latencyData", latencyBlob(results));
+    for (size_t t = 0; t < trees.size(); ++t) {
+        ReportScript::writeBlob(htmlFile, "treeData" + to_string(trees[t]), treeBlobs[t]);
     }
     
-    htmlFile << "            \n";
-    htmlFile << "            // Создаем график\n";
-    htmlFile << "            var trace1 = {\n";
-    htmlFile << "                x: algorithms,\n";
-    htmlFile << "                y: accuracies,\n";
-    htmlFile << "                name: 'Точность',\n";
-    htmlFile << "                type: 'bar',\n";
-    htmlFile << "                marker: {color: '#3498db'}\n";
-    htmlFile << "            };\n";
-    htmlFile << "            \n";
-    htmlFile << "            var trace2 = {\n";
-    htmlFile << "                x: algorithms,\n";
-    htmlFile << "                y: f1Scores,\n";
-    htmlFile << "                name: 'F1-Score',\n";
-    htmlFile << "                type: 'bar',\n";
-    htmlFile << "                marker: {color: '#2ecc71'}\n";
-    htmlFile << "            };\n";
-    htmlFile << "            \n";
-    htmlFile << "            var data = [trace1, trace2];\n";
-    htmlFile << "            \n";
-    htmlFile << "            var layout = {\n";
-    htmlFile << "                title: 'Сравнение точности алгоритмов',\n";
-    htmlFile << "                xaxis: {title: 'Алгоритм'},\n";
-    htmlFile << "                yaxis: {title: 'Значение', range: [0, 1]},\n";
-    htmlFile << "                barmode: 'group'\n";
-    htmlFile << "            };\n";
-    htmlFile << "            \n";
-    htmlFile << "            Plotly.newPlot('accuracyChart', data, layout);\n";
+    htmlFile << "        <script>\n" << kInteractiveScript;
+    for (size_t i : trees) {
+        htmlFile << "            DT.whenOpened('treeNodes" << i << "', function (el) { nodeTable(el, 'treeData" << i << "'); });\n";
+    }
     htmlFile << "        </script>\n";
     
     htmlFile << "    </div>\n";
@@ -377,4 +1130,4 @@ void ReportGenerator::createInteractiveReport(
     htmlFile << "</html>\n";
     
     htmlFile.close();
-}
\ No newline at end of file
+}
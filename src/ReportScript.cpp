@@ -0,0 +1,380 @@
+#include "ReportScript.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+
+namespace {
+
+// Графики: bar (группы столбцов, отклонения, логарифмическая шкала) и line
+// (числовая или категориальная ось X); подсказки — элементы <title>.
+// Таблицы выводят только текущую страницу строк.
+const char* const kRuntime = R"JS(
+var DT = (function () {
+    var NS = 'http://www.w3.org/2000/svg';
+    var COLORS = ['#3498db', '#2ecc71', '#e74c3c', '#9b59b6', '#f39c12',
+                  '#1abc9c', '#34495e', '#e67e22', '#7f8c8d', '#c0392b'];
+    var cache = {};
+
+    // Блок данных разбирается при первом обращении
+    function data(id) {
+        if (!(id in cache)) {
+            var el = document.getElementById(id);
+            cache[id] = el ? JSON.parse(el.textContent) : null;
+        }
+        return cache[id];
+    }
+
+    function typed(column) {
+        var binary = atob(column.data);
+        var bytes = new Uint8Array(binary.length);
+        for (var i = 0; i < binary.length; i++) bytes[i] = binary.charCodeAt(i);
+        var Type = column.type === 'u8' ? Uint8Array : column.type === 'u16' ? Uint16Array :
+                   column.type === 'i32' ? Int32Array : column.type === 'f64' ? Float64Array : Uint32Array;
+        return new Type(bytes.buffer);
+    }
+
+    function node(tag, attrs, parent) {
+        var el = document.createElementNS(NS, tag);
+        for (var key in attrs) el.setAttribute(key, attrs[key]);
+        if (parent) parent.appendChild(el);
+        return el;
+    }
+
+    function label(parent, x, y, text, attrs) {
+        var el = node('text', attrs || {}, parent);
+        el.setAttribute('x', x);
+        el.setAttribute('y', y);
+        el.textContent = text;
+        return el;
+    }
+
+    function tip(el, text) {
+        node('title', {}, el).textContent = text;
+    }
+
+    function format(value) {
+        if (value === null || value === undefined || isNaN(value)) return '—';
+        var a = Math.abs(value);
+        if (a !== 0 && (a >= 1e6 || a < 1e-3)) return value.toExponential(2);
+        return String(Math.round(value * 1000) / 1000);
+    }
+
+    // Округленные деления оси (1, 2, 5 × 10^k); в логарифмической — степени 10
+    function ticks(min, max, log) {
+        var result = [];
+        if (log) {
+            for (var p = Math.floor(Math.log10(min)); p <= Math.ceil(Math.log10(max)); p++) result.push(Math.pow(10, p));
+            return result;
+        }
+        var raw = (max - min) / 5 || 1;
+        var base = Math.pow(10, Math.floor(Math.log10(raw)));
+        var step = raw / base > 5 ? 10 * base : raw / base > 2 ? 5 * base : raw / base > 1 ? 2 * base : base;
+        for (var t = Math.ceil(min / step) * step; t <= max + step * 1e-9; t += step) result.push(t);
+        return result;
+    }
+
+    function range(values, log, fixed) {
+        if (fixed) return fixed.slice();
+        var min = Infinity, max = -Infinity;
+        values.forEach(function (v) {
+            if (v === null || isNaN(v) || (log && v <= 0)) return;
+            min = Math.min(min, v);
+            max = Math.max(max, v);
+        });
+        if (min === Infinity) return log ? [1, 10] : [0, 1];
+        if (log) return [Math.pow(10, Math.floor(Math.log10(min))), Math.pow(10, Math.ceil(Math.log10(max)))];
+        min = Math.min(min, 0);
+        if (max === min) max = min + 1;
+        var top = ticks(min, max, false);
+        return [min, Math.max(max, top[top.length - 1])];
+    }
+
+    // Полотно с заголовком, осью Y и легендой; возвращает область построения
+    function frame(el, spec, yRange, series) {
+        el.innerHTML = '';
+        var width = Math.max(el.clientWidth || 0, 480), height = spec.height || 400;
+        var plot = {left: 70, right: width - 170, top: 40, bottom: height - 70};
+        var svg = node('svg', {width: width, height: height, 'font-family': 'Arial, sans-serif', 'font-size': 12}, el);
+        label(svg, width / 2, 22, spec.title || '', {'text-anchor': 'middle', 'font-size': 16});
+        var log = !!spec.log;
+        plot.y = function (v) {
+            var a = log ? Math.log10(yRange[0]) : yRange[0], b = log ? Math.log10(yRange[1]) : yRange[1];
+            var t = ((log ? Math.log10(v) : v) - a) / (b - a);
+            return plot.bottom - t * (plot.bottom - plot.top);
+        };
+        ticks(yRange[0], yRange[1], log).forEach(function (t) {
+            var y = plot.y(t);
+            node('line', {x1: plot.left, x2: plot.right, y1: y, y2: y, stroke: '#eee'}, svg);
+            label(svg, plot.left - 6, y + 4, format(t), {'text-anchor': 'end', fill: '#555'});
+        });
+        node('line', {x1: plot.left, x2: plot.left, y1: plot.top, y2: plot.bottom, stroke: '#999'}, svg);
+        node('line', {x1: plot.left, x2: plot.right, y1: plot.bottom, y2: plot.bottom, stroke: '#999'}, svg);
+        if (spec.yTitle) {
+            label(svg, 16, (plot.top + plot.bottom) / 2, spec.yTitle,
+                  {'text-anchor': 'middle', transform: 'rotate(-90 16 ' + (plot.top + plot.bottom) / 2 + ')'});
+        }
+        if (spec.xTitle) label(svg, (plot.left + plot.right) / 2, height - 8, spec.xTitle, {'text-anchor': 'middle'});
+        series.forEach(function (s, i) {
+            var y = plot.top + 18 * i;
+            node('rect', {x: plot.right + 16, y: y, width: 12, height: 12, fill: s.color || COLORS[i % COLORS.length]}, svg);
+            label(svg, plot.right + 34, y + 10, s.name);
+        });
+        plot.svg = svg;
+        return plot;
+    }
+
+    function categoryLabels(plot, categories, position) {
+        var rotate = categories.length > 8;
+        categories.forEach(function (name, i) {
+            var x = position(i), y = plot.bottom + 16;
+            label(plot.svg, x, y, name, rotate ? {'text-anchor': 'end', transform: 'rotate(-30 ' + x + ' ' + y + ')'}
+                                               : {'text-anchor': 'middle'});
+        });
+    }
+
+    // spec: {title, categories, series: [{name, values, errors}], yTitle, log, yRange}
+    function bar(el, spec) {
+        var all = [];
+        spec.series.forEach(function (s) {
+            s.values.forEach(function (v, i) { all.push(v + (s.errors ? s.errors[i] || 0 : 0)); });
+        });
+        var yRange = range(all, spec.log, spec.yRange);
+        var plot = frame(el, spec, yRange, spec.series);
+        var slot = (plot.right - plot.left) / Math.max(spec.categories.length, 1);
+        var barWidth = slot * 0.8 / spec.series.length;
+        var floor = plot.y(spec.log ? yRange[0] : Math.max(yRange[0], 0));
+        spec.series.forEach(function (s, k) {
+            s.values.forEach(function (v, i) {
+                if (v === null || isNaN(v) || (spec.log && v <= 0)) return;
+                var x = plot.left + slot * i + slot * 0.1 + barWidth * k, y = plot.y(v);
+                var rect = node('rect', {x: x, y: Math.min(y, floor), width: Math.max(barWidth - 1, 1),
+                                         height: Math.abs(floor - y), fill: COLORS[k % COLORS.length]}, plot.svg);
+                tip(rect, spec.categories[i] + ' · ' + s.name + ': ' + format(v) +
+                          (s.errors && s.errors[i] ? ' ± ' + format(s.errors[i]) : ''));
+                if (s.errors && s.errors[i]) {
+                    var cx = x + barWidth / 2;
+                    node('line', {x1: cx, x2: cx, y1: plot.y(v - s.errors[i]), y2: plot.y(v + s.errors[i]),
+                                  stroke: '#333'}, plot.svg);
+                }
+            });
+        });
+        categoryLabels(plot, spec.categories, function (i) { return plot.left + slot * (i + 0.5); });
+    }
+
+    // spec: {title, series: [{name, x, y, errors, text, dash}], xTitle, yTitle, category}
+    function line(el, spec) {
+        var categories = [], xs = [], ys = [];
+        spec.series.forEach(function (s) {
+            s.x.forEach(function (x, i) {
+                if (spec.category && categories.indexOf(x) < 0) categories.push(x);
+                xs.push(x);
+                ys.push(s.y[i] + (s.errors ? s.errors[i] || 0 : 0));
+            });
+        });
+        var yRange = range(ys, false, spec.yRange);
+        var plot = frame(el, spec, yRange, spec.series);
+        var position;
+        if (spec.category) {
+            var slot = (plot.right - plot.left) / Math.max(categories.length, 1);
+            position = function (x) { return plot.left + slot * (categories.indexOf(x) + 0.5); };
+            categoryLabels(plot, categories, function (i) { return plot.left + slot * (i + 0.5); });
+        } else {
+            var xRange = range(xs, false);
+            xRange[0] = Math.min.apply(null, xs);
+            if (xRange[1] === xRange[0]) xRange[1] = xRange[0] + 1;
+            position = function (x) {
+                return plot.left + (x - xRange[0]) / (xRange[1] - xRange[0]) * (plot.right - plot.left);
+            };
+            ticks(xRange[0], xRange[1], false).forEach(function (t) {
+                label(plot.svg, position(t), plot.bottom + 16, format(t), {'text-anchor': 'middle', fill: '#555'});
+            });
+        }
+        spec.series.forEach(function (s, k) {
+            var color = s.color || COLORS[k % COLORS.length];
+            var points = s.x.map(function (x, i) { return position(x) + ',' + plot.y(s.y[i]); });
+            node('polyline', {points: points.join(' '), fill: 'none', stroke: color, 'stroke-width': 2,
+                              'stroke-dasharray': s.dash ? '6 4' : 'none'}, plot.svg);
+            s.x.forEach(function (x, i) {
+                var cx = position(x), cy = plot.y(s.y[i]);
+                if (s.errors && s.errors[i]) {
+                    node('line', {x1: cx, x2: cx, y1: plot.y(s.y[i] - s.errors[i]), y2: plot.y(s.y[i] + s.errors[i]),
+                                  stroke: color}, plot.svg);
+                }
+                var dot = node('circle', {cx: cx, cy: cy, r: 4, fill: color}, plot.svg);
+                tip(dot, s.name + ' · ' + x + (s.text ? ' (' + s.text[i] + ')' : '') + ': ' + format(s.y[i]));
+            });
+        });
+    }
+
+    // spec: {columns, rowCount, cell(row, column) -> текст}; выводится одна страница
+    function table(el, spec, pageSize) {
+        pageSize = pageSize || 50;
+        var pages = Math.max(1, Math.ceil(spec.rowCount / pageSize)), page = 0;
+        el.innerHTML = '';
+        var nav = document.createElement('p');
+        var body = document.createElement('div');
+        el.appendChild(nav);
+        el.appendChild(body);
+        function button(text, target) {
+            var b = document.createElement('button');
+            b.textContent = text;
+            b.disabled = target < 0 || target >= pages || target === page;
+            b.onclick = function () { page = target; render(); };
+            nav.appendChild(b);
+        }
+        function render() {
+            nav.innerHTML = '';
+            if (pages > 1) {
+                button('«', 0);
+                button('‹', page - 1);
+                nav.appendChild(document.createTextNode(' Страница ' + (page + 1) + ' из ' + pages +
+                                                        ' (' + spec.rowCount + ' строк) '));
+                button('›', page + 1);
+                button('»', pages - 1);
+            }
+            var html = ['<table class="data-table"><tr>'];
+            spec.columns.forEach(function (c) { html.push('<th>', escape(c), '</th>'); });
+            html.push('</tr>');
+            var end = Math.min(spec.rowCount, (page + 1) * pageSize);
+            for (var r = page * pageSize; r < end; r++) {
+                html.push('<tr>');
+                for (var c = 0; c < spec.columns.length; c++) html.push('<td>', escape(spec.cell(r, c)), '</td>');
+                html.push('</tr>');
+            }
+            html.push('</table>');
+            body.innerHTML = html.join('');
+        }
+        render();
+    }
+
+    function escape(value) {
+        return String(value === null || value === undefined ? '—' : value)
+            .replace(/&/g, '&amp;').replace(/</g, '&lt;').replace(/>/g, '&gt;');
+    }
+
+    // Построение секции при ее появлении в окне (или сразу без IntersectionObserver)
+    function whenVisible(id, render) {
+        var el = document.getElementById(id);
+        if (!el) return;
+        if (!('IntersectionObserver' in window)) { render(el); return; }
+        var observer = new IntersectionObserver(function (entries) {
+            if (!entries.some(function (e) { return e.isIntersecting; })) return;
+            observer.disconnect();
+            render(el);
+        }, {rootMargin: '200px'});
+        observer.observe(el);
+    }
+
+    // Построение содержимого <details> при первом раскрытии
+    function whenOpened(id, render) {
+        var details = document.getElementById(id);
+        if (!details) return;
+        var done = false;
+        details.addEventListener('toggle', function () {
+            if (!details.open || done) return;
+            done = true;
+            render(details.querySelector('.lazy-body'));
+        });
+    }
+
+    return {data: data, typed: typed, bar: bar, line: line, table: table, format: format,
+            whenVisible: whenVisible, whenOpened: whenOpened};
+})();
+)JS";
+
+const char kBase64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+} // namespace
+
+const char* ReportScript::runtime() {
+    return kRuntime;
+}
+
+std::string ReportScript::quote(const std::string& text) {
+    std::string result;
+    result.reserve(text.size() + 2);
+    result += '"';
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            case '/':
+                if (i > 0 && text[i - 1] == '<') result += "\\/";
+                else result += c;
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    std::ostringstream code;
+                    code << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                    result += code.str();
+                } else {
+                    result += c;
+                }
+        }
+    }
+    result += '"';
+    return result;
+}
+
+std::string ReportScript::number(double value) {
+    if (!std::isfinite(value)) return "null";
+    std::ostringstream out;
+    out << std::setprecision(10) << value;
+    return out.str();
+}
+
+std::string ReportScript::numbers(const std::vector<double>& values) {
+    std::string result = "[";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) result += ',';
+        result += number(values[i]);
+    }
+    return result + "]";
+}
+
+std::string ReportScript::strings(const std::vector<std::string>& values) {
+    std::string result = "[";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) result += ',';
+        result += quote(values[i]);
+    }
+    return result + "]";
+}
+
+std::string ReportScript::base64(const void* data, size_t bytes) {
+    const unsigned char* input = static_cast<const unsigned char*>(data);
+    std::string result;
+    result.reserve((bytes + 2) / 3 * 4);
+    for (size_t i = 0; i < bytes; i += 3) {
+        std::uint32_t chunk = static_cast<std::uint32_t>(input[i]) << 16;
+        if (i + 1 < bytes) chunk |= static_cast<std::uint32_t>(input[i + 1]) << 8;
+        if (i + 2 < bytes) chunk |= input[i + 2];
+        result += kBase64Alphabet[(chunk >> 18) & 63];
+        result += kBase64Alphabet[(chunk >> 12) & 63];
+        result += i + 1 < bytes ? kBase64Alphabet[(chunk >> 6) & 63] : '=';
+        result += i + 2 < bytes ? kBase64Alphabet[chunk & 63] : '=';
+    }
+    return result;
+}
+
+std::string ReportScript::unsignedArray(const std::vector<std::uint32_t>& values) {
+    std::uint32_t largest = values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+    if (largest <= 0xFF) {
+        std::vector<std::uint8_t> narrow(values.begin(), values.end());
+        return "{\"type\":\"u8\",\"data\":\"" + base64(narrow.data(), narrow.size()) + "\"}";
+    }
+    if (largest <= 0xFFFF) {
+        std::vector<std::uint16_t> narrow(values.begin(), values.end());
+        return "{\"type\":\"u16\",\"data\":\"" + base64(narrow.data(), narrow.size() * 2) + "\"}";
+    }
+    return "{\"type\":\"u32\",\"data\":\"" + base64(values.data(), values.size() * 4) + "\"}";
+}
+
+void ReportScript::writeBlob(std::ostream& out, const std::string& id, const std::string& json) {
+    out << "<script type='application/json' id='" << id << "'>" << json << "</script>\n";
+}
@@ -0,0 +1,22 @@
+#include "ReportStream.h"
+
+ReportStream::ReportStream(const std::string& filename, size_t bufferSize)
+    : std::ostream(nullptr), buffer(bufferSize) {
+    // Буфер задается до открытия файла — иначе filebuf может его не принять
+    file.pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (file.open(filename, std::ios::out | std::ios::trunc)) {
+        rdbuf(&file);
+    } else {
+        setstate(std::ios::badbit);
+    }
+}
+
+ReportStream::~ReportStream() {
+    close();
+}
+
+void ReportStream::close() {
+    if (!file.is_open()) return;
+    flush();
+    file.close();
+}
@@ -0,0 +1,337 @@
+#include "ResultHistory.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+
+std::string jsonEscape(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '"' || c == '\\') result += '\\';
+        if (c == '\n') result += "\\n";
+        else result += c;
+    }
+    return result;
+}
+
+std::string jsonNumber(double value) {
+    if (!std::isfinite(value)) return "null";
+    std::ostringstream out;
+    out << std::setprecision(12) << value;
+    return out.str();
+}
+
+// Разбор плоского объекта JSON (значения — строки, числа, null) в пары
+// «ключ — текст значения»; false — строка не такого вида
+bool parseFlatObject(const std::string& line, std::map<std::string, std::string>& fields) {
+    size_t pos = 0;
+    auto skipSpaces = [&]() {
+        while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos]))) pos++;
+    };
+    auto readString = [&](std::string& out) {
+        if (pos >= line.size() || line[pos] != '"') return false;
+        pos++;
+        out.clear();
+        while (pos < line.size() && line[pos] != '"') {
+            if (line[pos] == '\\' && pos + 1 < line.size()) {
+                pos++;
+                out += line[pos] == 'n' ? '\n' : line[pos];
+            } else {
+                out += line[pos];
+            }
+            pos++;
+        }
+        if (pos >= line.size()) return false;
+        pos++;
+        return true;
+    };
+
+    skipSpaces();
+    if (pos >= line.size() || line[pos] != '{') return false;
+    pos++;
+    while (true) {
+        skipSpaces();
+        if (pos < line.size() && line[pos] == '}') return true;
+        std::string key, value;
+        if (!readString(key)) return false;
+        skipSpaces();
+        if (pos >= line.size() || line[pos] != ':') return false;
+        pos++;
+        skipSpaces();
+        if (pos < line.size() && line[pos] == '"') {
+            if (!readString(value)) return false;
+        } else {
+            size_t end = line.find_first_of(",}", pos);
+            if (end == std::string::npos) return false;
+            value = line.substr(pos, end - pos);
+            while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) value.pop_back();
+            pos = end;
+        }
+        fields[key] = value;
+        skipSpaces();
+        if (pos < line.size() && line[pos] == ',') {
+            pos++;
+            continue;
+        }
+        if (pos < line.size() && line[pos] == '}') return true;
+        return false;
+    }
+}
+
+double toDouble(const std::string& text) {
+    if (text.empty() || text == "null") return std::numeric_limits<double>::quiet_NaN();
+    return std::strtod(text.c_str(), nullptr);
+}
+
+size_t toSize(const std::string& text) {
+    return static_cast<size_t>(std::strtoull(text.c_str(), nullptr, 10));
+}
+
+// Регуляризованная неполная бета-функция I_x(a, b) (цепная дробь, метод Лентца)
+double incompleteBeta(double a, double b, double x) {
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    if (x > (a + 1.0) / (a + b + 2.0)) return 1.0 - incompleteBeta(b, a, 1.0 - x);
+
+    double logFront = std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                      a * std::log(x) + b * std::log(1.0 - x);
+    const double tiny = 1e-300;
+    double c = 1.0, d = 1.0 - (a + b) * x / (a + 1.0);
+    if (std::fabs(d) < tiny) d = tiny;
+    d = 1.0 / d;
+    double fraction = d;
+    for (int m = 1; m <= 300; ++m) {
+        double numerator = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+        d = 1.0 + numerator * d;
+        c = 1.0 + numerator / c;
+        if (std::fabs(d) < tiny) d = tiny;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        fraction *= d * c;
+
+        numerator = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+        d = 1.0 + numerator * d;
+        c = 1.0 + numerator / c;
+        if (std::fabs(d) < tiny) d = tiny;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        double delta = d * c;
+        fraction *= delta;
+        if (std::fabs(delta - 1.0) < 1e-12) break;
+    }
+    return std::exp(logFront) * fraction / a;
+}
+
+// Объединение средних и отклонений нескольких записей в одну выборку
+struct Pooled {
+    double mean = 0.0;
+    double std = 0.0;
+    size_t samples = 0;
+    size_t memory = 0;
+};
+
+Pooled pool(const std::vector<const HistoryRecord*>& records) {
+    Pooled result;
+    double sum = 0.0;
+    for (const HistoryRecord* record : records) {
+        result.samples += std::max<size_t>(record->timeSamples, 1);
+        sum += record->timeMean * std::max<size_t>(record->timeSamples, 1);
+        result.memory = std::max(result.memory, record->memoryBytes);
+    }
+    if (result.samples == 0) return result;
+    result.mean = sum / result.samples;
+
+    // Внутригрупповой и межгрупповой разброс
+    double squares = 0.0;
+    for (const HistoryRecord* record : records) {
+        size_t n = std::max<size_t>(record->timeSamples, 1);
+        double shift = record->timeMean - result.mean;
+        squares += (n - 1) * record->timeStd * record->timeStd + n * shift * shift;
+    }
+    result.std = result.samples > 1 ? std::sqrt(squares / (result.samples - 1)) : 0.0;
+    return result;
+}
+
+} // namespace
+
+std::string HistoryRecord::key() const {
+    return source + "|" + name + "|" + dataset + "|" + std::to_string(rows);
+}
+
+ResultHistory::ResultHistory(std::string filename) : filename(std::move(filename)) {}
+
+bool ResultHistory::append(const std::vector<HistoryRecord>& records) const {
+    size_t slash = filename.rfind('/');
+    if (slash != std::string::npos) {
+        std::error_code error;
+        std::filesystem::create_directories(filename.substr(0, slash), error);
+        if (error) {
+            std::cerr << "Ошибка создания каталога истории результатов: " << filename.substr(0, slash)
+                      << ": " << error.message() << std::endl;
+            return false;
+        }
+    }
+    std::ofstream file(filename, std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "Ошибка открытия истории результатов: " << filename << std::endl;
+        return false;
+    }
+    for (const auto& record : records) {
+        file << "{\"run\":\"" << jsonEscape(record.run) << "\""
+             << ",\"revision\":\"" << jsonEscape(record.revision) << "\""
+             << ",\"source\":\"" << jsonEscape(record.source) << "\""
+             << ",\"name\":\"" << jsonEscape(record.name) << "\""
+             << ",\"dataset\":\"" << jsonEscape(record.dataset) << "\""
+             << ",\"rows\":" << record.rows
+             << ",\"time_mean\":" << jsonNumber(record.timeMean)
+             << ",\"time_std\":" << jsonNumber(record.timeStd)
+             << ",\"time_samples\":" << record.timeSamples
+             << ",\"memory_bytes\":" << record.memoryBytes
+             << ",\"peak_resident\":" << record.peakResident
+             << ",\"accuracy\":" << jsonNumber(record.accuracy) << "}\n";
+    }
+    return file.good();
+}
+
+std::vector<HistoryRecord> ResultHistory::load() const {
+    std::vector<HistoryRecord> records;
+    std::ifstream file(filename);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::map<std::string, std::string> fields;
+        if (!parseFlatObject(line, fields) || !fields.count("run") || !fields.count("name")) continue;
+        HistoryRecord record;
+        record.run = fields["run"];
+        record.revision = fields["revision"];
+        record.source = fields["source"];
+        record.name = fields["name"];
+        record.dataset = fields["dataset"];
+        record.rows = toSize(fields["rows"]);
+        record.timeMean = toDouble(fields["time_mean"]);
+        record.timeStd = toDouble(fields["time_std"]);
+        if (std::isnan(record.timeStd)) record.timeStd = 0.0;
+        record.timeSamples = std::max<size_t>(toSize(fields["time_samples"]), 1);
+        record.memoryBytes = toSize(fields["memory_bytes"]);
+        record.peakResident = toSize(fields["peak_resident"]);
+        record.accuracy = toDouble(fields["accuracy"]);
+        records.push_back(record);
+    }
+    return records;
+}
+
+std::string ResultHistory::currentRevision() {
+    if (const char* revision = std::getenv("DT_REVISION")) {
+        if (*revision) return revision;
+    }
+    std::string revision;
+    if (FILE* pipe = popen("git describe --always --dirty 2>/dev/null", "r")) {
+        char buffer[128];
+        while (fgets(buffer, sizeof(buffer), pipe)) revision += buffer;
+        pclose(pipe);
+    }
+    while (!revision.empty() && std::isspace(static_cast<unsigned char>(revision.back()))) revision.pop_back();
+    return revision.empty() ? "unknown" : revision;
+}
+
+std::string ResultHistory::newRunId() {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm utc{};
+    gmtime_r(&now, &utc);
+    std::ostringstream id;
+    id << std::put_time(&utc, "%Y-%m-%dT%H:%M:%SZ") << "-" << getpid();
+    return id.str();
+}
+
+std::vector<std::string> ResultHistory::revisions(const std::vector<HistoryRecord>& records) {
+    std::vector<std::string> result;
+    for (const auto& record : records) {
+        if (std::find(result.begin(), result.end(), record.revision) == result.end()) {
+            result.push_back(record.revision);
+        }
+    }
+    return result;
+}
+
+std::string ResultHistory::findRevision(const std::vector<HistoryRecord>& records, const std::string& selector) {
+    std::string found;
+    for (const auto& record : records) {
+        if (record.run == selector || record.revision.compare(0, selector.size(), selector) == 0) {
+            found = record.revision;
+        }
+    }
+    return found;
+}
+
+double ResultHistory::welchPValue(double mean1, double std1, size_t n1,
+                                  double mean2, double std2, size_t n2) {
+    if (n1 < 2 || n2 < 2) return std::numeric_limits<double>::quiet_NaN();
+    double variance1 = std1 * std1 / n1;
+    double variance2 = std2 * std2 / n2;
+    double standardError = std::sqrt(variance1 + variance2);
+    if (standardError == 0.0) return mean2 > mean1 ? 0.0 : 1.0;
+
+    double t = (mean2 - mean1) / standardError;
+    // Степени свободы Уэлча — Саттертуэйта
+    double degrees = (variance1 + variance2) * (variance1 + variance2) /
+                     (variance1 * variance1 / (n1 - 1) + variance2 * variance2 / (n2 - 1));
+    double tail = 0.5 * incompleteBeta(degrees / 2.0, 0.5, degrees / (degrees + t * t));
+    return t > 0.0 ? tail : 1.0 - tail;
+}
+
+std::vector<RegressionFinding> ResultHistory::compare(const std::vector<HistoryRecord>& records,
+                                                      const std::string& baselineRevision,
+                                                      const std::string& currentRevision,
+                                                      const RegressionOptions& options) {
+    std::map<std::string, std::vector<const HistoryRecord*>> baseline, current;
+    std::vector<std::string> order;
+    for (const auto& record : records) {
+        if (record.revision == baselineRevision) {
+            baseline[record.key()].push_back(&record);
+        } else if (record.revision == currentRevision) {
+            if (!current.count(record.key())) order.push_back(record.key());
+            current[record.key()].push_back(&record);
+        }
+    }
+
+    std::vector<RegressionFinding> findings;
+    for (const auto& key : order) {
+        auto it = baseline.find(key);
+        if (it == baseline.end()) continue;
+        Pooled before = pool(it->second);
+        Pooled after = pool(current[key]);
+        const HistoryRecord& sample = *current[key].front();
+
+        RegressionFinding finding;
+        finding.source = sample.source;
+        finding.name = sample.name;
+        finding.dataset = sample.dataset;
+        finding.rows = sample.rows;
+        finding.baselineTime = before.mean;
+        finding.currentTime = after.mean;
+        finding.baselineSamples = before.samples;
+        finding.currentSamples = after.samples;
+        finding.timeChange = before.mean > 0.0 ? after.mean / before.mean - 1.0 : 0.0;
+        finding.pValue = welchPValue(before.mean, before.std, before.samples,
+                                     after.mean, after.std, after.samples);
+        finding.baselineMemory = before.memory;
+        finding.currentMemory = after.memory;
+        finding.memoryChange = before.memory > 0
+            ? static_cast<double>(after.memory) / before.memory - 1.0 : 0.0;
+        finding.slowdown = finding.timeChange > options.minSlowdown &&
+                           !std::isnan(finding.pValue) && finding.pValue < options.significance;
+        finding.memoryGrowth = finding.memoryChange > options.minMemoryGrowth;
+        findings.push_back(finding);
+    }
+    return findings;
+}
@@ -0,0 +1,187 @@
+#include "ScalingStudy.h"
+#include "DataGenerator.h"
+#include "CompiledTree.h"
+#include "RandomForest.h"
+#include "GradientBoosting.h"
+#include "Parallel.h"
+#include "ID3.h"
+#include "C45.h"
+#include "CART.h"
+#include "CHAID.h"
+#include "ExtraTree.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+using namespace std;
+
+namespace {
+
+// Строк в блоке параллельного предсказания одиночного дерева
+constexpr size_t kScoringBlock = 4096;
+
+// Модель в исследовании: обучение и пакетное предсказание при заданном
+// числе потоков (обучение модели, которую нужно предсказывать, — всегда
+// перед предсказанием)
+struct ScalingModel {
+    string name;
+    function<void(const EncodedDataset&, unsigned)> train;
+    function<size_t(const EncodedDataset&, unsigned)> score;
+};
+
+// Лучшее время из повторов
+double bestTime(int repetitions, const function<void()>& fn) {
+    double best = numeric_limits<double>::infinity();
+    for (int rep = 0; rep < repetitions; ++rep) {
+        auto start = chrono::steady_clock::now();
+        fn();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+ScalingModel singleTree(const string& name, function<unique_ptr<DecisionTree>()> factory) {
+    auto tree = shared_ptr<DecisionTree>(factory().release());
+    auto compiled = make_shared<CompiledTree>();
+    ScalingModel model;
+    model.name = name;
+    model.train = [tree, compiled](const EncodedDataset& data, unsigned) {
+        tree->trainEncoded(data);
+        *compiled = CompiledTree(*tree, data);
+    };
+    model.score = [compiled](const EncodedDataset& data, unsigned threads) {
+        size_t rows = data.getRowCount();
+        vector<EncodedDataset::Code> predictions(rows);
+        size_t blocks = (rows + kScoringBlock - 1) / kScoringBlock;
+        parallelFor(blocks, threads, [&](size_t block) {
+            size_t begin = block * kScoringBlock;
+            size_t end = min(rows, begin + kScoringBlock);
+            compiled->predictBatch(data, begin, end, predictions.data() + begin);
+        });
+        return rows > 0 ? static_cast<size_t>(predictions[rows / 2]) : 0;
+    };
+    return model;
+}
+
+ScalingModel forest(const string& name, RandomForest::TreeFactory factory, bool bootstrap,
+                    int treeCount) {
+    auto ensemble = make_shared<RandomForest>(factory);
+    ensemble->setTreeCount(treeCount);
+    ensemble->setBootstrap(bootstrap);
+    ScalingModel model;
+    model.name = name;
+    model.train = [ensemble](const EncodedDataset& data, unsigned threads) {
+        ensemble->setThreadCount(threads);
+        ensemble->train(data);
+    };
+    model.score = [ensemble](const EncodedDataset& data, unsigned threads) {
+        ensemble->setThreadCount(threads);
+        return ensemble->predictBatch(data).size();
+    };
+    return model;
+}
+
+ScalingModel boosting(int rounds) {
+    auto ensemble = make_shared<GradientBoosting>();
+    ensemble->setRounds(rounds);
+    ensemble->setMaxLeaves(31);
+    ScalingModel model;
+    model.name = "GradientBoosting";
+    model.train = [ensemble](const EncodedDataset& data, unsigned threads) {
+        ensemble->setThreadCount(threads);
+        ensemble->train(data);
+    };
+    model.score = [ensemble](const EncodedDataset& data, unsigned threads) {
+        ensemble->setThreadCount(threads);
+        return ensemble->predictBatch(data).size();
+    };
+    return model;
+}
+
+} // namespace
+
+ScalingStudy::ScalingStudy(vector<size_t> sizes, vector<unsigned> threadCounts, uint32_t seed)
+    : sizes(move(sizes)), threadCounts(move(threadCounts)), seed(seed) {
+    sort(this->threadCounts.begin(), this->threadCounts.end());
+    this->threadCounts.erase(unique(this->threadCounts.begin(), this->threadCounts.end()),
+                             this->threadCounts.end());
+    this->threadCounts.erase(remove(this->threadCounts.begin(), this->threadCounts.end(), 0u),
+                             this->threadCounts.end());
+    if (this->threadCounts.empty()) this->threadCounts = defaultThreadCounts();
+}
+
+vector<unsigned> ScalingStudy::defaultThreadCounts() {
+    unsigned cores = max(2u, defaultThreadCount());
+    vector<unsigned> counts;
+    for (unsigned threads = 1; threads < cores; threads *= 2) counts.push_back(threads);
+    counts.push_back(cores);
+    return counts;
+}
+
+vector<ScalingPoint> ScalingStudy::run() const {
+    vector<ScalingModel> models = {
+        singleTree("ID3", []() { return unique_ptr<DecisionTree>(new ID3Tree()); }),
+        singleTree("C4.5", []() { return unique_ptr<DecisionTree>(new C45Tree()); }),
+        singleTree("CART", []() { return unique_ptr<DecisionTree>(new CARTTree()); }),
+        singleTree("CHAID", []() { return unique_ptr<DecisionTree>(new CHAIDTree()); }),
+        forest("RandomForest", []() { return unique_ptr<DecisionTree>(new CARTTree()); }, true, ensembleSize),
+        forest("ExtraTrees", []() { return unique_ptr<DecisionTree>(new ExtraTree()); }, false, ensembleSize),
+        boosting(ensembleSize)
+    };
+
+    DataGenerator generator(GeneratorSchema::makeDefault(), seed);
+    vector<ScalingPoint> points;
+    for (size_t rows : sizes) {
+        EncodedDataset data = generator.generate(rows);
+        cout << "Набор из " << rows << " строк" << endl;
+
+        for (const auto& model : models) {
+            size_t first = points.size();
+            for (unsigned threads : threadCounts) {
+                ScalingPoint point;
+                point.algorithm = model.name;
+                point.rows = rows;
+                point.threads = threads;
+                point.trainingTime = bestTime(repetitions, [&]() { model.train(data, threads); });
+                point.scoringTime = bestTime(repetitions, [&]() { model.score(data, threads); });
+                points.push_back(point);
+            }
+
+            // Ускорение и эффективность относительно наименьшего числа потоков
+            const ScalingPoint& base = points[first];
+            for (size_t i = first; i < points.size(); ++i) {
+                ScalingPoint& point = points[i];
+                double growth = static_cast<double>(point.threads) / base.threads;
+                point.trainingSpeedup = point.trainingTime > 0.0 ? base.trainingTime / point.trainingTime : 1.0;
+                point.scoringSpeedup = point.scoringTime > 0.0 ? base.scoringTime / point.scoringTime : 1.0;
+                point.trainingEfficiency = point.trainingSpeedup / growth;
+                point.scoringEfficiency = point.scoringSpeedup / growth;
+                cout << "  " << model.name << ", потоков " << point.threads
+                     << ": обучение " << point.trainingTime << " с (×" << point.trainingSpeedup
+                     << "), предсказание " << point.scoringTime << " с (×" << point.scoringSpeedup << ")" << endl;
+            }
+        }
+    }
+    return points;
+}
+
+bool ScalingStudy::saveCSV(const vector<ScalingPoint>& points, const string& filename) {
+    ofstream csv(filename);
+    if (!csv.is_open()) {
+        cerr << "Ошибка открытия файла: " << filename << endl;
+        return false;
+    }
+    csv << "algorithm,rows,threads,training_time,scoring_time,training_speedup,"
+        << "scoring_speedup,training_efficiency,scoring_efficiency\n";
+    for (const auto& point : points) {
+        csv << point.algorithm << "," << point.rows << "," << point.threads << ","
+            << point.trainingTime << "," << point.scoringTime << ","
+            << point.trainingSpeedup << "," << point.scoringSpeedup << ","
+            << point.trainingEfficiency << "," << point.scoringEfficiency << "\n";
+    }
+    return true;
+}
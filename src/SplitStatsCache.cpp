@@ -0,0 +1,67 @@
+#include "SplitStatsCache.h"
+#include <mutex>
+
+SplitStatsCache::SplitStatsCache(const EncodedDataset& data,
+                                 const std::vector<std::uint32_t>& rowWeights,
+                                 size_t maxEntries)
+    : data(&data), contextFingerprint(fingerprint(data, rowWeights)), maxEntries(maxEntries) {}
+
+std::uint64_t SplitStatsCache::fingerprint(const EncodedDataset& data,
+                                           const std::vector<std::uint32_t>& rowWeights) {
+    // FNV-1a по размерам набора и весам строк
+    std::uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](std::uint64_t value) {
+        for (int byte = 0; byte < 8; ++byte) {
+            hash ^= (value >> (byte * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(data.getRowCount());
+    mix(data.getFeatureCount());
+    mix(data.getClassCount());
+    mix(rowWeights.size());
+    for (auto weight : rowWeights) mix(weight);
+    return hash;
+}
+
+bool SplitStatsCache::matches(const EncodedDataset& other,
+                              const std::vector<std::uint32_t>& rowWeights) const {
+    return &other == data && fingerprint(other, rowWeights) == contextFingerprint;
+}
+
+void SplitStatsCache::appendCode(std::string& path, std::uint32_t code) {
+    for (int byte = 0; byte < 4; ++byte) {
+        path.push_back(static_cast<char>((code >> (byte * 8)) & 0xff));
+    }
+}
+
+std::string SplitStatsCache::makeKey(const std::string& path, size_t feature) {
+    std::string key = path;
+    appendCode(key, static_cast<std::uint32_t>(feature));
+    return key;
+}
+
+SplitStatsCache::Table SplitStatsCache::find(const std::string& path, size_t feature) const {
+    std::string key = makeKey(path, feature);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = tables.find(key);
+    if (it == tables.end()) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    return it->second;
+}
+
+void SplitStatsCache::insert(const std::string& path, size_t feature, const ContingencyTable& table) {
+    std::string key = makeKey(path, feature);
+    auto stored = std::make_shared<const ContingencyTable>(table);
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (tables.size() >= maxEntries) return;
+    tables.emplace(std::move(key), std::move(stored));
+}
+
+size_t SplitStatsCache::getEntryCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return tables.size();
+}
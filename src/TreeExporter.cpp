@@ -0,0 +1,256 @@
+#include "TreeExporter.h"
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+
+using namespace std;
+
+TreeExporter::TreeExporter(ExportOptions options) : options(options) {}
+
+bool TreeExporter::open(const string& filename) {
+    file.open(filename, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        cerr << "Error opening export file: " << filename << endl;
+        return false;
+    }
+    buffer.clear();
+    buffer.reserve(options.bufferSize + 4096);
+    stack.clear();
+    writtenNodes = 0;
+    return true;
+}
+
+bool TreeExporter::finish() {
+    file.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    buffer.clear();
+    bool ok = file.good();
+    file.close();
+    return ok;
+}
+
+void TreeExporter::flushIfFull() {
+    if (buffer.size() < options.bufferSize) return;
+    file.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+bool TreeExporter::isCollapsed(const TreeNode& node, int depth) const {
+    if (node.isLeaf || node.children.empty()) return false;
+    if (options.maxDepth >= 0 && depth >= options.maxDepth) return true;
+    return node.samples < options.minSamples;
+}
+
+void TreeExporter::pushChildren(const TreeNode& node, long long id, int depth) {
+    // Потомки без повторов в порядке первого появления; в стек — в обратном,
+    // чтобы обход шел в порядке ветвей
+    size_t first = stack.size();
+    for (auto it = node.children.begin(); it != node.children.end(); ++it) {
+        const TreeNode* child = it->second.get();
+        if (!child) continue;
+        bool seen = false;
+        for (auto prev = node.children.begin(); prev != it; ++prev) {
+            if (prev->second.get() == child) {
+                seen = true;
+                break;
+            }
+        }
+        if (!seen) stack.push_back({child, &node, id, depth + 1});
+    }
+    reverse(stack.begin() + first, stack.end());
+}
+
+void TreeExporter::appendNumber(long long value) {
+    char text[24];
+    auto result = to_chars(text, text + sizeof(text), value);
+    buffer.append(text, result.ptr);
+}
+
+void TreeExporter::appendNumber(double value, int precision) {
+    char text[32];
+    auto result = precision < 0 ? to_chars(text, text + sizeof(text), value)
+                                : to_chars(text, text + sizeof(text), value, chars_format::fixed, precision);
+    buffer.append(text, result.ptr);
+}
+
+void TreeExporter::appendDotEscaped(const string& text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') buffer += '\\';
+        if (c == '\n') buffer += "\\n";
+        else if (c != '\r') buffer += c;
+    }
+}
+
+void TreeExporter::appendJSONEscaped(const string& text) {
+    for (char c : text) {
+        switch (c) {
+            case '"': buffer += "\\\""; break;
+            case '\\': buffer += "\\\\"; break;
+            case '\n': buffer += "\\n"; break;
+            case '\r': buffer += "\\r"; break;
+            case '\t': buffer += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) buffer += ' ';
+                else buffer += c;
+        }
+    }
+}
+
+void TreeExporter::appendEdgeLabel(const TreeNode& parent, const TreeNode* child, bool json) {
+    bool first = true;
+    for (const auto& [value, target] : parent.children) {
+        if (target.get() != child) continue;
+        if (!first) buffer += ", ";
+        first = false;
+        if (json) appendJSONEscaped(value);
+        else appendDotEscaped(value);
+    }
+}
+
+bool TreeExporter::writeDot(const TreeNode* root, const string& filename) {
+    return writeDot(vector<const TreeNode*>{root}, filename);
+}
+
+bool TreeExporter::writeDot(const vector<const TreeNode*>& roots, const string& filename) {
+    if (!open(filename)) return false;
+
+    append("digraph DecisionTree {\n"
+           "    node [fontname=\"Arial\", fontsize=10];\n"
+           "    edge [fontname=\"Arial\", fontsize=9];\n\n");
+
+    bool ensemble = roots.size() > 1;
+    long long nextId = 0;
+    for (size_t tree = 0; tree < roots.size(); ++tree) {
+        if (!roots[tree]) {
+            append("    empty");
+            appendNumber(static_cast<long long>(tree));
+            append(" [label=\"Empty tree\", shape=box, color=red];\n");
+            continue;
+        }
+        if (ensemble) {
+            append("  subgraph cluster_");
+            appendNumber(static_cast<long long>(tree));
+            append(" {\n    label=\"Tree ");
+            appendNumber(static_cast<long long>(tree));
+            append("\";\n");
+        }
+
+        stack.push_back({roots[tree], nullptr, -1, 0});
+        while (!stack.empty()) {
+            Frame frame = stack.back();
+            stack.pop_back();
+            const TreeNode& node = *frame.node;
+            long long id = nextId++;
+            bool collapsed = isCollapsed(node, frame.depth);
+
+            append("    node");
+            appendNumber(id);
+            append(" [label=\"");
+            if (node.isLeaf) {
+                append("Decision: ");
+                appendDotEscaped(node.decision);
+                append("\\nSamples: ");
+                appendNumber(static_cast<long long>(node.samples));
+                append("\\nConfidence: ");
+                appendNumber(node.confidence, 2);
+                append("\", shape=box, style=filled, fillcolor=lightgreen];\n");
+            } else {
+                appendDotEscaped(node.feature);
+                append("\\nSamples: ");
+                appendNumber(static_cast<long long>(node.samples));
+                if (collapsed) append("\\n(collapsed)\", shape=ellipse, style=\"filled,dashed\", fillcolor=lightgrey];\n");
+                else append("\", shape=ellipse, style=filled, fillcolor=lightblue];\n");
+            }
+
+            if (frame.parent) {
+                append("    node");
+                appendNumber(frame.parentId);
+                append(" -> node");
+                appendNumber(id);
+                append(" [label=\"");
+                appendEdgeLabel(*frame.parent, frame.node, false);
+                append("\"];\n");
+            }
+
+            writtenNodes++;
+            if (!node.isLeaf && !collapsed) pushChildren(node, id, frame.depth);
+            flushIfFull();
+        }
+
+        if (ensemble) append("  }\n");
+    }
+
+    append("}\n");
+    return finish();
+}
+
+bool TreeExporter::writeJSON(const TreeNode* root, const string& filename) {
+    return writeJSON(vector<const TreeNode*>{root}, filename);
+}
+
+bool TreeExporter::writeJSON(const vector<const TreeNode*>& roots, const string& filename) {
+    if (!open(filename)) return false;
+
+    append("{\"trees\":");
+    appendNumber(static_cast<long long>(roots.size()));
+    append(",\"nodes\":[\n");
+
+    long long nextId = 0;
+    for (size_t tree = 0; tree < roots.size(); ++tree) {
+        if (!roots[tree]) continue;
+        stack.push_back({roots[tree], nullptr, -1, 0});
+        while (!stack.empty()) {
+            Frame frame = stack.back();
+            stack.pop_back();
+            const TreeNode& node = *frame.node;
+            long long id = nextId++;
+            bool collapsed = isCollapsed(node, frame.depth);
+
+            if (id > 0) append(",\n");
+            append("{\"id\":");
+            appendNumber(id);
+            append(",\"tree\":");
+            appendNumber(static_cast<long long>(tree));
+            append(",\"parent\":");
+            appendNumber(frame.parentId);
+            append(",\"depth\":");
+            appendNumber(static_cast<long long>(frame.depth));
+            if (frame.parent) {
+                append(",\"edge\":\"");
+                appendEdgeLabel(*frame.parent, frame.node, true);
+                buffer += '"';
+            }
+            append(node.isLeaf ? ",\"leaf\":true" : ",\"leaf\":false");
+            if (!node.isLeaf) {
+                append(",\"feature\":\"");
+                appendJSONEscaped(node.feature);
+                buffer += '"';
+            }
+            if (!node.decision.empty()) {
+                append(",\"decision\":\"");
+                appendJSONEscaped(node.decision);
+                buffer += '"';
+            }
+            append(",\"samples\":");
+            appendNumber(static_cast<long long>(node.samples));
+            append(",\"confidence\":");
+            appendNumber(node.confidence);
+            if (!node.classCounts.empty()) {
+                append(",\"classCounts\":[");
+                for (size_t c = 0; c < node.classCounts.size(); ++c) {
+                    if (c > 0) buffer += ',';
+                    appendNumber(node.classCounts[c]);
+                }
+                buffer += ']';
+            }
+            if (collapsed) append(",\"collapsed\":true");
+            buffer += '}';
+
+            writtenNodes++;
+            if (!node.isLeaf && !collapsed) pushChildren(node, id, frame.depth);
+            flushIfFull();
+        }
+    }
+
+    append("\n]}\n");
+    return finish();
+}
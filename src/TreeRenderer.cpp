@@ -0,0 +1,308 @@
+#include "TreeRenderer.h"
+#include "ReportStream.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+
+// Узел раскладки. Поля — по Бухгейму: prelim/mod — предварительная
+// координата и сдвиг поддерева, thread — переход по контуру,
+// ancestor/change/shift — отложенное перемещение поддеревьев
+struct LayoutNode {
+    const TreeNode* node = nullptr;
+    string edgeLabel;                  // метка ветви от родителя
+    int parent = -1;
+    int number = 0;                    // номер среди братьев, с 1
+    vector<int> children;
+    size_t hiddenNodes = 0;            // > 0 — свернутое поддерево
+
+    double prelim = 0.0;
+    double mod = 0.0;
+    double shift = 0.0;
+    double change = 0.0;
+    int thread = -1;
+    int ancestor = -1;
+
+    double x = 0.0;
+    int depth = 0;
+};
+
+class Layout {
+public:
+    Layout(const TreeNode& root, const RenderOptions& options) : options(options) {
+        distance = options.nodeWidth + options.siblingGap;
+        add(root, "", -1, 1, 0);
+        firstWalk(0);
+        secondWalk(0, -nodes[0].prelim, 0);
+    }
+
+    vector<LayoutNode> nodes;
+
+private:
+    const RenderOptions& options;
+    double distance = 0.0;
+
+    static size_t countSubtree(const TreeNode& node) {
+        size_t count = 1;
+        for (const auto& child : DecisionTree::groupChildren(node)) {
+            if (child.second) count += countSubtree(*child.second);
+        }
+        return count;
+    }
+
+    int add(const TreeNode& node, const string& edgeLabel, int parent, int number, int depth) {
+        int index = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+        nodes[index].node = &node;
+        nodes[index].edgeLabel = edgeLabel;
+        nodes[index].parent = parent;
+        nodes[index].number = number;
+        nodes[index].ancestor = index;
+        nodes[index].depth = depth;
+        if (node.isLeaf) return index;
+
+        auto children = DecisionTree::groupChildren(node);
+        if (options.maxDepth >= 0 && depth >= options.maxDepth && !children.empty()) {
+            nodes[index].hiddenNodes = countSubtree(node) - 1;
+            return index;
+        }
+        int childNumber = 1;
+        for (const auto& [label, child] : children) {
+            if (!child) continue;
+            int childIndex = add(*child, label, index, childNumber++, depth + 1);
+            nodes[index].children.push_back(childIndex);
+        }
+        return index;
+    }
+
+    int leftSibling(int v) const {
+        const LayoutNode& node = nodes[v];
+        if (node.parent < 0 || node.number == 1) return -1;
+        return nodes[node.parent].children[node.number - 2];
+    }
+
+    int leftmostSibling(int v) const {
+        const LayoutNode& node = nodes[v];
+        if (node.parent < 0) return v;
+        return nodes[node.parent].children.front();
+    }
+
+    int nextLeft(int v) const {
+        return nodes[v].children.empty() ? nodes[v].thread : nodes[v].children.front();
+    }
+
+    int nextRight(int v) const {
+        return nodes[v].children.empty() ? nodes[v].thread : nodes[v].children.back();
+    }
+
+    void moveSubtree(int wl, int wr, double shift) {
+        double subtrees = nodes[wr].number - nodes[wl].number;
+        nodes[wr].change -= shift / subtrees;
+        nodes[wr].shift += shift;
+        nodes[wl].change += shift / subtrees;
+        nodes[wr].prelim += shift;
+        nodes[wr].mod += shift;
+    }
+
+    void executeShifts(int v) {
+        double shift = 0.0, change = 0.0;
+        const auto& children = nodes[v].children;
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            LayoutNode& w = nodes[*it];
+            w.prelim += shift;
+            w.mod += shift;
+            change += w.change;
+            shift += w.shift + change;
+        }
+    }
+
+    int ancestorOf(int vil, int v, int defaultAncestor) const {
+        int candidate = nodes[vil].ancestor;
+        return nodes[candidate].parent == nodes[v].parent ? candidate : defaultAncestor;
+    }
+
+    int apportion(int v, int defaultAncestor) {
+        int w = leftSibling(v);
+        if (w < 0) return defaultAncestor;
+
+        int vir = v, vor = v, vil = w, vol = leftmostSibling(v);
+        double sir = nodes[vir].mod, sor = nodes[vor].mod;
+        double sil = nodes[vil].mod, sol = nodes[vol].mod;
+        while (nextRight(vil) >= 0 && nextLeft(vir) >= 0) {
+            vil = nextRight(vil);
+            vir = nextLeft(vir);
+            vol = nextLeft(vol);
+            vor = nextRight(vor);
+            nodes[vor].ancestor = v;
+            double shift = (nodes[vil].prelim + sil) - (nodes[vir].prelim + sir) + distance;
+            if (shift > 0) {
+                moveSubtree(ancestorOf(vil, v, defaultAncestor), v, shift);
+                sir += shift;
+                sor += shift;
+            }
+            sil += nodes[vil].mod;
+            sir += nodes[vir].mod;
+            sol += nodes[vol].mod;
+            sor += nodes[vor].mod;
+        }
+        if (nextRight(vil) >= 0 && nextRight(vor) < 0) {
+            nodes[vor].thread = nextRight(vil);
+            nodes[vor].mod += sil - sor;
+        }
+        if (nextLeft(vir) >= 0 && nextLeft(vol) < 0) {
+            nodes[vol].thread = nextLeft(vir);
+            nodes[vol].mod += sir - sol;
+            defaultAncestor = v;
+        }
+        return defaultAncestor;
+    }
+
+    void firstWalk(int v) {
+        int sibling = leftSibling(v);
+        if (nodes[v].children.empty()) {
+            nodes[v].prelim = sibling >= 0 ? nodes[sibling].prelim + distance : 0.0;
+            return;
+        }
+        int defaultAncestor = nodes[v].children.front();
+        for (int child : nodes[v].children) {
+            firstWalk(child);
+            defaultAncestor = apportion(child, defaultAncestor);
+        }
+        executeShifts(v);
+        double midpoint = (nodes[nodes[v].children.front()].prelim +
+                           nodes[nodes[v].children.back()].prelim) / 2.0;
+        if (sibling >= 0) {
+            nodes[v].prelim = nodes[sibling].prelim + distance;
+            nodes[v].mod = nodes[v].prelim - midpoint;
+        } else {
+            nodes[v].prelim = midpoint;
+        }
+    }
+
+    void secondWalk(int v, double m, int depth) {
+        nodes[v].x = nodes[v].prelim + m;
+        nodes[v].depth = depth;
+        for (int child : nodes[v].children) secondWalk(child, m + nodes[v].mod, depth + 1);
+    }
+};
+
+string xmlEscape(const string& text) {
+    string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '<': result += "&lt;"; break;
+            case '>': result += "&gt;"; break;
+            case '&': result += "&amp;"; break;
+            case '"': result += "&quot;"; break;
+            default: result += c;
+        }
+    }
+    return result;
+}
+
+// Длинные метки ветвей (перечисления значений) укорачиваются
+string shorten(const string& text, size_t limit) {
+    if (text.size() <= limit) return text;
+    size_t cut = limit;
+    while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) cut--;  // граница UTF-8
+    return text.substr(0, cut) + "…";
+}
+
+} // namespace
+
+TreeRenderer::TreeRenderer(RenderOptions options) : options(options) {}
+
+bool TreeRenderer::renderSVG(const TreeNode* root, const string& filename) const {
+    ReportStream svg(filename);
+    if (!svg.is_open()) {
+        cerr << "Ошибка открытия файла SVG: " << filename << endl;
+        return false;
+    }
+
+    if (!root) {
+        svg << "<svg xmlns='http://www.w3.org/2000/svg' width='200' height='60'>"
+            << "<text x='20' y='35' fill='red'>Empty tree</text></svg>\n";
+        return svg.good();
+    }
+
+    Layout layout(*root, options);
+    double minX = 0.0, maxX = 0.0;
+    int maxDepth = 0;
+    for (const auto& node : layout.nodes) {
+        minX = min(minX, node.x);
+        maxX = max(maxX, node.x);
+        maxDepth = max(maxDepth, node.depth);
+    }
+    double halfWidth = options.nodeWidth / 2.0;
+    double offsetX = options.margin + halfWidth - minX;
+    double width = maxX - minX + options.nodeWidth + 2 * options.margin;
+    double height = (maxDepth + 1) * options.nodeHeight + maxDepth * options.levelGap + 2 * options.margin;
+    auto centerX = [&](const LayoutNode& node) { return node.x + offsetX; };
+    auto topY = [&](const LayoutNode& node) {
+        return options.margin + node.depth * (options.nodeHeight + options.levelGap);
+    };
+
+    svg << fixed << setprecision(1);
+    svg << "<svg xmlns='http://www.w3.org/2000/svg' width='" << width << "' height='" << height
+        << "' viewBox='0 0 " << width << " " << height << "' font-family='Arial' font-size='11'>\n";
+
+    // Ребра с метками
+    svg << "<g stroke='#7f8c8d' fill='none'>\n";
+    for (const auto& node : layout.nodes) {
+        if (node.parent < 0) continue;
+        const LayoutNode& parent = layout.nodes[node.parent];
+        svg << "<line x1='" << centerX(parent) << "' y1='" << topY(parent) + options.nodeHeight
+            << "' x2='" << centerX(node) << "' y2='" << topY(node) << "'/>\n";
+    }
+    svg << "</g>\n<g fill='#34495e' text-anchor='middle' font-size='9'>\n";
+    for (const auto& node : layout.nodes) {
+        if (node.parent < 0) continue;
+        const LayoutNode& parent = layout.nodes[node.parent];
+        double x = (centerX(parent) + centerX(node)) / 2.0;
+        double y = (topY(parent) + options.nodeHeight + topY(node)) / 2.0;
+        svg << "<text x='" << x << "' y='" << y << "'>" << xmlEscape(shorten(node.edgeLabel, 40)) << "</text>\n";
+    }
+    svg << "</g>\n";
+
+    // Узлы: листья — прямоугольники, внутренние — эллипсы, свернутые — пунктир
+    svg << "<g text-anchor='middle'>\n";
+    for (const auto& node : layout.nodes) {
+        const TreeNode& tree = *node.node;
+        double cx = centerX(node), top = topY(node);
+        double cy = top + options.nodeHeight / 2.0;
+        string first, second;
+        if (tree.isLeaf) {
+            svg << "<rect x='" << cx - halfWidth << "' y='" << top << "' width='" << options.nodeWidth
+                << "' height='" << options.nodeHeight << "' rx='6' fill='lightgreen' stroke='#27ae60'/>\n";
+            first = tree.decision;
+            stringstream ss;
+            ss << "n=" << tree.samples << ", " << fixed << setprecision(2) << tree.confidence;
+            second = ss.str();
+        } else {
+            svg << "<ellipse cx='" << cx << "' cy='" << cy << "' rx='" << halfWidth << "' ry='"
+                << options.nodeHeight / 2.0 << "' fill='lightblue' stroke='#2980b9'"
+                << (node.hiddenNodes > 0 ? " stroke-dasharray='4 3'" : "") << "/>\n";
+            first = tree.feature;
+            second = "n=" + to_string(tree.samples);
+            if (node.hiddenNodes > 0) second += ", свернуто " + to_string(node.hiddenNodes);
+        }
+        svg << "<text x='" << cx << "' y='" << cy - 3 << "'>" << xmlEscape(shorten(first, 24)) << "</text>\n";
+        svg << "<text x='" << cx << "' y='" << cy + 11 << "' font-size='9'>" << xmlEscape(second) << "</text>\n";
+    }
+    svg << "</g>\n</svg>\n";
+    return svg.good();
+}
+
+size_t TreeRenderer::renderAll(const vector<RenderJob>& jobs, unsigned threadCount) const {
+    vector<char> rendered(jobs.size(), 0);
+    parallelFor(jobs.size(), threadCount, [&](size_t i) {
+        rendered[i] = renderSVG(jobs[i].root.get(), jobs[i].filename) ? 1 : 0;
+    });
+    return static_cast<size_t>(count(rendered.begin(), rendered.end(), 1));
+}
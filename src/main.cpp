@@ -4,118 +4,685 @@
 #include <chrono>
 #include <iomanip>
 #include <cstdlib>
+#include <functional>
+#include <future>
+#include <sstream>
+#include <cmath>
 
 #include "Dataset.h"
 #include "ID3.h"
 #include "C45.h"
 #include "CART.h"
 #include "CHAID.h"
+#include "RandomForest.h"
+#include "ExtraTree.h"
+#include "GradientBoosting.h"
+#include "CrossValidation.h"
+#include "DepthSweep.h"
+#include "HyperparameterSearch.h"
+#include "SplitStatsCache.h"
+#include "Metrics.h"
+#include "DataGenerator.h"
+#include "Profiler.h"
+#include "MemoryUsage.h"
+#include "AllocationCounter.h"
+#include "LatencyBenchmark.h"
+#include "ScalingStudy.h"
+#include "TreeRenderer.h"
+#include "BatchRunner.h"
+#include "ResultHistory.h"
+#include "Parallel.h"
 #include "ReportGenerator.h"
 
 using namespace std;
 using namespace std::chrono;
 
+// Расчет метрик качества по закодированным предсказаниям для тестовой
+// выборки (коды классов — по словарям обучающей); probabilities —
+// вероятности классов по строкам, если модель их дает
+void computeMetrics(AlgorithmResult& result,
+                    const EncodedDataset& encodedTest,
+                    const vector<EncodedDataset::Code>& predictions,
+                    const vector<double>& probabilities = {}) {
+    size_t classCount = encodedTest.getClassCount();
+    ClassificationMetrics metrics = MetricsEngine::evaluate(
+        encodedTest.getTargets(), predictions, classCount, probabilities, 0, encodedTest.getWeights());
+    
+    result.accuracy = metrics.accuracy;
+    result.precision = metrics.macroPrecision;
+    result.recall = metrics.macroRecall;
+    result.f1Score = metrics.macroF1;
+    result.microF1 = metrics.microF1;
+    result.logLoss = metrics.logLoss;
+    result.auc = metrics.macroAuc;
+    result.classNames = encodedTest.getClassNames();
+    result.perClass = metrics.perClass;
+}
+
+// Добавление выделений памяти с момента снимка before к результату
+void addAllocations(AlgorithmResult& result, const AllocationSnapshot& before) {
+    AllocationSnapshot delta = AllocationCounter::difference(AllocationCounter::snapshot(), before);
+    for (size_t p = 0; p < kAllocationPhaseCount; ++p) {
+        result.allocations[p].count += delta[p].count;
+        result.allocations[p].bytes += delta[p].bytes;
+    }
+}
+
+// Одиночное дерево, обученное в отдельной задаче; само дерево нужно
+// и после задачи — для замеров задержки предсказания
+struct TrainedTree {
+    AlgorithmResult result;
+    unique_ptr<DecisionTree> tree;
+};
+
 // Функция для расчета метрик
+// (encodedTrain задан — обучение по закодированной выборке с общим
+// кэшем статистики узлов, иначе — по строковым примерам trainSet;
+// exclusive — задача выполняется одна, и RSS процесса относится к ней)
 AlgorithmResult evaluateAlgorithm(DecisionTree& tree,
                                  const Dataset& trainSet,
                                  const Dataset& testSet,
-                                 const string& algorithmName) {
+                                 const string& algorithmName,
+                                 const EncodedDataset* encodedTrain = nullptr,
+                                 SplitStatsCache* cache = nullptr,
+                                 bool exclusive = true) {
     
     AlgorithmResult result;
     result.algorithmName = algorithmName;
     
-    auto start = high_resolution_clock::now();
+    // Обучение однопоточное: профиль и время — только этого потока,
+    // поэтому деревья можно обучать одновременно
+    AllocationSnapshot allocationsBefore = AllocationCounter::snapshot();
+    Profiler::resetThread();
+    if (exclusive) result.residentBeforeTraining = MemoryUsage::currentResidentBytes();
+    double start = Profiler::threadCpuSeconds();
     
     // Обучение
-    tree.train(trainSet);
+    {
+        AllocationScope phase(AllocationPhase::Train);
+        if (encodedTrain) {
+            EncodedTrainOptions options;
+            options.cache = cache;
+            tree.trainEncoded(*encodedTrain, {}, options);
+        } else {
+            tree.train(trainSet);
+        }
+    }
     
-    auto end = high_resolution_clock::now();
-    result.trainingTime = duration_cast<milliseconds>(end - start).count() / 1000.0;
+    result.trainingTime = Profiler::threadCpuSeconds() - start;
+    result.profile = Profiler::collectThread();
+    if (exclusive) result.residentAfterTraining = MemoryUsage::currentResidentBytes();
+    
+    // Тестирование: тестовая выборка кодируется по словарям обучающей
+    EncodedDataset schema = encodedTrain ? EncodedDataset() : EncodedDataset(trainSet);
+    const EncodedDataset& trainSchema = encodedTrain ? *encodedTrain : schema;
+    EncodedDataset encodedTest(testSet, trainSchema);
+    CompiledTree compiled(tree, trainSchema);
+    vector<EncodedDataset::Code> predictions(encodedTest.getRowCount());
+    vector<double> probabilities;
+    {
+        AllocationScope phase(AllocationPhase::Predict);
+        compiled.predictBatch(encodedTest, 0, predictions.size(), predictions.data());
+        probabilities = compiled.predictProba(encodedTest);
+    }
+    {
+        AllocationScope phase(AllocationPhase::Evaluate);
+        computeMetrics(result, encodedTest, predictions, probabilities);
+    }
+    result.predictedRows = encodedTest.getRowCount();
+    if (exclusive) result.peakResident = MemoryUsage::peakResidentBytes();
     
-    // Тестирование
-    int correct = 0;
-    int total = 0;
-    int truePositives = 0, falsePositives = 0, falseNegatives = 0;
+    // Характеристики дерева
+    result.treeDepth = tree.getTreeDepth(tree.getRoot());
+    result.nodeCount = tree.countNodes(tree.getRoot());
+    result.modelMemory = MemoryUsage::ofTree(tree);
     
-    for (const auto& example : testSet.getExamples()) {
-        string prediction = tree.predict(example);
-        string actual = example.target;
-        
-        if (prediction == actual) {
-            correct++;
-        }
-        
-        // Для бинарной классификации
-        if (prediction == "Одобрить" && actual == "Одобрить") truePositives++;
-        if (prediction == "Одобрить" && actual == "Отказать") falsePositives++;
-        if (prediction == "Отказать" && actual == "Одобрить") falseNegatives++;
-        
-        total++;
+    // Генерация DOT файла
+    string dotFilename = "output/trees/" + algorithmName + "_tree.dot";
+    {
+        AllocationScope phase(AllocationPhase::Export);
+        tree.saveToDot(dotFilename);
     }
+    result.dotFilePath = dotFilename;
+    result.treeRoot = tree.getRoot();
+    addAllocations(result, allocationsBefore);
     
-    result.accuracy = static_cast<double>(correct) / total;
+    // Перцентили задержки предсказания измеряет вызывающий код, когда
+    // обучение других моделей не конкурирует за ядра
+    return result;
+}
+
+// Оценка ансамбля по закодированным данным: trainModel обучает модель
+// на закодированной обучающей выборке, predictModel возвращает коды
+// классов для тестовой, закодированной по тем же словарям
+AlgorithmResult evaluateEncoded(const Dataset& trainSet,
+                                const Dataset& testSet,
+                                const string& algorithmName,
+                                const function<void(const EncodedDataset&)>& trainModel,
+                                const function<vector<EncodedDataset::Code>(const EncodedDataset&)>& predictModel,
+                                const function<vector<double>(const EncodedDataset&)>& probabilityModel = nullptr) {
     
-    // Вычисление метрик
-    if (truePositives + falsePositives > 0) {
-        result.precision = static_cast<double>(truePositives) / (truePositives + falsePositives);
-    } else {
-        result.precision = 0.0;
-    }
+    AlgorithmResult result;
+    result.algorithmName = algorithmName;
     
-    if (truePositives + falseNegatives > 0) {
-        result.recall = static_cast<double>(truePositives) / (truePositives + falseNegatives);
-    } else {
-        result.recall = 0.0;
+    AllocationSnapshot allocationsBefore = AllocationCounter::snapshot();
+    Profiler::reset();
+    result.residentBeforeTraining = MemoryUsage::currentResidentBytes();
+    auto start = high_resolution_clock::now();
+    
+    EncodedDataset encodedTrain(trainSet);
+    {
+        AllocationScope phase(AllocationPhase::Train);
+        trainModel(encodedTrain);
     }
     
-    if (result.precision + result.recall > 0) {
-        result.f1Score = 2 * result.precision * result.recall / (result.precision + result.recall);
-    } else {
-        result.f1Score = 0.0;
+    auto end = high_resolution_clock::now();
+    result.trainingTime = duration<double>(end - start).count();
+    result.profile = Profiler::collect();
+    result.residentAfterTraining = MemoryUsage::currentResidentBytes();
+    
+    EncodedDataset encodedTest(testSet, encodedTrain);
+    vector<EncodedDataset::Code> predictions;
+    vector<double> probabilities;
+    {
+        AllocationScope phase(AllocationPhase::Predict);
+        predictions = predictModel(encodedTest);
+        if (probabilityModel) probabilities = probabilityModel(encodedTest);
+    }
+    {
+        AllocationScope phase(AllocationPhase::Evaluate);
+        computeMetrics(result, encodedTest, predictions, probabilities);
     }
+    result.predictedRows = encodedTest.getRowCount();
+    result.peakResident = MemoryUsage::peakResidentBytes();
+    addAllocations(result, allocationsBefore);
     
-    // Характеристики дерева
-    result.treeDepth = tree.getTreeDepth(tree.getRoot());
-    result.nodeCount = tree.countNodes(tree.getRoot());
+    return result;
+}
+
+// Оценка случайного леса: обучение по общему закодированному набору,
+// предсказание — пакетным голосованием всех деревьев
+AlgorithmResult evaluateForest(RandomForest& forest,
+                               const Dataset& trainSet,
+                               const Dataset& testSet,
+                               const string& algorithmName) {
+    
+    AlgorithmResult result = evaluateEncoded(trainSet, testSet, algorithmName,
+        [&](const EncodedDataset& data) { forest.train(data); },
+        [&](const EncodedDataset& data) { return forest.predictBatch(data); },
+        [&](const EncodedDataset& data) { return forest.predictProba(data); });
+    
+    // Характеристики ансамбля: наибольшая глубина и суммарное число узлов
+    result.treeDepth = 0;
+    result.nodeCount = 0;
+    for (size_t i = 0; i < forest.getTreeCount(); ++i) {
+        const DecisionTree& tree = forest.getTree(i);
+        result.treeDepth = max(result.treeDepth, tree.getTreeDepth(tree.getRoot()));
+        result.nodeCount += tree.countNodes(tree.getRoot());
+        result.modelMemory += MemoryUsage::ofTree(tree);
+    }
     
-    // Генерация DOT файла
+    // DOT файл первого дерева ансамбля и JSON всех деревьев
     string dotFilename = "output/trees/" + algorithmName + "_tree.dot";
-    tree.saveToDot(dotFilename);
+    if (forest.getTreeCount() > 0) {
+        AllocationSnapshot allocationsBefore = AllocationCounter::snapshot();
+        {
+            AllocationScope phase(AllocationPhase::Export);
+            forest.getTree(0).saveToDot(dotFilename);
+            forest.saveToJSON("output/trees/" + algorithmName + "_forest.json");
+        }
+        addAllocations(result, allocationsBefore);
+        result.treeRoot = forest.getTree(0).getRoot();
+    }
     result.dotFilePath = dotFilename;
     
     return result;
 }
 
-// Функция для генерации изображений деревьев
-void generateTreeImages() {
+// Оценка градиентного бустинга на гистограммных деревьях CART
+AlgorithmResult evaluateBoosting(GradientBoosting& boosting,
+                                 const Dataset& trainSet,
+                                 const Dataset& testSet,
+                                 const string& algorithmName) {
+    
+    AlgorithmResult result = evaluateEncoded(trainSet, testSet, algorithmName,
+        [&](const EncodedDataset& data) { boosting.train(data); },
+        [&](const EncodedDataset& data) { return boosting.predictBatch(data); },
+        [&](const EncodedDataset& data) { return boosting.predictProba(data); });
+    
+    result.treeDepth = 0;
+    result.nodeCount = 0;
+    for (size_t i = 0; i < boosting.getTreeCount(); ++i) {
+        const CARTTree& tree = boosting.getTree(i);
+        result.treeDepth = max(result.treeDepth, tree.getRegressionDepth());
+        result.nodeCount += static_cast<int>(tree.getRegressionNodeCount());
+        result.modelMemory.nodes += tree.getRegressionBytes();
+    }
+    result.dotFilePath = "";
+    
+    return result;
+}
+
+// Модель ансамбля для кросс-валидации: make создает ее с теми же параметрами,
+// что и для обучающей выборки; время — только обучения, без кодирования
+template <typename Make>
+CrossValidation::FoldModel ensembleFoldModel(Make make) {
+    return [make](const EncodedDataset& train, const EncodedDataset& test) {
+        auto model = make();
+        CrossValidation::FoldPredictions predictions;
+        auto start = high_resolution_clock::now();
+        model->train(train);
+        predictions.trainingTime = duration<double>(high_resolution_clock::now() - start).count();
+        predictions.classes = model->predictBatch(test);
+        predictions.probabilities = model->predictProba(test);
+        return predictions;
+    };
+}
+
+// Перенос метрик кросс-валидации в результаты одноименных алгоритмов:
+// отчеты показывают устойчивые средние по фолдам вместо одного разбиения
+// для всех моделей (время обучения и метрики по классам — тоже средние
+// по фолдам); структура дерева, DOT и память остаются от модели,
+// обученной на обучающей выборке
+void mergeCrossValidation(vector<AlgorithmResult>& results,
+                          const vector<AlgorithmResult>& cvResults) {
+    for (auto& result : results) {
+        for (const auto& cv : cvResults) {
+            if (cv.algorithmName != result.algorithmName) continue;
+            result.folds = cv.folds;
+            result.accuracy = cv.accuracy;
+            result.accuracyStd = cv.accuracyStd;
+            result.precision = cv.precision;
+            result.precisionStd = cv.precisionStd;
+            result.recall = cv.recall;
+            result.recallStd = cv.recallStd;
+            result.f1Score = cv.f1Score;
+            result.f1ScoreStd = cv.f1ScoreStd;
+            result.microF1 = cv.microF1;
+            result.logLoss = cv.logLoss;
+            result.auc = cv.auc;
+            result.trainingTime = cv.trainingTime;
+            result.trainingTimeStd = cv.trainingTimeStd;
+            result.classNames = cv.classNames;
+            result.perClass = cv.perClass;
+        }
+    }
+}
+
+// Дополнение пробелами до width символов: setw считает байты, а кириллица
+// в UTF-8 занимает два байта на символ
+string padColumn(const string& text, size_t width) {
+    size_t symbols = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80) symbols++;
+    }
+    return text + string(width > symbols ? width - symbols : 1, ' ');
+}
+
+// Поддеревья глубже kRenderDepth на изображениях сворачиваются в один узел
+const int kRenderDepth = 8;
+
+// Отрисовка дерева результата в SVG встроенной раскладкой
+bool renderTreeImage(AlgorithmResult& result) {
+    if (!result.treeRoot) return false;  // модели без дерева (бустинг)
+    RenderOptions options;
+    options.maxDepth = kRenderDepth;
+    string filename = "output/trees/" + result.algorithmName + "_tree.svg";
+    if (!TreeRenderer(options).renderSVG(result.treeRoot.get(), filename)) return false;
+    result.svgFilePath = filename;
+    return true;
+}
+
+// Отрисовка еще не нарисованных деревьев, параллельно по деревьям
+void generateTreeImages(vector<AlgorithmResult>& results) {
     cout << "\nГенерация изображений деревьев..." << endl;
     
-    vector<string> algorithms = {"ID3", "C4.5", "CART", "CHAID"};
+    RenderOptions options;
+    options.maxDepth = kRenderDepth;
+    
+    vector<RenderJob> jobs;
+    vector<AlgorithmResult*> owners;
+    for (auto& result : results) {
+        if (!result.treeRoot || !result.svgFilePath.empty()) continue;
+        jobs.push_back({result.treeRoot, "output/trees/" + result.algorithmName + "_tree.svg"});
+        owners.push_back(&result);
+    }
+    TreeRenderer(options).renderAll(jobs);
     
-    for (const auto& algo : algorithms) {
-        string dotFile = "output/trees/" + algo + "_tree.dot";
-        string pngFile = "output/trees/" + algo + "_tree.png";
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        ifstream test(jobs[i].filename);
+        if (test.good()) owners[i]->svgFilePath = jobs[i].filename;
+    }
+    for (const auto& result : results) {
+        if (!result.svgFilePath.empty()) {
+            cout << "  Сгенерировано: " << result.svgFilePath << endl;
+        } else if (result.treeRoot) {
+            cout << "  Не удалось сгенерировать SVG для " << result.algorithmName << endl;
+        }
+    }
+}
+
+// Режим подбора глубины: каждое дерево обучается один раз до maxDepth,
+// точность на глубинах 0..maxDepth — за один проход тестовой выборки
+int runDepthSweep(int maxDepth) {
+    cout << "================================================" << endl;
+    cout << "Подбор глубины деревьев (одно обучение на алгоритм)" << endl;
+    cout << "================================================" << endl << endl;
+    
+    Dataset dataset;
+    dataset.createBankLoanData();
+    auto [trainSet, testSet] = dataset.split(0.7, 42);
+    EncodedDataset encodedTrain(trainSet);
+    EncodedDataset encodedTest(testSet, encodedTrain);
+    
+    vector<pair<string, function<unique_ptr<DecisionTree>(int)>>> algorithms = {
+        {"ID3", [](int depth) { auto tree = make_unique<ID3Tree>(); tree->setMaxDepth(depth); return unique_ptr<DecisionTree>(move(tree)); }},
+        {"C4.5", [](int depth) { auto tree = make_unique<C45Tree>(); tree->setMaxDepth(depth); return unique_ptr<DecisionTree>(move(tree)); }},
+        {"CART", [](int depth) { auto tree = make_unique<CARTTree>(); tree->setMaxDepth(depth); return unique_ptr<DecisionTree>(move(tree)); }},
+        {"CHAID", [](int depth) { auto tree = make_unique<CHAIDTree>(); tree->setMaxDepth(depth); return unique_ptr<DecisionTree>(move(tree)); }}
+    };
+    
+    system("mkdir -p output/reports");
+    ofstream csv("output/reports/depth_sweep.csv");
+    csv << "algorithm,depth,accuracy\n";
+    
+    cout << left << setw(10) << "Глубина";
+    for (const auto& algorithm : algorithms) cout << setw(10) << algorithm.first;
+    cout << endl << string(10 * (algorithms.size() + 1), '-') << endl;
+    
+    vector<vector<double>> accuracies;
+    for (const auto& [name, makeTree] : algorithms) {
+        auto tree = makeTree(maxDepth);
+        tree->trainEncoded(encodedTrain);
+        CompiledTree compiled(*tree, encodedTrain);
+        accuracies.push_back(DepthSweep::evaluate(compiled, encodedTest, maxDepth));
+        for (int depth = 0; depth <= maxDepth; ++depth) {
+            csv << name << "," << depth << "," << accuracies.back()[depth] << "\n";
+        }
+    }
+    
+    for (int depth = 0; depth <= maxDepth; ++depth) {
+        cout << left << setw(10) << depth;
+        for (const auto& accuracy : accuracies) {
+            cout << setw(10) << fixed << setprecision(4) << accuracy[depth];
+        }
+        cout << endl;
+    }
+    
+    cout << endl;
+    for (size_t i = 0; i < algorithms.size(); ++i) {
+        int best = DepthSweep::bestDepth(accuracies[i]);
+        cout << algorithms[i].first << ": лучшая глубина " << best 
+             << " (точность " << fixed << setprecision(2) << accuracies[i][best] * 100 << "%)" << endl;
+    }
+    cout << "\nТаблица сохранена: output/reports/depth_sweep.csv" << endl;
+    return 0;
+}
+
+// Режим подбора гиперпараметров: перебор сетки (или randomCount случайных
+// точек сетки) для каждого алгоритма с оценкой кросс-валидацией
+int runTuning(size_t randomCount) {
+    cout << "================================================" << endl;
+    cout << "Подбор гиперпараметров (" 
+         << (randomCount > 0 ? "случайный поиск" : "поиск по сетке") << ")" << endl;
+    cout << "================================================" << endl << endl;
+    
+    Dataset dataset;
+    dataset.createBankLoanData();
+    EncodedDataset encoded(dataset);
+    
+    ParameterGrid grid;
+    HyperparameterSearch search(5, 42);
+    
+    system("mkdir -p output/reports");
+    ofstream csv("output/reports/tuning.csv");
+    csv << "algorithm,maxDepth,minSamplesSplit,significanceLevel,minGainRatio,"
+        << "minImpurityDecrease,accuracy,accuracyStd,nodeCount,trainingTime\n";
+    
+    for (const char* algorithm : {"ID3", "C4.5", "CART", "CHAID"}) {
+        vector<TuningConfig> configs = randomCount > 0
+            ? HyperparameterSearch::randomConfigs(algorithm, grid, randomCount, 42)
+            : HyperparameterSearch::gridConfigs(algorithm, grid);
+        
+        auto start = high_resolution_clock::now();
+        auto results = search.evaluate(encoded, configs);
+        auto end = high_resolution_clock::now();
+        
+        size_t lookups = search.getCacheHitCount() + search.getCacheMissCount();
+        cout << algorithm << ": " << configs.size() << " конфигураций за "
+             << fixed << setprecision(3) << duration<double>(end - start).count() << " с"
+             << ", попаданий в кэш узлов: " << setprecision(1)
+             << (lookups > 0 ? 100.0 * search.getCacheHitCount() / lookups : 0.0) << "%" << endl;
         
-        // Проверяем существование DOT файла
-        ifstream test(dotFile);
-        if (!test.good()) {
-            cout << "  Предупреждение: " << dotFile << " не найден" << endl;
-            continue;
+        for (size_t i = 0; i < min<size_t>(3, results.size()); ++i) {
+            cout << "   " << i + 1 << ". " << results[i].config.toString()
+                 << "  точность " << setprecision(2) << results[i].accuracy * 100
+                 << "% ± " << results[i].accuracyStd * 100 << "%" << endl;
         }
-        test.close();
         
-        // Генерируем PNG
-        string command = "dot -Tpng \"" + dotFile + "\" -o \"" + pngFile + "\" 2>/dev/null";
-        int result = system(command.c_str());
-        if (result == 0) {
-            cout << "  Сгенерировано: " << pngFile << endl;
-        } else {
-            cout << "  Не удалось сгенерировать PNG для " << algo << endl;
+        for (const auto& result : results) {
+            const TuningConfig& config = result.config;
+            csv << config.algorithm << "," << config.maxDepth << "," << config.minSamplesSplit << ","
+                << config.significanceLevel << "," << config.minGainRatio << ","
+                << config.minImpurityDecrease << "," << result.accuracy << ","
+                << result.accuracyStd << "," << result.nodeCount << "," << result.trainingTime << "\n";
         }
     }
+    cout << "\nРезультаты сохранены: output/reports/tuning.csv" << endl;
+    return 0;
+}
+
+// Режим генерации синтетических данных: rows строк по схеме по умолчанию
+// в CSV или двоичный формат EncodedDataset (расширение .bin)
+int runGenerate(size_t rows, const string& filename) {
+    DataGenerator generator(GeneratorSchema::makeDefault(), 42);
+    
+    auto start = high_resolution_clock::now();
+    EncodedDataset data = generator.generate(rows);
+    auto end = high_resolution_clock::now();
+    cout << "Сгенерировано " << data.getRowCount() << " строк, " << data.getFeatureCount()
+         << " признаков за " << fixed << setprecision(3) << duration<double>(end - start).count()
+         << " с" << endl;
+    
+    bool binary = filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0;
+    start = high_resolution_clock::now();
+    bool saved = binary ? data.saveBinary(filename) : DataGenerator::writeCSV(data, filename);
+    end = high_resolution_clock::now();
+    if (!saved) return 1;
+    cout << "Записано в " << filename << " за " << duration<double>(end - start).count() << " с" << endl;
+    return 0;
+}
+
+// Список чисел через запятую: «1000,10000»
+vector<size_t> parseNumberList(const string& text) {
+    vector<size_t> numbers;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) numbers.push_back(static_cast<size_t>(atoll(item.c_str())));
+    }
+    return numbers;
 }
 
-int main() {
+// Исследование масштабирования по потокам и размерам набора; точки
+// сохраняются в CSV и затем попадают в интерактивный отчет
+vector<ScalingPoint> runScaling(const string& sizesText, const string& threadsText) {
+    cout << "================================================" << endl;
+    cout << "Масштабирование обучения и предсказания по потокам" << endl;
+    cout << "================================================" << endl << endl;
+    
+    vector<size_t> sizes = parseNumberList(sizesText);
+    if (sizes.empty()) sizes = {10000, 50000};
+    vector<unsigned> threads;
+    for (size_t count : parseNumberList(threadsText)) threads.push_back(static_cast<unsigned>(count));
+    
+    ScalingStudy study(sizes, threads);
+    vector<ScalingPoint> points = study.run();
+    
+    system("mkdir -p output/reports");
+    if (ScalingStudy::saveCSV(points, "output/reports/scaling.csv")) {
+        cout << "Точки сохранены: output/reports/scaling.csv" << endl << endl;
+    }
+    return points;
+}
+
+// Пакетный запуск экспериментов из манифеста (см. ExperimentManifest)
+int runBatch(const string& manifestPath) {
+    ExperimentManifest manifest;
+    if (!manifest.load(manifestPath)) return 1;
+    
+    const BatchSettings& settings = manifest.getSettings();
+    size_t jobCount = manifest.expandJobs().size();
+    cout << "Пакетный запуск " << manifestPath << ": " << jobCount << " заданий, "
+         << manifest.getDatasets().size() << " наборов данных, рабочих потоков: "
+         << (settings.workers > 0 ? settings.workers : defaultThreadCount());
+    if (settings.memoryLimit > 0) cout << ", лимит памяти наборов " << MemoryUsage::formatBytes(settings.memoryLimit);
+    cout << endl << endl;
+    
+    auto start = high_resolution_clock::now();
+    BatchRunner runner(manifest);
+    bool succeeded = runner.run();
+    double seconds = duration<double>(high_resolution_clock::now() - start).count();
+    
+    size_t failed = 0;
+    for (const auto& result : runner.getResults()) {
+        if (!result.succeeded) failed++;
+    }
+    cout << "\nЗаданий: " << runner.getResults().size() << ", с ошибкой: " << failed
+         << ", загрузок наборов: " << runner.getDatasetLoads()
+         << ", наибольший объем загруженных наборов: " << MemoryUsage::formatBytes(runner.getPeakLoadedBytes())
+         << ", время: " << fixed << setprecision(2) << seconds << " с" << endl;
+    cout << "Результаты: " << settings.outputDirectory << "/results.jsonl" << endl;
+    return succeeded ? 0 : 1;
+}
+
+// История результатов: сравнение и бенчмарки дописывают в нее записи
+const char* const kHistoryFile = "output/history.jsonl";
+
+// Записи истории для результатов сравнения на наборе с отпечатком dataset
+vector<HistoryRecord> makeHistoryRecords(const vector<AlgorithmResult>& results,
+                                         const string& dataset, size_t rows) {
+    string run = ResultHistory::newRunId();
+    string revision = ResultHistory::currentRevision();
+    vector<HistoryRecord> records;
+    for (const auto& result : results) {
+        HistoryRecord record;
+        record.run = run;
+        record.revision = revision;
+        record.source = "comparison";
+        record.name = result.algorithmName;
+        record.dataset = dataset;
+        record.rows = rows;
+        record.timeMean = result.trainingTime;
+        record.timeStd = result.trainingTimeStd;
+        record.timeSamples = static_cast<size_t>(max(result.folds, 1));
+        record.memoryBytes = result.modelMemory.total();
+        record.peakResident = result.peakResident;
+        record.accuracy = result.accuracy;
+        records.push_back(record);
+    }
+    return records;
+}
+
+// Режим --compare: базовая и текущая ревизии (префикс или идентификатор
+// запуска; по умолчанию — две последние в истории); код возврата 1 —
+// найдены регрессии
+int runCompare(const string& baselineSelector, const string& currentSelector) {
+    ResultHistory history(kHistoryFile);
+    vector<HistoryRecord> records = history.load();
+    vector<string> revisions = ResultHistory::revisions(records);
+    if (revisions.size() < 2 && (baselineSelector.empty() || currentSelector.empty())) {
+        cerr << "В истории " << kHistoryFile << " меньше двух ревизий для сравнения" << endl;
+        return 1;
+    }
+    
+    string current = currentSelector.empty() ? revisions.back()
+                                             : ResultHistory::findRevision(records, currentSelector);
+    string baseline;
+    if (!baselineSelector.empty()) {
+        baseline = ResultHistory::findRevision(records, baselineSelector);
+    } else {
+        // Последняя ревизия до текущей
+        for (const auto& revision : revisions) {
+            if (revision == current) break;
+            baseline = revision;
+        }
+    }
+    if (baseline.empty() || current.empty() || baseline == current) {
+        cerr << "Не найдены разные ревизии для сравнения" << endl;
+        return 1;
+    }
+    
+    RegressionOptions options;
+    auto findings = ResultHistory::compare(records, baseline, current, options);
+    cout << "Сравнение ревизий: " << baseline << " → " << current
+         << " (p < " << options.significance << ", порог " << options.minSlowdown * 100 << "%)" << endl << endl;
+    // Заголовок выровнен пробелами: setw считает байты, а не символы UTF-8
+    cout << "Источник    Имя                         Строк     Было (с)    Стало (с)   Δ время   p         Δ память  Итог" << endl;
+    cout << string(110, '-') << endl;
+    
+    size_t regressions = 0;
+    for (const auto& finding : findings) {
+        string verdict;
+        if (finding.slowdown) verdict += "ЗАМЕДЛЕНИЕ ";
+        if (finding.memoryGrowth) verdict += "РОСТ ПАМЯТИ";
+        if (verdict.empty()) verdict = "ok";
+        if (finding.slowdown || finding.memoryGrowth) regressions++;
+        
+        stringstream change, memory, pValue;
+        change << showpos << fixed << setprecision(1) << finding.timeChange * 100 << "%";
+        memory << showpos << fixed << setprecision(1) << finding.memoryChange * 100 << "%";
+        if (std::isnan(finding.pValue)) pValue << "-";
+        else pValue << setprecision(3) << finding.pValue;
+        cout << left << setw(12) << finding.source << setw(28) << finding.name << setw(10) << finding.rows
+             << setw(12) << setprecision(6) << finding.baselineTime
+             << setw(12) << finding.currentTime << setw(10) << change.str()
+             << setw(10) << pValue.str() << setw(10) << memory.str() << verdict << endl;
+    }
+    cout << "\nСравнено: " << findings.size() << ", регрессий: " << regressions << endl;
+    return regressions > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    // Дополнительные режимы запуска
+    vector<ScalingPoint> scaling;
+    if (argc > 1 && string(argv[1]) == "--scaling") {
+        // --scaling [ROWS,...] [THREADS,...] — затем обычное сравнение
+        // с кривыми масштабирования в интерактивном отчете
+        scaling = runScaling(argc > 2 ? argv[2] : "", argc > 3 ? argv[3] : "");
+    }
+    if (argc > 1 && string(argv[1]) == "--depth-sweep") {
+        int maxDepth = argc > 2 ? atoi(argv[2]) : 10;
+        return runDepthSweep(max(1, maxDepth));
+    }
+    if (argc > 1 && string(argv[1]) == "--tune") {
+        // --tune — вся сетка, --tune random N — N случайных конфигураций
+        size_t randomCount = 0;
+        if (argc > 2 && string(argv[2]) == "random") {
+            randomCount = argc > 3 ? static_cast<size_t>(max(1, atoi(argv[3]))) : 20;
+        }
+        return runTuning(randomCount);
+    }
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        if (argc < 3) {
+            cerr << "Использование: " << argv[0] << " --batch манифест.ini" << endl;
+            return 1;
+        }
+        return runBatch(argv[2]);
+    }
+    if (argc > 1 && string(argv[1]) == "--compare") {
+        // --compare [БАЗОВАЯ] [ТЕКУЩАЯ]
+        return runCompare(argc > 2 ? argv[2] : "", argc > 3 ? argv[3] : "");
+    }
+    if (argc > 1 && string(argv[1]) == "--generate") {
+        // --generate ROWS [файл.csv | файл.bin]
+        size_t rows = argc > 2 ? static_cast<size_t>(atoll(argv[2])) : 1000000;
+        return runGenerate(rows, argc > 3 ? argv[3] : "output/generated.csv");
+    }
+    
+    // Профиль фаз обучения попадает в отчеты
+    Profiler::setEnabled(true);
+    
     cout << "================================================" << endl;
     cout << "Сравнение алгоритмов деревьев решений" << endl;
     cout << "Предметная область: Выбор банка для кредита под бизнес" << endl;
@@ -126,96 +693,214 @@ int main() {
     dataset.createBankLoanData();
     
     // Разделение на обучающую и тестовую выборки
-    auto [trainSet, testSet] = dataset.split(0.7);
+    auto [trainSet, testSet] = dataset.split(0.7, 42);
     
     cout << "Размер обучающей выборки: " << trainSet.getExamples().size() << endl;
-    cout << "Размер тестовой выборки: " << testSet.getExamples().size() << endl << endl;
+    cout << "Размер тестовой выборки: " << testSet.getExamples().size() << endl;
+    cout << "Память набора данных: " << MemoryUsage::formatBytes(MemoryUsage::ofDataset(dataset).total())
+         << ", пик RSS: " << MemoryUsage::formatBytes(MemoryUsage::peakResidentBytes()) << endl << endl;
     
     vector<AlgorithmResult> results;
     
-    // 1. ID3 Algorithm
-    cout << "1. Обучение дерева ID3..." << endl;
-    {
-        ID3Tree id3Tree;
-        auto result = evaluateAlgorithm(id3Tree, trainSet, testSet, "ID3");
-        results.push_back(result);
+    // Каталоги вывода: DOT и SVG пишутся сразу после обучения каждой модели
+    system("mkdir -p output/trees output/reports output/visualization");
+    
+    // Четыре классических алгоритма обучаются одновременно по одной
+    // закодированной выборке с общим потокобезопасным кэшем: статистика
+    // узла с тем же путем разбиений (как минимум корня) считается по строкам
+    // один раз для всех. Каждая задача сразу экспортирует и рисует свое
+    // дерево, пока остальные еще обучаются. С подсчетом выделений (фаза
+    // общая для процесса) задачи выполняются по очереди; только тогда
+    // замеры RSS процесса относятся к одной модели.
+    EncodedDataset encodedTrain(trainSet);
+    SplitStatsCache splitCache(encodedTrain, {});
+    
+    vector<pair<string, DecisionTreeFactory>> classicTrees = {
+        {"ID3", []() { return unique_ptr<DecisionTree>(new ID3Tree()); }},
+        {"C4.5", []() { return unique_ptr<DecisionTree>(new C45Tree()); }},
+        {"CART", []() { return unique_ptr<DecisionTree>(new CARTTree()); }},
+        {"CHAID", []() { return unique_ptr<DecisionTree>(new CHAIDTree()); }}
+    };
+    
+    cout << "1-4. Одновременное обучение деревьев ID3, C4.5, CART, CHAID..." << endl;
+    auto wallStart = high_resolution_clock::now();
+    launch policy = AllocationCounter::isAvailable() ? launch::deferred : launch::async;
+    vector<future<TrainedTree>> tasks;
+    for (const auto& [name, factory] : classicTrees) {
+        tasks.push_back(async(policy, [&, name = name, factory = factory]() {
+            TrainedTree trained;
+            trained.tree = factory();
+            trained.result = evaluateAlgorithm(*trained.tree, trainSet, testSet, name,
+                                               &encodedTrain, &splitCache, policy == launch::deferred);
+            renderTreeImage(trained.result);
+            return trained;
+        }));
+    }
+    
+    vector<TrainedTree> trainedTrees;
+    double taskSeconds = 0.0;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        trainedTrees.push_back(tasks[i].get());
+        const AlgorithmResult& result = trainedTrees.back().result;
+        taskSeconds += result.trainingTime;
+        cout << "\n" << i + 1 << ". " << result.algorithmName << endl;
         cout << "   Точность: " << fixed << setprecision(2) 
              << result.accuracy * 100 << "%" << endl;
         cout << "   Глубина дерева: " << result.treeDepth << endl;
-        id3Tree.printTree();
+        cout << "   Время обучения: " << Profiler::formatSeconds(result.trainingTime) << endl;
+        trainedTrees.back().tree->printTree();
+    }
+    double wallSeconds = duration<double>(high_resolution_clock::now() - wallStart).count();
+    cout << "\n   Обучение, оценка и экспорт четырех деревьев: " << Profiler::formatSeconds(wallSeconds)
+         << " (сумма времен обучения " << Profiler::formatSeconds(taskSeconds) << ")" << endl;
+    
+    // Задержка предсказания — после всех задач, без конкуренции за ядра
+    for (auto& trained : trainedTrees) {
+        trained.result.latency = LatencyBenchmark().measure(*trained.tree, testSet, encodedTrain);
+        results.push_back(trained.result);
     }
     
-    // 2. C4.5 Algorithm
-    cout << "\n2. Обучение дерева C4.5..." << endl;
+    size_t cacheLookups = splitCache.getHitCount() + splitCache.getMissCount();
+    cout << "\n   Общий кэш статистики узлов: " << splitCache.getEntryCount() << " таблиц, попаданий "
+         << fixed << setprecision(1)
+         << (cacheLookups > 0 ? 100.0 * splitCache.getHitCount() / cacheLookups : 0.0) << "%" << endl;
+    
+    // Ансамбли создаются одинаково для обучающей выборки и для фолдов
+    // кросс-валидации
+    auto makeForest = []() {
+        auto forest = make_unique<RandomForest>([]() { return unique_ptr<DecisionTree>(new CARTTree()); });
+        forest->setTreeCount(100);
+        return forest;
+    };
+    auto makeExtraTrees = []() {
+        auto forest = make_unique<RandomForest>([]() { return unique_ptr<DecisionTree>(new ExtraTree()); });
+        forest->setTreeCount(100);
+        forest->setBootstrap(false);
+        return forest;
+    };
+    auto makeBoosting = []() {
+        auto boosting = make_unique<GradientBoosting>();
+        boosting->setRounds(50);
+        boosting->setMaxLeaves(8);
+        boosting->setMinDataInLeaf(2);
+        return boosting;
+    };
+    
+    // 5. Random Forest (CART)
+    cout << "\n5. Обучение случайного леса (CART)..." << endl;
     {
-        C45Tree c45Tree;
-        auto result = evaluateAlgorithm(c45Tree, trainSet, testSet, "C4.5");
+        auto forest = makeForest();
+        auto result = evaluateForest(*forest, trainSet, testSet, "RandomForest");
         results.push_back(result);
         cout << "   Точность: " << fixed << setprecision(2) 
              << result.accuracy * 100 << "%" << endl;
-        cout << "   Глубина дерева: " << result.treeDepth << endl;
-        c45Tree.printTree();
+        cout << "   Деревьев: " << forest->getTreeCount() 
+             << ", наибольшая глубина: " << result.treeDepth << endl;
     }
     
-    // 3. CART Algorithm
-    cout << "\n3. Обучение дерева CART..." << endl;
+    // 6. Extra-Trees
+    cout << "\n6. Обучение ансамбля Extra-Trees..." << endl;
     {
-        CARTTree cartTree;
-        auto result = evaluateAlgorithm(cartTree, trainSet, testSet, "CART");
+        auto forest = makeExtraTrees();
+        auto result = evaluateForest(*forest, trainSet, testSet, "ExtraTrees");
         results.push_back(result);
         cout << "   Точность: " << fixed << setprecision(2) 
              << result.accuracy * 100 << "%" << endl;
-        cout << "   Глубина дерева: " << result.treeDepth << endl;
-        cartTree.printTree();
+        cout << "   Деревьев: " << forest->getTreeCount() 
+             << ", наибольшая глубина: " << result.treeDepth << endl;
     }
     
-    // 4. CHAID Algorithm
-    cout << "\n4. Обучение дерева CHAID..." << endl;
+    // 7. Gradient Boosting (CART)
+    cout << "\n7. Обучение градиентного бустинга (CART)..." << endl;
     {
-        CHAIDTree chaidTree;
-        auto result = evaluateAlgorithm(chaidTree, trainSet, testSet, "CHAID");
+        auto boosting = makeBoosting();
+        auto result = evaluateBoosting(*boosting, trainSet, testSet, "GradientBoosting");
         results.push_back(result);
         cout << "   Точность: " << fixed << setprecision(2) 
              << result.accuracy * 100 << "%" << endl;
-        cout << "   Глубина дерева: " << result.treeDepth << endl;
-        chaidTree.printTree();
+        cout << "   Деревьев: " << boosting->getTreeCount() 
+             << ", наибольшая глубина: " << result.treeDepth << endl;
     }
     
-    // Генерация отчетов
-    cout << "\n5. Генерация отчетов..." << endl;
+    // 8. Кросс-валидация всех моделей на одних и тех же фолдах: итоговая
+    // таблица, отчеты и выбор лучшего алгоритма сравнивают средние по фолдам
+    cout << "\n8. Стратифицированная 10-кратная кросс-валидация..." << endl;
+    vector<HistoryRecord> history;
+    {
+        EncodedDataset encodedDataset(dataset);
+        CrossValidation crossValidation(10, 42);
+        auto cvResults = crossValidation.evaluate(encodedDataset, {
+            {"ID3", []() { return unique_ptr<DecisionTree>(new ID3Tree()); }},
+            {"C4.5", []() { return unique_ptr<DecisionTree>(new C45Tree()); }},
+            {"CART", []() { return unique_ptr<DecisionTree>(new CARTTree()); }},
+            {"CHAID", []() { return unique_ptr<DecisionTree>(new CHAIDTree()); }}
+        });
+        auto ensembleResults = crossValidation.evaluateModels(encodedDataset, {
+            {"RandomForest", ensembleFoldModel(makeForest)},
+            {"ExtraTrees", ensembleFoldModel(makeExtraTrees)},
+            {"GradientBoosting", ensembleFoldModel(makeBoosting)}
+        });
+        cvResults.insert(cvResults.end(), ensembleResults.begin(), ensembleResults.end());
+        for (const auto& cv : cvResults) {
+            cout << "   " << left << padColumn(cv.algorithmName, 18) << right
+                 << "Точность: " << fixed << setprecision(2) << cv.accuracy * 100
+                 << "% ± " << cv.accuracyStd * 100 << "%" << endl;
+        }
+        mergeCrossValidation(results, cvResults);
+        
+        // Запись в историю результатов; для линий тренда — прошлые запуски
+        // сравнения на этом же наборе
+        stringstream fingerprint;
+        fingerprint << hex << setw(16) << setfill('0') << encodedDataset.fingerprint();
+        ResultHistory resultHistory(kHistoryFile);
+        if (resultHistory.append(makeHistoryRecords(results, fingerprint.str(), encodedDataset.getRowCount()))) {
+            cout << "   История результатов дополнена: " << kHistoryFile << endl;
+        }
+        for (auto& record : resultHistory.load()) {
+            if (record.source == "comparison" && record.dataset == fingerprint.str()) {
+                history.push_back(move(record));
+            }
+        }
+    }
     
-    // Создание директорий
-    system("mkdir -p output/trees output/reports output/visualization");
+    // Генерация отчетов
+    cout << "\n9. Генерация отчетов..." << endl;
     
-    // Полный отчет на русском
-    ReportGenerator::generateFullReport(results, dataset, "output/reports/full_report.html");
-    cout << "   Сгенерирован: output/reports/full_report.html" << endl;
+    // Изображения ансамблей — до отчетов, которые их встраивают
+    // (одиночные деревья нарисованы в своих задачах)
+    generateTreeImages(results);
     
-    // Интерактивный отчет
+    // Полный и интерактивный отчеты независимы и пишутся одновременно
+    auto fullReport = async(launch::async, [&]() {
+        ReportGenerator::generateFullReport(results, dataset, "output/reports/full_report.html");
+    });
     ReportGenerator::createInteractiveReport(results, dataset, 
-                                           "output/reports/interactive_report.html");
+                                           "output/reports/interactive_report.html", scaling, history);
+    fullReport.get();
+    cout << "   Сгенерирован: output/reports/full_report.html" << endl;
     cout << "   Сгенерирован: output/reports/interactive_report.html" << endl;
     
-    // Генерация изображений деревьев
-    generateTreeImages();
+    cout << "   Пик RSS после отчетов: " << MemoryUsage::formatBytes(MemoryUsage::peakResidentBytes()) << endl;
     
     // Итоговая таблица
     cout << "\n================================================" << endl;
     cout << "Итоговые результаты" << endl;
     cout << "================================================" << endl;
-    cout << left << setw(12) << "Алгоритм" 
-         << setw(12) << "Точность" 
-         << setw(12) << "F1-Score" 
-         << setw(12) << "Время(с)" 
-         << setw(10) << "Глубина" << endl;
-    cout << string(58, '-') << endl;
+    cout << padColumn("Алгоритм", 18)
+         << padColumn("Точность", 12)
+         << padColumn("F1-Score", 12)
+         << padColumn("Время", 12)
+         << padColumn("Глубина", 10)
+         << "Память" << endl;
+    cout << string(76, '-') << endl;
     
     for (const auto& result : results) {
-        cout << left << setw(12) << result.algorithmName
+        cout << left << padColumn(result.algorithmName, 18)
              << setw(12) << fixed << setprecision(4) << result.accuracy
              << setw(12) << fixed << setprecision(4) << result.f1Score
-             << setw(12) << fixed << setprecision(2) << result.trainingTime
-             << setw(10) << result.treeDepth << endl;
+             << padColumn(Profiler::formatSeconds(result.trainingTime), 12)
+             << setw(10) << result.treeDepth
+             << MemoryUsage::formatBytes(result.modelMemory.total()) << endl;
     }
     
     // Нахождение лучшего алгоритма
@@ -239,10 +924,9 @@ int main() {
     cout << "   или" << endl;
     cout << "   xdg-open output/reports/full_report.html" << endl;
     cout << "\n2. Для визуализации деревьев:" << endl;
-    cout << "   output/trees/*.png - изображения деревьев" << endl;
-    cout << "   output/trees/*.svg - SVG версии (лучшее качество)" << endl;
-    cout << "\n3. Для генерации SVG:" << endl;
-    cout << "   dot -Tsvg output/trees/ID3_tree.dot -o output/trees/ID3_tree.svg" << endl;
+    cout << "   output/trees/*.svg - изображения деревьев" << endl;
+    cout << "\n3. Полные деревья через Graphviz (если установлен):" << endl;
+    cout << "   dot -Tsvg output/trees/ID3_tree.dot -o output/trees/ID3_tree_full.svg" << endl;
     
     // Создание простого превью
     ofstream preview("output/visualization/preview.html");
@@ -255,11 +939,13 @@ int main() {
     preview << "<p><a href='../reports/full_report.html'>Полный отчет</a></p>\n";
     preview << "<div style='display:flex;flex-wrap:wrap;justify-content:center;gap:20px;'>\n";
     
-    vector<string> algs = {"ID3", "C4.5", "CART", "CHAID"};
-    for (const auto& alg : algs) {
+    for (const auto& result : results) {
+        if (result.svgFilePath.empty()) continue;
+        string alg = result.algorithmName;
         preview << "<div style='border:1px solid #ddd;padding:10px;border-radius:5px;'>\n";
         preview << "<h3>" << alg << " Дерево</h3>\n";
-        preview << "<img src='../trees/" << alg << "_tree.png' style='max-width:300px;'>\n";
+        preview << "<a href='../trees/" << alg << "_tree.svg'><img src='../trees/" << alg
+                << "_tree.svg' style='max-width:300px;'></a>\n";
         preview << "</div>\n";
     }
     